@@ -13,11 +13,29 @@ namespace argos {
     class CCI_AckermannSteeringActuator : public CCI_Actuator {
     public:
 
+        CCI_AckermannSteeringActuator() : m_fSteeringAngle(0.0),
+                                          m_fThrottleSpeed(0.0) {}
+
         virtual ~CCI_AckermannSteeringActuator() {}
 
         virtual void SetSteeringAndThrottle(Real f_steering_ang,
                                             Real f_throttle_speed) = 0;
 
+        /**
+         * Returns the steering angle of the last command
+         */
+        inline Real GetSteeringAngle() const {
+            return m_fSteeringAngle;
+        }
+
+        /**
+         * Returns the throttle speed of the last command, as stored by the
+         * implementation (in m/s in simulation)
+         */
+        inline Real GetThrottleSpeed() const {
+            return m_fThrottleSpeed;
+        }
+
 #ifdef ARGOS_WITH_LUA
         virtual void CreateLuaState(lua_State* pt_lua_state){};
 
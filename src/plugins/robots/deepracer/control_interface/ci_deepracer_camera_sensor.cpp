@@ -8,7 +8,9 @@ namespace argos {
     /****************************************/
     /****************************************/
 
-    CCI_DeepracerCameraSensor::CCI_DeepracerCameraSensor() {}
+    CCI_DeepracerCameraSensor::CCI_DeepracerCameraSensor() :
+        m_unWidth(0),
+        m_unHeight(0) {}
 
     /****************************************/
     /****************************************/
@@ -34,9 +36,32 @@ namespace argos {
     /****************************************/
     /****************************************/
 
+#ifdef ARGOS_WITH_LUA
+    static void BlobsToLuaTable(lua_State* pt_lua_state,
+                                const CCI_DeepracerCameraSensor::TBlobs& t_blobs) {
+        lua_pushstring(pt_lua_state, "blobs");
+        lua_newtable(pt_lua_state);
+        for (size_t i = 0; i < t_blobs.size(); ++i) {
+            CLuaUtility::StartTable(pt_lua_state, i + 1);
+            CLuaUtility::AddToTable(pt_lua_state, "color", t_blobs[i].Color);
+            CLuaUtility::AddToTable(pt_lua_state, "min", t_blobs[i].Min);
+            CLuaUtility::AddToTable(pt_lua_state, "max", t_blobs[i].Max);
+            CLuaUtility::EndTable(pt_lua_state);
+        }
+        lua_settable(pt_lua_state, -3);
+    }
+#endif
+
+    /****************************************/
+    /****************************************/
+
 #ifdef ARGOS_WITH_LUA
     void CCI_DeepracerCameraSensor::CreateLuaState(lua_State* pt_lua_state) {
-        // TODO
+        CLuaUtility::StartTable(pt_lua_state, "camera");
+        CLuaUtility::AddToTable(pt_lua_state, "width", static_cast<Real>(m_unWidth));
+        CLuaUtility::AddToTable(pt_lua_state, "height", static_cast<Real>(m_unHeight));
+        BlobsToLuaTable(pt_lua_state, m_tBlobs);
+        CLuaUtility::EndTable(pt_lua_state);
     }
 #endif
 
@@ -45,11 +70,13 @@ namespace argos {
 
 #ifdef ARGOS_WITH_LUA
     void CCI_DeepracerCameraSensor::ReadingsToLuaState(lua_State* pt_lua_state) {
-        // TODO
+        lua_getfield(pt_lua_state, -1, "camera");
+        /* Replace the blob list with the one of the last step */
+        BlobsToLuaTable(pt_lua_state, m_tBlobs);
+        lua_pop(pt_lua_state, 1);
     }
 #endif
 
-
     /****************************************/
     /****************************************/
 
@@ -0,0 +1,55 @@
+#include "ci_deepracer_collision_sensor.h"
+
+#ifdef ARGOS_WITH_LUA
+#include <argos3/core/wrappers/lua/lua_utility.h>
+#endif
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+#ifdef ARGOS_WITH_LUA
+    void CCI_DeepracerCollisionSensor::CreateLuaState(lua_State* pt_lua_state) {
+        CLuaUtility::StartTable(pt_lua_state, "collision");
+        lua_pushstring(pt_lua_state, "colliding");
+        lua_pushboolean(pt_lua_state, m_bColliding);
+        lua_settable(pt_lua_state, -3);
+        CLuaUtility::StartTable(pt_lua_state, "contacts");
+        CLuaUtility::EndTable(pt_lua_state);
+        CLuaUtility::EndTable(pt_lua_state);
+    }
+#endif
+
+    /****************************************/
+    /****************************************/
+
+#ifdef ARGOS_WITH_LUA
+    void CCI_DeepracerCollisionSensor::ReadingsToLuaState(lua_State* pt_lua_state) {
+        lua_getfield(pt_lua_state, -1, "collision");
+        lua_pushstring(pt_lua_state, "colliding");
+        lua_pushboolean(pt_lua_state, m_bColliding);
+        lua_settable(pt_lua_state, -3);
+        /* Replace the contact list with the events of the last step */
+        lua_pushstring(pt_lua_state, "contacts");
+        lua_newtable(pt_lua_state);
+        for (size_t i = 0; i < m_tContacts.size(); ++i) {
+            CLuaUtility::StartTable(pt_lua_state, i + 1);
+            lua_pushstring(pt_lua_state, "begin");
+            lua_pushboolean(pt_lua_state, m_tContacts[i].Event == CONTACT_BEGIN);
+            lua_settable(pt_lua_state, -3);
+            lua_pushstring(pt_lua_state, "other");
+            lua_pushstring(pt_lua_state, m_tContacts[i].Other.c_str());
+            lua_settable(pt_lua_state, -3);
+            CLuaUtility::AddToTable(pt_lua_state, "impulse", m_tContacts[i].Impulse);
+            CLuaUtility::EndTable(pt_lua_state);
+        }
+        lua_settable(pt_lua_state, -3);
+        lua_pop(pt_lua_state, 1);
+    }
+#endif
+
+    /****************************************/
+    /****************************************/
+
+}
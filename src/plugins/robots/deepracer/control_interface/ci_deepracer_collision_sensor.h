@@ -0,0 +1,78 @@
+#ifndef CCI_DEEPRACER_COLLISION_SENSOR_H
+#define CCI_DEEPRACER_COLLISION_SENSOR_H
+
+namespace argos {
+    class CCI_DeepracerCollisionSensor;
+}
+
+#include <argos3/core/control_interface/ci_sensor.h>
+
+#include <string>
+#include <vector>
+
+namespace argos {
+    class CCI_DeepracerCollisionSensor : public CCI_Sensor {
+    public:
+
+        enum EContactEvent {
+            CONTACT_BEGIN = 0,
+            CONTACT_END
+        };
+
+        struct SContact {
+            /** Whether the contact started or ended in the last step */
+            EContactEvent Event;
+            /** Id of the entity touched (empty if unknown) */
+            std::string   Other;
+            /** Impulse exchanged when the contact started [N*s] (0 for CONTACT_END) */
+            Real          Impulse;
+
+            SContact(EContactEvent e_event,
+                     const std::string& str_other,
+                     Real f_impulse) : Event(e_event),
+                                       Other(str_other),
+                                       Impulse(f_impulse) {}
+        };
+
+        typedef std::vector<SContact> TContacts;
+
+    public:
+
+        /**
+         * Class constructor
+         */
+        CCI_DeepracerCollisionSensor() : m_bColliding(false) {}
+
+        /**
+         * Class destructor
+         */
+        virtual ~CCI_DeepracerCollisionSensor() {}
+
+        /**
+         * Returns the contacts that started or ended in the last step
+         */
+        inline const TContacts& GetContacts() const {
+            return m_tContacts;
+        }
+
+        /**
+         * Returns true if the robot is touching something at the end of the last step
+         */
+        inline bool IsColliding() const {
+            return m_bColliding;
+        }
+
+#ifdef ARGOS_WITH_LUA
+        virtual void CreateLuaState(lua_State* pt_lua_state);
+
+        virtual void ReadingsToLuaState(lua_State* pt_lua_state);
+#endif
+
+    protected:
+
+        TContacts m_tContacts;
+        bool      m_bColliding;
+    };
+}
+
+#endif // CCI_DEEPRACER_COLLISION_SENSOR_H
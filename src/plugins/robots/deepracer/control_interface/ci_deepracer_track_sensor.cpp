@@ -0,0 +1,60 @@
+#include "ci_deepracer_track_sensor.h"
+
+#ifdef ARGOS_WITH_LUA
+#include <argos3/core/wrappers/lua/lua_utility.h>
+#endif
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+#ifdef ARGOS_WITH_LUA
+    void CCI_DeepracerTrackSensor::CreateLuaState(lua_State* pt_lua_state) {
+        CLuaUtility::StartTable(pt_lua_state, "track");
+        CLuaUtility::AddToTable(pt_lua_state, "lateral_offset", m_sReading.LateralOffset);
+        CLuaUtility::AddToTable(pt_lua_state, "heading_error", m_sReading.HeadingError);
+        CLuaUtility::AddToTable(pt_lua_state, "arc_length", m_sReading.ArcLength);
+        CLuaUtility::AddToTable(pt_lua_state, "track_width", m_sReading.TrackWidth);
+        CLuaUtility::StartTable(pt_lua_state, "curvatures");
+        for (size_t i = 0; i < m_sReading.Curvatures.size(); ++i) {
+            CLuaUtility::AddToTable(pt_lua_state, i + 1, m_sReading.Curvatures[i]);
+        }
+        CLuaUtility::EndTable(pt_lua_state);
+        CLuaUtility::EndTable(pt_lua_state);
+    }
+#endif
+
+    /****************************************/
+    /****************************************/
+
+#ifdef ARGOS_WITH_LUA
+    void CCI_DeepracerTrackSensor::ReadingsToLuaState(lua_State* pt_lua_state) {
+        lua_getfield(pt_lua_state, -1, "track");
+        lua_pushstring(pt_lua_state, "lateral_offset");
+        lua_pushnumber(pt_lua_state, m_sReading.LateralOffset);
+        lua_settable(pt_lua_state, -3);
+        lua_pushstring(pt_lua_state, "heading_error");
+        lua_pushnumber(pt_lua_state, m_sReading.HeadingError.GetValue());
+        lua_settable(pt_lua_state, -3);
+        lua_pushstring(pt_lua_state, "arc_length");
+        lua_pushnumber(pt_lua_state, m_sReading.ArcLength);
+        lua_settable(pt_lua_state, -3);
+        lua_pushstring(pt_lua_state, "track_width");
+        lua_pushnumber(pt_lua_state, m_sReading.TrackWidth);
+        lua_settable(pt_lua_state, -3);
+        lua_getfield(pt_lua_state, -1, "curvatures");
+        for (size_t i = 0; i < m_sReading.Curvatures.size(); ++i) {
+            lua_pushnumber(pt_lua_state, i + 1);
+            lua_pushnumber(pt_lua_state, m_sReading.Curvatures[i]);
+            lua_settable(pt_lua_state, -3);
+        }
+        lua_pop(pt_lua_state, 1);
+        lua_pop(pt_lua_state, 1);
+    }
+#endif
+
+    /****************************************/
+    /****************************************/
+
+}
@@ -0,0 +1,74 @@
+#ifndef CCI_DEEPRACER_TRACK_SENSOR_H
+#define CCI_DEEPRACER_TRACK_SENSOR_H
+
+namespace argos {
+    class CCI_DeepracerTrackSensor;
+}
+
+#include <argos3/core/control_interface/ci_sensor.h>
+#include <argos3/core/utility/math/angles.h>
+
+#include <vector>
+
+namespace argos {
+    class CCI_DeepracerTrackSensor : public CCI_Sensor {
+    public:
+
+        struct SReading {
+            /** Signed distance from the center line [m], positive on its left */
+            Real              LateralOffset;
+            /** Heading of the robot minus the direction of the center line, in [-pi,pi] */
+            CRadians          HeadingError;
+            /** Distance along the center line from the first waypoint [m] */
+            Real              ArcLength;
+            /** Width of the track at the robot [m] */
+            Real              TrackWidth;
+            /** Curvature of the center line [1/m] ahead of the robot, positive for left turns */
+            std::vector<Real> Curvatures;
+
+            SReading() : LateralOffset(0.0),
+                         ArcLength(0.0),
+                         TrackWidth(0.0) {}
+        };
+
+    public:
+
+        /**
+         * Class constructor
+         */
+        CCI_DeepracerTrackSensor() : m_fLookaheadSpacing(0.0) {}
+
+        /**
+         * Class destructor
+         */
+        virtual ~CCI_DeepracerTrackSensor() {}
+
+        /**
+         * Returns the position of the robot relative to the track
+         */
+        inline const SReading& GetReading() const {
+            return m_sReading;
+        }
+
+        /**
+         * Returns the distance between lookahead curvature samples [m];
+         * sample i is taken (i+1) times this distance ahead of the robot
+         */
+        inline Real GetLookaheadSpacing() const {
+            return m_fLookaheadSpacing;
+        }
+
+#ifdef ARGOS_WITH_LUA
+        virtual void CreateLuaState(lua_State* pt_lua_state);
+
+        virtual void ReadingsToLuaState(lua_State* pt_lua_state);
+#endif
+
+    protected:
+
+        SReading m_sReading;
+        Real     m_fLookaheadSpacing;
+    };
+}
+
+#endif // CCI_DEEPRACER_TRACK_SENSOR_H
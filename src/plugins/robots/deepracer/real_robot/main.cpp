@@ -38,10 +38,9 @@ int main(int argc, char* argv[]) {
          */
         std::shared_ptr<CRealDeepracer> pcRobot = std::make_shared<CRealDeepracer>();
 
+        /* The ROS callbacks run on the executor started by the robot */
         pcRobot->Init(strARGoSFName, strControllerId);
 
-        rclcpp::spin_some(pcRobot->GetNodeHandlePtr());
-
         /*
          * Perform the main loop
          */
@@ -5,10 +5,159 @@
 // #include "real_deepracer_camera_sensor.h"
 #include "real_deepracer_lidar_sensor.h"
 
+#include <argos3/core/utility/configuration/argos_configuration.h>
+#include <argos3/core/utility/string_utilities.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <pthread.h>
+#include <sched.h>
+#include <sstream>
+#include <sys/mman.h>
+
+/****************************************/
+/****************************************/
+
+/* Threads of the executor: one per sensor, so a scan being copied doesn't delay the IMU */
+static const size_t EXECUTOR_THREADS = 2;
+
+/****************************************/
+/****************************************/
+
+/**
+ * Reads a list of cores such as "3", "1,2" or "0-2".
+ */
+static void ParseCPUs(const std::string& str_cpus,
+                      std::vector<UInt32>& vec_cpus) {
+    std::vector<std::string> vecTokens;
+    Tokenize(str_cpus, vecTokens, ", ");
+    for (size_t i = 0; i < vecTokens.size(); ++i) {
+        size_t unDash = vecTokens[i].find('-');
+        UInt32 unFirst = FromString<UInt32>(vecTokens[i].substr(0, unDash));
+        UInt32 unLast = (unDash == std::string::npos) ?
+            unFirst : FromString<UInt32>(vecTokens[i].substr(unDash + 1));
+        if (unLast < unFirst || unLast >= static_cast<UInt32>(CPU_SETSIZE)) {
+            THROW_ARGOSEXCEPTION("Invalid cores \"" << vecTokens[i] << "\"");
+        }
+        for (UInt32 unCPU = unFirst; unCPU <= unLast; ++unCPU) {
+            vec_cpus.push_back(unCPU);
+        }
+    }
+}
+
+/****************************************/
+/****************************************/
+
+/**
+ * Reads a priority and a list of cores from the given attributes.
+ */
+static void ParseThreadSettings(TConfigurationNode& t_node,
+                                const std::string& str_priority,
+                                const std::string& str_cpus,
+                                CRealDeepracer::SThreadSettings& s_settings) {
+    GetNodeAttributeOrDefault(t_node, str_priority, s_settings.Priority, s_settings.Priority);
+    if (s_settings.Priority != 0 &&
+        (s_settings.Priority < ::sched_get_priority_min(SCHED_FIFO) ||
+         s_settings.Priority > ::sched_get_priority_max(SCHED_FIFO))) {
+        THROW_ARGOSEXCEPTION(str_priority << " must be 0 or a SCHED_FIFO priority between "
+                             << ::sched_get_priority_min(SCHED_FIFO) << " and "
+                             << ::sched_get_priority_max(SCHED_FIFO));
+    }
+    std::string strCPUs;
+    GetNodeAttributeOrDefault(t_node, str_cpus, strCPUs, strCPUs);
+    ParseCPUs(strCPUs, s_settings.CPUs);
+}
+
+/****************************************/
+/****************************************/
+
+CRealDeepracer::CRealDeepracer() :
+    rclcpp::Node("deepracer_node"),
+    m_fTriggerMinPeriod(0.0),
+    m_fTriggerTimeout(0.0),
+    m_bTriggerAttached(false),
+    m_unTriggeredSteps(0),
+    m_unTimedOutSteps(0),
+    m_bLockMemory(false) {
+}
+
+/****************************************/
+/****************************************/
+
+CRealDeepracer::~CRealDeepracer() {
+    StopExecutor();
+}
+
 /****************************************/
 /****************************************/
 
-CRealDeepracer::CRealDeepracer() : rclcpp::Node("deepracer_node") {
+void CRealDeepracer::InitRobot() {
+    /* Optional trigger of the control loop, read before the sensors are made */
+    try {
+        TConfigurationNode& tFramework = GetNode(m_tConfRoot, "framework");
+        if (NodeExists(tFramework, "deepracer_trigger")) {
+            TConfigurationNode& tTrigger = GetNode(tFramework, "deepracer_trigger");
+            GetNodeAttribute(tTrigger, "sensor", m_strTriggerSensor);
+            GetNodeAttributeOrDefault(tTrigger, "min_period", m_fTriggerMinPeriod, m_fTriggerMinPeriod);
+            m_fTriggerTimeout = 1.0 / m_fRate;
+            GetNodeAttributeOrDefault(tTrigger, "timeout", m_fTriggerTimeout, m_fTriggerTimeout);
+            if (m_fTriggerMinPeriod < 0.0) {
+                THROW_ARGOSEXCEPTION("min_period must be non-negative");
+            }
+            if (m_fTriggerTimeout <= m_fTriggerMinPeriod) {
+                THROW_ARGOSEXCEPTION("timeout must be greater than min_period");
+            }
+        }
+    }
+    catch(CARGoSException& ex) {
+        THROW_ARGOSEXCEPTION_NESTED("Error parsing the trigger of the control loop", ex);
+    }
+    /* Optional real-time settings of the threads */
+    try {
+        TConfigurationNode& tFramework = GetNode(m_tConfRoot, "framework");
+        if (NodeExists(tFramework, "deepracer_realtime")) {
+            TConfigurationNode& tRealtime = GetNode(tFramework, "deepracer_realtime");
+            ParseThreadSettings(tRealtime, "priority", "cpus", m_sControlSettings);
+            ParseThreadSettings(tRealtime, "executor_priority", "executor_cpus", m_sExecutorSettings);
+            GetNodeAttributeOrDefault(tRealtime, "lock_memory", m_bLockMemory, m_bLockMemory);
+            Real fBinWidth = 0.001;
+            GetNodeAttributeOrDefault(tRealtime, "histogram_bin", fBinWidth, fBinWidth);
+            if (fBinWidth <= 0.0) {
+                THROW_ARGOSEXCEPTION("histogram_bin must be positive");
+            }
+            m_cLoopStats.SetBinWidth(fBinWidth);
+        }
+    }
+    catch(CARGoSException& ex) {
+        THROW_ARGOSEXCEPTION_NESTED("Error parsing the real-time settings", ex);
+    }
+    /* Lock before the threads start, so their stacks are locked too. The
+       robot still runs without the privileges, only with fewer guarantees */
+    if (m_bLockMemory) {
+        if (::mlockall(MCL_CURRENT | MCL_FUTURE) == 0) {
+            LOG << "[INFO] Memory of the process locked" << std::endl;
+        } else {
+            LOGERR << "[WARNING] Can't lock the memory of the process: " << ::strerror(errno) << std::endl;
+        }
+    }
+    /* The devices created afterwards add their callback groups to the node,
+       the executor picks them up as they appear */
+    m_ptExecutor = std::make_shared<rclcpp::executors::MultiThreadedExecutor>(
+        rclcpp::ExecutorOptions(), EXECUTOR_THREADS);
+    m_ptExecutor->add_node(GetNodeHandlePtr());
+    std::promise<std::string> cSettingsDone;
+    std::future<std::string> cSettingsError = cSettingsDone.get_future();
+    m_cExecutorThread = std::thread([this, cSettingsDone = std::move(cSettingsDone)]() mutable {
+        /* The worker threads started by spin() inherit the scheduling and the cores */
+        cSettingsDone.set_value(ApplyThreadSettings(m_sExecutorSettings));
+        m_ptExecutor->spin();
+    });
+    std::string strError = cSettingsError.get();
+    if (!strError.empty()) {
+        LOGERR << "[WARNING] Executor threads: " << strError << std::endl;
+    }
 }
 
 /****************************************/
@@ -16,6 +165,103 @@ CRealDeepracer::CRealDeepracer() : rclcpp::Node("deepracer_node") {
 
 void CRealDeepracer::Destroy() {
     //Reset/clear maps if using gmapping in the future
+    StopExecutor();
+    if (!m_strTriggerSensor.empty()) {
+        LOG << "[INFO] Control steps: "
+            << m_unTriggeredSteps << " triggered by \"" << m_strTriggerSensor << "\", "
+            << m_unTimedOutSteps << " on timeout" << std::endl;
+    }
+    LOG << "[INFO] Control loop statistics:" << std::endl
+        << m_cLoopStats.GetReport();
+}
+
+/****************************************/
+/****************************************/
+
+void CRealDeepracer::StopExecutor() {
+    if (m_cExecutorThread.joinable()) {
+        m_ptExecutor->cancel();
+        m_cExecutorThread.join();
+        m_ptExecutor->remove_node(GetNodeHandlePtr());
+    }
+}
+
+/****************************************/
+/****************************************/
+
+std::string CRealDeepracer::ApplyThreadSettings(const SThreadSettings& s_settings) {
+    std::ostringstream cErrors;
+    if (!s_settings.CPUs.empty()) {
+        cpu_set_t tCPUs;
+        CPU_ZERO(&tCPUs);
+        for (size_t i = 0; i < s_settings.CPUs.size(); ++i) {
+            CPU_SET(s_settings.CPUs[i], &tCPUs);
+        }
+        int nError = ::pthread_setaffinity_np(::pthread_self(), sizeof(tCPUs), &tCPUs);
+        if (nError != 0) {
+            cErrors << "can't set the cores: " << ::strerror(nError);
+        }
+    }
+    if (s_settings.Priority > 0) {
+        sched_param tParam;
+        tParam.sched_priority = s_settings.Priority;
+        int nError = ::pthread_setschedparam(::pthread_self(), SCHED_FIFO, &tParam);
+        if (nError != 0) {
+            if (!cErrors.str().empty()) cErrors << "; ";
+            cErrors << "can't set SCHED_FIFO priority " << s_settings.Priority << ": " << ::strerror(nError);
+        }
+    }
+    return cErrors.str();
+}
+
+/****************************************/
+/****************************************/
+
+void CRealDeepracer::Execute() {
+    /* Execute() runs on the control thread */
+    std::string strError = ApplyThreadSettings(m_sControlSettings);
+    if (!strError.empty()) {
+        LOGERR << "[WARNING] Control thread: " << strError << std::endl;
+    }
+    if (m_strTriggerSensor.empty()) {
+        CRealRobot::Execute();
+    } else {
+        ExecuteTriggered();
+    }
+}
+
+/****************************************/
+/****************************************/
+
+void CRealDeepracer::ExecuteTriggered() {
+    typedef CRealDeepracerTrigger::TClock TClock;
+    if (!m_bTriggerAttached) {
+        THROW_ARGOSEXCEPTION("The trigger sensor \"" << m_strTriggerSensor << "\" is not used by the controller");
+    }
+    const TClock::duration tMinPeriod =
+        std::chrono::duration_cast<TClock::duration>(std::chrono::duration<Real>(m_fTriggerMinPeriod));
+    const TClock::duration tTimeout =
+        std::chrono::duration_cast<TClock::duration>(std::chrono::duration<Real>(m_fTriggerTimeout));
+    LOG << "[INFO] Control loop running, triggered by \"" << m_strTriggerSensor << "\"" << std::endl;
+    UInt64 unSeen = m_cTrigger.GetCount();
+    TClock::time_point tLastStep = TClock::now();
+    /* The bounded wait lets the loop notice the shutdown */
+    while (rclcpp::ok()) {
+        if (m_cTrigger.WaitUntil(unSeen, tLastStep + tTimeout)) {
+            /* A sample that comes too early waits; the step takes the latest one anyway */
+            std::this_thread::sleep_until(tLastStep + tMinPeriod);
+            ++m_unTriggeredSteps;
+        } else {
+            /* The sensor stalled, keep controlling at the fallback rate */
+            ++m_unTimedOutSteps;
+        }
+        TClock::time_point tNow = TClock::now();
+        Real fElapsed = std::chrono::duration<Real>(tNow - tLastStep).count();
+        tLastStep = tNow;
+        Sense(fElapsed);
+        m_pcController->ControlStep();
+        Act(fElapsed);
+    }
 }
 
 /****************************************/
@@ -28,6 +274,10 @@ void CRealDeepracer::Destroy() {
                 GetNodeHandlePtr()                                                       \
             );                                                                           \
         m_vecSensors.push_back(pcSens);                                                  \
+        if (m_strTriggerSensor == TAG) {                                                 \
+            pcSens->SetTrigger(&m_cTrigger);                                             \
+            m_bTriggerAttached = true;                                                   \
+        }                                                                                \
         LOG << "[INFO] Initialized \"" << TAG << "\" sensor " << std::endl;              \
         return pcSens;                                                                   \
     }
@@ -66,8 +316,12 @@ CCI_Actuator* CRealDeepracer::MakeActuator(const std::string& str_name) {
 /****************************************/
 
 void CRealDeepracer::Sense(Real f_elapsed_time) {
-    /* Tell ROS to collect messages */
-    rclcpp::spin_some(GetNodeHandlePtr());
+    /* Both control loops call Sense() first in each step */
+    m_cLoopStats.Mark();
+    /* The callbacks run on the executor threads, take the latest readings */
+    for(size_t i = 0; i < m_vecSensors.size(); ++i) {
+        m_vecSensors[i]->Do(f_elapsed_time);
+    }
 }
 
 /****************************************/
@@ -75,11 +329,8 @@ void CRealDeepracer::Sense(Real f_elapsed_time) {
 
 void CRealDeepracer::Act(Real f_elapsed_time) {
 
-    // Go through actuators and let them do their thing
+    // Go through actuators and let them do their thing; publishing sends the messages right away
     for(size_t i = 0; i < m_vecActuators.size(); ++i) {
         m_vecActuators[i]->Do(f_elapsed_time);
     }
-
-    // Tell ROS to publish the messages
-    rclcpp::spin_some(GetNodeHandlePtr());
 }
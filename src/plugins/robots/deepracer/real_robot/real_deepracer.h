@@ -5,8 +5,12 @@
 #include <argos3/core/utility/logging/argos_log.h>
 #include <argos3/core/real_robot/real_robot.h>
 #include <argos3/plugins/robots/deepracer/real_robot/real_deepracer_device.h>
+#include <argos3/plugins/robots/deepracer/real_robot/real_deepracer_loop_stats.h>
+#include <argos3/plugins/robots/deepracer/real_robot/real_deepracer_trigger.h>
 #include <rclcpp/rclcpp.hpp>
 #include <memory>
+#include <string>
+#include <thread>
 #include <vector>
 
 using namespace argos;
@@ -18,9 +22,58 @@ class CRealDeepracer :
         public rclcpp::Node {
 public:
 
+    /**
+     * Scheduling of a thread: SCHED_FIFO priority (0 for the normal
+     * scheduler) and cores (empty for all).
+     */
+    struct SThreadSettings {
+        SInt32 Priority;
+        std::vector<UInt32> CPUs;
+
+        SThreadSettings() :
+            Priority(0) {}
+    };
+
     CRealDeepracer();
-    virtual ~CRealDeepracer() {}
-    virtual void InitRobot() {}
+    virtual ~CRealDeepracer();
+
+    /**
+     * Starts the executor that runs the ROS callbacks of the devices, and
+     * reads the optional trigger of the control loop:
+     *
+     *   <framework>
+     *     <experiment ticks_per_second="15" />
+     *     <deepracer_trigger sensor="deepracer_lidar"
+     *                        min_period="0.02"
+     *                        timeout="0.1" />
+     *   </framework>
+     *
+     * With a trigger, the control step runs as soon as the sensor delivers a
+     * new sample, but no sooner than min_period [s] after the previous step,
+     * and anyway timeout [s] after it (by default, one tick).
+     *
+     * The scheduling of the threads can be set too, next to the trigger:
+     *
+     *   <deepracer_realtime priority="80"
+     *                       cpus="3"
+     *                       executor_priority="70"
+     *                       executor_cpus="1,2"
+     *                       lock_memory="true"
+     *                       histogram_bin="0.001" />
+     *
+     * priority puts the control thread on SCHED_FIFO (1-99; 0, the default,
+     * keeps the normal scheduler), cpus pins it to a list of cores ("3",
+     * "1,2", "0-2"); executor_priority and executor_cpus do the same for the
+     * threads of the executor. lock_memory locks all the pages of the process
+     * in RAM. histogram_bin [s] is the bin width of the period and jitter
+     * histograms logged on exit.
+     */
+    virtual void InitRobot();
+
+    /**
+     * Runs the control loop, at the rate of the experiment or on the trigger.
+     */
+    virtual void Execute();
     virtual void Destroy();
     virtual CCI_Actuator* MakeActuator(const std::string& str_name);
     virtual CCI_Sensor* MakeSensor(const std::string& str_name);
@@ -30,9 +83,47 @@ public:
         return this->std::enable_shared_from_this<rclcpp::Node>::shared_from_this();
     }
 
+private:
+    /**
+     * Stops the executor and waits for its threads.
+     */
+    void StopExecutor();
+
+    /**
+     * Runs the control loop woken by the trigger sensor.
+     */
+    void ExecuteTriggered();
+
+    /**
+     * Applies the settings to the calling thread.
+     * @return an error message, or an empty string on success.
+     */
+    static std::string ApplyThreadSettings(const SThreadSettings& s_settings);
+
 private:
     std::vector<CRealDeepracerDevice *> m_vecActuators;
     std::vector<CRealDeepracerDevice *> m_vecSensors;
+
+    /** Runs the subscriptions off the control thread */
+    std::shared_ptr<rclcpp::executors::MultiThreadedExecutor> m_ptExecutor;
+    std::thread                                               m_cExecutorThread;
+
+    /** Event-triggered control loop; disabled when the sensor is empty */
+    std::string           m_strTriggerSensor;
+    Real                  m_fTriggerMinPeriod;
+    Real                  m_fTriggerTimeout;
+    bool                  m_bTriggerAttached;
+    CRealDeepracerTrigger m_cTrigger;
+    UInt64                m_unTriggeredSteps;
+    UInt64                m_unTimedOutSteps;
+
+    /** Real-time settings of the threads */
+    SThreadSettings m_sControlSettings;
+    SThreadSettings m_sExecutorSettings;
+    bool            m_bLockMemory;
+
+    /** Period and jitter of the control steps, marked in Sense() */
+    CRealDeepracerLoopStats m_cLoopStats;
 };
 
 #endif
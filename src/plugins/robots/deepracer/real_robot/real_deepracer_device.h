@@ -2,7 +2,9 @@
 #define REAL_DEEPRACER_DEVICE_H
 #include <argos3/core/utility/datatypes/datatypes.h>
 #include <argos3/plugins/robots/deepracer/real_robot/real_deepracer.h>
+#include <argos3/plugins/robots/deepracer/real_robot/real_deepracer_trigger.h>
 
+#include <atomic>
 #include <memory>
 #include <rclcpp/rclcpp.hpp>
 #include <rclcpp/subscription_base.hpp>
@@ -17,13 +19,47 @@ class CRealDeepracer; // forward declare CRealDeepracer
 class CRealDeepracerDevice {
 public:
 
-    CRealDeepracerDevice(const std::shared_ptr<rclcpp::Node>& pt_node_handle) : m_ptNodeHandle(pt_node_handle) {}
+    CRealDeepracerDevice(const std::shared_ptr<rclcpp::Node>& pt_node_handle) :
+        m_ptNodeHandle(pt_node_handle),
+        m_ptCallbackGroup(pt_node_handle->create_callback_group(rclcpp::CallbackGroupType::MutuallyExclusive)),
+        m_pcTrigger(nullptr) {}
     virtual ~CRealDeepracerDevice() {}
+
+    /**
+     * Sensors take their latest reading, actuators send their command.
+     */
     virtual void Do(Real f_elapsed_time) {}
 
+    /**
+     * Makes the device wake the control loop on each new sample.
+     */
+    inline void SetTrigger(CRealDeepracerTrigger* pc_trigger) {
+        m_pcTrigger.store(pc_trigger, std::memory_order_release);
+    }
+
 protected:
 
+    /**
+     * Called by the callbacks once a new sample is published.
+     */
+    inline void NotifyTrigger() {
+        CRealDeepracerTrigger* pcTrigger = m_pcTrigger.load(std::memory_order_acquire);
+        if (pcTrigger != nullptr) pcTrigger->Notify();
+    }
+
     std::shared_ptr<rclcpp::Node> m_ptNodeHandle;
+
+    /**
+     * The callbacks of each device run in their own group, so the executor
+     * threads serve the devices concurrently but never run two callbacks of
+     * the same device at once.
+     */
+    rclcpp::CallbackGroup::SharedPtr m_ptCallbackGroup;
+
+private:
+
+    /** Set after the subscriptions start, hence atomic */
+    std::atomic<CRealDeepracerTrigger*> m_pcTrigger;
 };
 
 #endif // REAL_DEEPRACER_DEVICE_H
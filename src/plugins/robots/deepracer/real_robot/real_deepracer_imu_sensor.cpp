@@ -1,6 +1,8 @@
 #include "real_deepracer_imu_sensor.h"
 
 CRealDeepracerIMUSensor::CRealDeepracerIMUSensor(const std::shared_ptr<rclcpp::Node>& pt_node_handle) : CRealDeepracerDevice(pt_node_handle){
+    rclcpp::SubscriptionOptions tOptions;
+    tOptions.callback_group = m_ptCallbackGroup;
     m_ptImuSubscription = pt_node_handle->create_subscription<sensor_msgs::msg::Imu>(
             //http://docs.ros.org/en/noetic/api/sensor_msgs/html/msg/Imu.html
             "/imu_pkg/data_raw",
@@ -9,7 +11,8 @@ CRealDeepracerIMUSensor::CRealDeepracerIMUSensor(const std::shared_ptr<rclcpp::N
                     &CRealDeepracerIMUSensor::ImuCallBack,
                     this,
                     std::placeholders::_1
-            )
+            ),
+            tOptions
     );
 }
 
@@ -35,31 +38,42 @@ void CRealDeepracerIMUSensor::ImuCallBack(const sensor_msgs::msg::Imu::SharedPtr
         aws-deepracer node runs, the signs may not stay as calibrated.
     */
 
+    SReading& sReading = m_cReadings.GetWriteBuffer();
+
     // Update the angular velocity values
-    m_vecAngularVelocity.SetX(msg->angular_velocity.x);
-    m_vecAngularVelocity.SetY(msg->angular_velocity.y);
-    m_vecAngularVelocity.SetZ(msg->angular_velocity.z);
+    sReading.AngVelocity.SetX(msg->angular_velocity.x);
+    sReading.AngVelocity.SetY(msg->angular_velocity.y);
+    sReading.AngVelocity.SetZ(msg->angular_velocity.z);
+
+    //Update the linear acceleration values
+    sReading.LinAcceleration.SetX(-msg->linear_acceleration.x);
+    sReading.LinAcceleration.SetY(-msg->linear_acceleration.y);
+    sReading.LinAcceleration.SetZ(-msg->linear_acceleration.z);
+
+    m_cReadings.Publish();
+    NotifyTrigger();
+}
 
-    //Update the angular velocity values
-    m_vecLinearAcceleration.SetX(-msg->linear_acceleration.x);
-    m_vecLinearAcceleration.SetY(-msg->linear_acceleration.y);
-    m_vecLinearAcceleration.SetZ(-msg->linear_acceleration.z);
+/****************************************/
+/****************************************/
 
+void CRealDeepracerIMUSensor::Do(Real f_elapsed_time) {
     // Populate as reading struct
-    m_sReading.AngVelocity = m_vecAngularVelocity;
-    m_sReading.LinAcceleration = m_vecLinearAcceleration;
+    if (m_cReadings.Update()) {
+        m_sReading = m_cReadings.Get();
+    }
 }
 
 /****************************************/
 /****************************************/
 
 CVector3 CRealDeepracerIMUSensor::GetAngularVelocities() const{
-    return m_vecAngularVelocity;
+    return m_sReading.AngVelocity;
 }
 
 /****************************************/
 /****************************************/
 
 CVector3 CRealDeepracerIMUSensor::GetLinearAccelerations() const{
-    return m_vecLinearAcceleration;
+    return m_sReading.LinAcceleration;
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 
 #include <sensor_msgs/msg/imu.hpp>
 #include <argos3/plugins/robots/deepracer/real_robot/real_deepracer_device.h>
+#include <argos3/plugins/robots/deepracer/real_robot/real_deepracer_mailbox.h>
 #include <argos3/plugins/robots/deepracer/control_interface/ci_deepracer_imu_sensor.h>
 #include <argos3/core/utility/math/vector3.h>
 
@@ -15,14 +16,22 @@ public:
     CRealDeepracerIMUSensor(const std::shared_ptr<rclcpp::Node>& pt_node_handle);
     virtual ~CRealDeepracerIMUSensor();
 
+    /**
+     * Takes the latest reading, which stays the same until the next call.
+     */
+    virtual void Do(Real f_elapsed_time);
+
     virtual CVector3 GetAngularVelocities() const;
     virtual CVector3 GetLinearAccelerations() const;
 
 private:
+    /**
+     * Runs on an executor thread.
+     */
     void ImuCallBack(const sensor_msgs::msg::Imu::SharedPtr msg);
     rclcpp::Subscription<sensor_msgs::msg::Imu>::SharedPtr m_ptImuSubscription;
-    CVector3 m_vecAngularVelocity;
-    CVector3 m_vecLinearAcceleration;
+    /* Written by the callback, read by the control step */
+    CRealDeepracerMailbox<SReading> m_cReadings;
 
 };
 
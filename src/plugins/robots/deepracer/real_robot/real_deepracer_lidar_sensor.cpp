@@ -1,78 +1,104 @@
 #include "real_deepracer_lidar_sensor.h"
 
+/* Messages in the pool: the callback group takes one scan at a time, plus a spare */
+static const size_t SCAN_POOL_SIZE = 2;
+
+/* Longest wait for the motor services */
+static const std::chrono::seconds MOTOR_SERVICE_TIMEOUT(5);
+
+/****************************************/
+/****************************************/
+
 CRealDeepracerLIDARSensor::CRealDeepracerLIDARSensor(const std::shared_ptr<rclcpp::Node>& pt_node_handle) : CRealDeepracerDevice(pt_node_handle) {
+    rclcpp::SubscriptionOptions tOptions;
+    tOptions.callback_group = m_ptCallbackGroup;
+    /* Messages recycled with their range storage, so receiving a scan allocates nothing */
+    m_ptScanPool = std::make_shared<CRealDeepracerMessagePool<sensor_msgs::msg::LaserScan> >(
+        SCAN_POOL_SIZE,
+        [](sensor_msgs::msg::LaserScan& t_msg) { t_msg.ranges.reserve(SCAN_CAPACITY); });
     m_ptLidarSubscription = pt_node_handle->create_subscription<sensor_msgs::msg::LaserScan>(
         "/scan",
         10,
         std::bind(
             &CRealDeepracerLIDARSensor::LidarCallback,
             this,
-            std::placeholders::_1));
-
-    m_ptLidarStartClient = pt_node_handle->create_client<std_srvs::srv::Empty>("start_motor");
-    m_ptLidarStopClient  = pt_node_handle->create_client<std_srvs::srv::Empty>("stop_motor");
+            std::placeholders::_1),
+        tOptions,
+        m_ptScanPool);
+
+    m_ptLidarStartClient = pt_node_handle->create_client<std_srvs::srv::Empty>(
+        "start_motor", rmw_qos_profile_services_default, m_ptCallbackGroup);
+    m_ptLidarStopClient  = pt_node_handle->create_client<std_srvs::srv::Empty>(
+        "stop_motor", rmw_qos_profile_services_default, m_ptCallbackGroup);
 }
 
 CRealDeepracerLIDARSensor::~CRealDeepracerLIDARSensor() {
+    /* Beyond the pool size, each allocation is a scan received with all the messages in use */
+    LOG << "[INFO] LIDAR scan messages allocated: " << m_ptScanPool->GetNumAllocations()
+        << " (pool of " << SCAN_POOL_SIZE << ")" << std::endl;
 }
 
 /****************************************/
 /****************************************/
 
 void CRealDeepracerLIDARSensor::LidarCallback(const sensor_msgs::msg::LaserScan::SharedPtr msg) {
-    m_vecRanges       = std::vector<Real>{msg->ranges.begin(), msg->ranges.end()};
-    m_fAngleMin       = msg->angle_min;
-    m_fAngleMax       = msg->angle_max;
-    m_fAngleIncrement = msg->angle_increment;
-    m_fTimeIncrement  = msg->time_increment;
-    m_fScanTime       = msg->scan_time;
-    m_fRangeMin       = msg->range_min;
-    m_fRangeMax       = msg->range_max;
+    SScan& sScan = m_cScans.GetWriteBuffer();
+    /* Take the ranges without copying; the message gets the storage of the
+       buffer, which has the same capacity, and goes back to the pool */
+    sScan.Ranges.swap(msg->ranges);
+    sScan.AngleMin       = msg->angle_min;
+    sScan.AngleMax       = msg->angle_max;
+    sScan.AngleIncrement = msg->angle_increment;
+    sScan.TimeIncrement  = msg->time_increment;
+    sScan.ScanTime       = msg->scan_time;
+    sScan.RangeMin       = msg->range_min;
+    sScan.RangeMax       = msg->range_max;
+    m_cScans.Publish();
+    NotifyTrigger();
 }
 
 /****************************************/
 /****************************************/
 
 void CRealDeepracerLIDARSensor::Do(Real f_elapsed_time) {
-    // Do nothing, the callback handles data population
+    m_cScans.Update();
 }
 
 /****************************************/
 /****************************************/
 
 Real CRealDeepracerLIDARSensor::GetReading(UInt32 un_idx) const {
-    return m_vecRanges.at(un_idx);
+    return m_cScans.Get().Ranges.at(un_idx);
 }
 
 /****************************************/
 /****************************************/
 
 void CRealDeepracerLIDARSensor::PowerOn() {
-    std::shared_ptr<std_srvs::srv::Empty::Request> ptRequest;
+    CallMotorService(m_ptLidarStartClient, "started");
+}
 
-    auto ptResult = m_ptLidarStartClient->async_send_request(ptRequest);
+/****************************************/
+/****************************************/
 
-    if (rclcpp::spin_until_future_complete(m_ptNodeHandle, ptResult) ==
-        rclcpp::FutureReturnCode::SUCCESS) {
-        LOG << "LIDAR motor started" << std::endl;
-    } else {
-        LOGERR << "Failed to call ROS service 'start_motor'" << std::endl;
-    }
+void CRealDeepracerLIDARSensor::PowerOff() {
+    CallMotorService(m_ptLidarStopClient, "stopped");
 }
 
 /****************************************/
 /****************************************/
 
-void CRealDeepracerLIDARSensor::PowerOff() {
-    std::shared_ptr<std_srvs::srv::Empty::Request> ptRequest;
+void CRealDeepracerLIDARSensor::CallMotorService(rclcpp::Client<std_srvs::srv::Empty>::SharedPtr& pt_client,
+                                                 const std::string& str_action) {
+    auto ptRequest = std::make_shared<std_srvs::srv::Empty::Request>();
 
-    auto ptResult = m_ptLidarStopClient->async_send_request(ptRequest);
+    auto ptResult = pt_client->async_send_request(ptRequest);
 
-    if (rclcpp::spin_until_future_complete(m_ptNodeHandle, ptResult) ==
-        rclcpp::FutureReturnCode::SUCCESS) {
-        LOG << "LIDAR motor stopped" << std::endl;
+    /* The node is spun by the executor, which completes the future */
+    if (ptResult.wait_for(MOTOR_SERVICE_TIMEOUT) == std::future_status::ready) {
+        LOG << "LIDAR motor " << str_action << std::endl;
     } else {
-        LOGERR << "Failed to call ROS service 'stop_motor'" << std::endl;
+        LOGERR << "Failed to call ROS service '" << pt_client->get_service_name() << "'" << std::endl;
     }
 }
 
@@ -80,47 +106,47 @@ void CRealDeepracerLIDARSensor::PowerOff() {
 /****************************************/
 
 Real CRealDeepracerLIDARSensor::GetAngleMin() {
-    return m_fAngleMin;
+    return m_cScans.Get().AngleMin;
 }
 
 /****************************************/
 /****************************************/
 
 Real CRealDeepracerLIDARSensor::GetAngleMax() {
-    return m_fAngleMax;
+    return m_cScans.Get().AngleMax;
 }
 
 /****************************************/
 /****************************************/
 
 Real CRealDeepracerLIDARSensor::GetAngleIncrement() {
-    return m_fAngleIncrement;
+    return m_cScans.Get().AngleIncrement;
 }
 
 /****************************************/
 /****************************************/
 
 Real CRealDeepracerLIDARSensor::GetRangeMin() {
-    return m_fRangeMin;
+    return m_cScans.Get().RangeMin;
 }
 
 /****************************************/
 /****************************************/
 
 Real CRealDeepracerLIDARSensor::GetRangeMax() {
-    return m_fRangeMax;
+    return m_cScans.Get().RangeMax;
 }
 
 /****************************************/
 /****************************************/
 
 Real CRealDeepracerLIDARSensor::GetTimeIncrement() {
-    return m_fTimeIncrement;
+    return m_cScans.Get().TimeIncrement;
 }
 
 /****************************************/
 /****************************************/
 
 Real CRealDeepracerLIDARSensor::GetTimeScan() {
-    return m_fScanTime;
+    return m_cScans.Get().ScanTime;
 }
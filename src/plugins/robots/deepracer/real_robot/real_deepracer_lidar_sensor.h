@@ -3,6 +3,8 @@
 #include <argos3/core/utility/math/vector3.h>
 #include <argos3/plugins/robots/deepracer/control_interface/ci_deepracer_lidar_sensor.h>
 #include <argos3/plugins/robots/deepracer/real_robot/real_deepracer_device.h>
+#include <argos3/plugins/robots/deepracer/real_robot/real_deepracer_mailbox.h>
+#include <argos3/plugins/robots/deepracer/real_robot/real_deepracer_message_pool.h>
 
 #include <functional>
 #include <memory>
@@ -20,6 +22,9 @@ public:
 
     virtual ~CRealDeepracerLIDARSensor();
 
+    /**
+     * Takes the latest scan, which stays the same until the next call.
+     */
     virtual void Do(Real f_elapsed_time);
 
     /**
@@ -31,7 +36,14 @@ public:
      * Returns the readings of this sensor
      */
     inline size_t GetNumReadings() const {
-        return m_vecRanges.size();
+        return m_cScans.Get().Ranges.size();
+    }
+
+    /**
+     * Returns the range data [m] of the last scan taken, as received.
+     */
+    inline const std::vector<float>& GetRanges() const {
+        return m_cScans.Get().Ranges;
     }
 
     /*
@@ -81,22 +93,49 @@ public:
 
 private:
 
+    /* Ranges reserved in each buffer and message, beyond the size of a scan */
+    static const size_t SCAN_CAPACITY = 2048;
+
+    struct SScan {
+        std::vector<float> Ranges; // Vector of ranges, in the type of the message
+
+        Real AngleMin;       // Start angle of the scan [rad]
+        Real AngleMax;       // End angle of the scan [rad]
+        Real AngleIncrement; // Angular distance between measurements [rad]
+
+        Real TimeIncrement; // Time between measurements [seconds]
+        Real ScanTime;      // Time between scans [seconds]
+
+        Real RangeMin; // Minimum range value [m]
+        Real RangeMax; // Maximum range value [m]
+
+        SScan() :
+            AngleMin(0.0), AngleMax(0.0), AngleIncrement(0.0),
+            TimeIncrement(0.0), ScanTime(0.0),
+            RangeMin(0.0), RangeMax(0.0) {
+            Ranges.reserve(SCAN_CAPACITY);
+        }
+    };
+
+private:
+
+    /**
+     * Runs on an executor thread.
+     */
     void LidarCallback(const sensor_msgs::msg::LaserScan::SharedPtr msg);
 
+    /**
+     * Calls a motor service and waits for the answer, served by the executor.
+     */
+    void CallMotorService(rclcpp::Client<std_srvs::srv::Empty>::SharedPtr& pt_client,
+                          const std::string& str_action);
+
     rclcpp::Subscription<sensor_msgs::msg::LaserScan>::SharedPtr m_ptLidarSubscription;
+    CRealDeepracerMessagePool<sensor_msgs::msg::LaserScan>::SharedPtr m_ptScanPool;
     rclcpp::Client<std_srvs::srv::Empty>::SharedPtr              m_ptLidarStartClient;
     rclcpp::Client<std_srvs::srv::Empty>::SharedPtr              m_ptLidarStopClient;
 
-    std::vector<Real> m_vecRanges; // Vector of ranges
-
-    Real m_fAngleMin;       // Start angle of the scan [rad]
-    Real m_fAngleMax;       // End angle of the scan [rad]
-    Real m_fAngleIncrement; // Angular distance between measurements [rad]
-
-    Real m_fTimeIncrement; // Time between measurements [seconds]
-    Real m_fScanTime;      // Mime between scans [seconds]
-
-    Real m_fRangeMin; // Minimum range value [m]
-    Real m_fRangeMax; // Maximum range value [m]
+    /** Written by the callback, read by the control step */
+    CRealDeepracerMailbox<SScan> m_cScans;
 };
 #endif
@@ -0,0 +1,105 @@
+#include "real_deepracer_loop_stats.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <limits>
+
+/* Width of the longest bar of a histogram, in characters */
+static const size_t BAR_WIDTH = 40;
+
+/****************************************/
+/****************************************/
+
+CRealDeepracerLoopStats::CRealDeepracerLoopStats(Real f_bin_width) :
+    m_fBinWidth(f_bin_width),
+    m_unMarks(0),
+    m_fLastPeriod(0.0) {
+}
+
+/****************************************/
+/****************************************/
+
+void CRealDeepracerLoopStats::SetBinWidth(Real f_bin_width) {
+    m_fBinWidth = f_bin_width;
+}
+
+/****************************************/
+/****************************************/
+
+std::string CRealDeepracerLoopStats::GetReport() const {
+    std::string strReport;
+    m_sPeriods.Report(strReport, "Control period", m_fBinWidth);
+    m_sJitter.Report(strReport, "Control jitter", m_fBinWidth);
+    return strReport;
+}
+
+/****************************************/
+/****************************************/
+
+CRealDeepracerLoopStats::SHistogram::SHistogram() :
+    Count(0),
+    Sum(0.0),
+    Min(std::numeric_limits<Real>::max()),
+    Max(0.0) {
+    for (size_t i = 0; i <= NUM_BINS; ++i) {
+        Bins[i] = 0;
+    }
+}
+
+/****************************************/
+/****************************************/
+
+Real CRealDeepracerLoopStats::SHistogram::GetQuantile(Real f_fraction,
+                                                      Real f_bin_width) const {
+    UInt64 unTarget = static_cast<UInt64>(f_fraction * Count);
+    UInt64 unSeen = 0;
+    for (size_t i = 0; i < NUM_BINS; ++i) {
+        unSeen += Bins[i];
+        if (unSeen > unTarget) return std::min((i + 1) * f_bin_width, Max);
+    }
+    return Max;
+}
+
+/****************************************/
+/****************************************/
+
+void CRealDeepracerLoopStats::SHistogram::Report(std::string& str_out,
+                                                 const std::string& str_name,
+                                                 Real f_bin_width) const {
+    char pchLine[128];
+    if (Count == 0) {
+        str_out += str_name + ": no samples\n";
+        return;
+    }
+    /* Summary, in milliseconds */
+    ::snprintf(pchLine, sizeof(pchLine),
+               "%s: %llu samples, min %.2f ms, mean %.2f ms, p99 %.2f ms, max %.2f ms\n",
+               str_name.c_str(),
+               static_cast<unsigned long long>(Count),
+               Min * 1e3,
+               Sum / Count * 1e3,
+               GetQuantile(0.99, f_bin_width) * 1e3,
+               Max * 1e3);
+    str_out += pchLine;
+    /* Non-empty bins, with bars scaled to the fullest one */
+    UInt64 unFullest = 0;
+    for (size_t i = 0; i <= NUM_BINS; ++i) {
+        if (Bins[i] > unFullest) unFullest = Bins[i];
+    }
+    for (size_t i = 0; i <= NUM_BINS; ++i) {
+        if (Bins[i] == 0) continue;
+        if (i < NUM_BINS) {
+            ::snprintf(pchLine, sizeof(pchLine), "  [%7.2f, %7.2f) ms %10llu ",
+                       i * f_bin_width * 1e3,
+                       (i + 1) * f_bin_width * 1e3,
+                       static_cast<unsigned long long>(Bins[i]));
+        } else {
+            ::snprintf(pchLine, sizeof(pchLine), "  [%7.2f,     inf) ms %10llu ",
+                       i * f_bin_width * 1e3,
+                       static_cast<unsigned long long>(Bins[i]));
+        }
+        str_out += pchLine;
+        str_out.append((Bins[i] * BAR_WIDTH + unFullest - 1) / unFullest, '#');
+        str_out += '\n';
+    }
+}
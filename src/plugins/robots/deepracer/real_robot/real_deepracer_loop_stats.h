@@ -0,0 +1,102 @@
+#ifndef REAL_DEEPRACER_LOOP_STATS_H
+#define REAL_DEEPRACER_LOOP_STATS_H
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <chrono>
+#include <string>
+
+using namespace argos;
+
+/**
+ * Histograms of the period of the control loop and of its jitter, the
+ * difference between two consecutive periods.
+ *
+ * Mark() is called at the start of each control step. It only reads the
+ * clock and increments two counters, so it can stay enabled on the robot.
+ * Bins have a fixed width; values beyond the last bin go to an overflow bin,
+ * but still count in the minimum, maximum and mean.
+ */
+class CRealDeepracerLoopStats {
+public:
+
+    typedef std::chrono::steady_clock TClock;
+
+    /* Bins of each histogram, plus the overflow */
+    static const size_t NUM_BINS = 100;
+
+public:
+
+    /**
+     * @param f_bin_width the width of the bins [s].
+     */
+    CRealDeepracerLoopStats(Real f_bin_width = 0.001);
+
+    void SetBinWidth(Real f_bin_width);
+
+    /**
+     * Marks the start of a control step.
+     */
+    inline void Mark() {
+        TClock::time_point tNow = TClock::now();
+        if (m_unMarks > 0) {
+            Real fPeriod = std::chrono::duration<Real>(tNow - m_tLastMark).count();
+            m_sPeriods.Add(fPeriod, m_fBinWidth);
+            if (m_unMarks > 1) {
+                m_sJitter.Add(fPeriod > m_fLastPeriod ? fPeriod - m_fLastPeriod : m_fLastPeriod - fPeriod, m_fBinWidth);
+            }
+            m_fLastPeriod = fPeriod;
+        }
+        m_tLastMark = tNow;
+        ++m_unMarks;
+    }
+
+    /**
+     * Returns the histograms as text, one line per non-empty bin.
+     */
+    std::string GetReport() const;
+
+private:
+
+    struct SHistogram {
+        UInt64 Bins[NUM_BINS + 1];
+        UInt64 Count;
+        Real   Sum;
+        Real   Min;
+        Real   Max;
+
+        SHistogram();
+
+        inline void Add(Real f_value,
+                        Real f_bin_width) {
+            size_t unBin = static_cast<size_t>(f_value / f_bin_width);
+            ++Bins[unBin < NUM_BINS ? unBin : NUM_BINS];
+            ++Count;
+            Sum += f_value;
+            if (f_value < Min) Min = f_value;
+            if (f_value > Max) Max = f_value;
+        }
+
+        /**
+         * Returns the upper edge of the bin holding the given fraction of the values,
+         * at most the maximum.
+         */
+        Real GetQuantile(Real f_fraction,
+                         Real f_bin_width) const;
+
+        void Report(std::string& str_out,
+                    const std::string& str_name,
+                    Real f_bin_width) const;
+    };
+
+private:
+
+    Real               m_fBinWidth;
+    UInt64             m_unMarks;
+    TClock::time_point m_tLastMark;
+    Real               m_fLastPeriod;
+    SHistogram         m_sPeriods;
+    SHistogram         m_sJitter;
+};
+
+#endif
@@ -0,0 +1,74 @@
+#ifndef REAL_DEEPRACER_MAILBOX_H
+#define REAL_DEEPRACER_MAILBOX_H
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <atomic>
+
+using namespace argos;
+
+/**
+ * A lock-free mailbox holding the latest value of a sensor, written by one
+ * ROS callback thread and read by the control thread (triple buffering).
+ *
+ * The writer fills its own buffer and publishes it by swapping it with the
+ * middle one; the reader takes the middle buffer by swapping it with its own
+ * when a new value was published. Neither side ever waits, each swap is one
+ * atomic exchange, and the buffers keep their allocations, so publishing a
+ * scan into a vector that already has the right size allocates nothing.
+ */
+template <class T>
+class CRealDeepracerMailbox {
+public:
+
+    CRealDeepracerMailbox() :
+        m_unWrite(0),
+        m_unMiddle(1),
+        m_unRead(2) {}
+
+    /**
+     * Returns the buffer to fill; writer side.
+     */
+    inline T& GetWriteBuffer() {
+        return m_ptBuffers[m_unWrite];
+    }
+
+    /**
+     * Makes the write buffer the latest value; writer side.
+     */
+    inline void Publish() {
+        m_unWrite = m_unMiddle.exchange(m_unWrite | NEW_VALUE, std::memory_order_acq_rel) & INDEX_MASK;
+    }
+
+    /**
+     * Takes the latest value, if a new one was published; reader side.
+     * @return true if the value changed.
+     */
+    inline bool Update() {
+        if ((m_unMiddle.load(std::memory_order_relaxed) & NEW_VALUE) == 0) return false;
+        m_unRead = m_unMiddle.exchange(m_unRead, std::memory_order_acq_rel) & INDEX_MASK;
+        return true;
+    }
+
+    /**
+     * Returns the value taken by the last Update(); reader side.
+     */
+    inline const T& Get() const {
+        return m_ptBuffers[m_unRead];
+    }
+
+private:
+
+    static const UInt8 INDEX_MASK = 0x3;
+    static const UInt8 NEW_VALUE  = 0x4;
+
+    T                  m_ptBuffers[3];
+    /** Written by the writer only */
+    UInt8              m_unWrite;
+    /** Index of the middle buffer, and whether it holds a value not read yet */
+    std::atomic<UInt8> m_unMiddle;
+    /** Written by the reader only */
+    UInt8              m_unRead;
+};
+
+#endif // REAL_DEEPRACER_MAILBOX_H
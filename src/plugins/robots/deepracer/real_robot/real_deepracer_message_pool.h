@@ -0,0 +1,90 @@
+#ifndef REAL_DEEPRACER_MESSAGE_POOL_H
+#define REAL_DEEPRACER_MESSAGE_POOL_H
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <rclcpp/message_memory_strategy.hpp>
+
+using namespace argos;
+
+/**
+ * A message memory strategy that recycles the messages a subscription
+ * receives, instead of allocating a new one per message.
+ *
+ * The executor borrows a message, deserializes into it and returns it after
+ * the callback, which must not keep a reference to it: it is recycled as
+ * soon as it is returned, with the storage of its sequences, so once they
+ * have the size of the incoming messages, deserializing allocates nothing. Callbacks can swap a sequence with one of their own buffers of
+ * the same capacity to take the data without copying it.
+ */
+template <class MESSAGE>
+class CRealDeepracerMessagePool :
+        public rclcpp::message_memory_strategy::MessageMemoryStrategy<MESSAGE> {
+public:
+
+    typedef std::shared_ptr<CRealDeepracerMessagePool> SharedPtr;
+
+public:
+
+    /**
+     * @param un_size the number of messages allocated upfront.
+     * @param c_prepare called on each message allocated, e.g. to reserve its sequences.
+     */
+    CRealDeepracerMessagePool(size_t un_size,
+                              const std::function<void(MESSAGE&)>& c_prepare = std::function<void(MESSAGE&)>()) :
+        m_cPrepare(c_prepare),
+        m_unNumAllocations(0) {
+        for (size_t i = 0; i < un_size; ++i) {
+            m_vecFree.push_back(Allocate());
+        }
+    }
+
+    virtual std::shared_ptr<MESSAGE> borrow_message() {
+        std::lock_guard<std::mutex> cLock(m_cMutex);
+        if (m_vecFree.empty()) {
+            /* More messages in flight than expected */
+            return Allocate();
+        }
+        std::shared_ptr<MESSAGE> ptMessage = m_vecFree.back();
+        m_vecFree.pop_back();
+        return ptMessage;
+    }
+
+    virtual void return_message(std::shared_ptr<MESSAGE>& pt_message) {
+        std::lock_guard<std::mutex> cLock(m_cMutex);
+        /* The executor is done with the message; the subscription may still
+           hold a typed copy of the pointer, so the count is not checked */
+        m_vecFree.push_back(pt_message);
+        pt_message.reset();
+    }
+
+    /**
+     * Returns the number of messages allocated since the creation of the pool.
+     */
+    inline size_t GetNumAllocations() const {
+        std::lock_guard<std::mutex> cLock(m_cMutex);
+        return m_unNumAllocations;
+    }
+
+private:
+
+    std::shared_ptr<MESSAGE> Allocate() {
+        std::shared_ptr<MESSAGE> ptMessage = std::make_shared<MESSAGE>();
+        if (m_cPrepare) m_cPrepare(*ptMessage);
+        ++m_unNumAllocations;
+        return ptMessage;
+    }
+
+private:
+
+    std::function<void(MESSAGE&)>         m_cPrepare;
+    std::vector<std::shared_ptr<MESSAGE>> m_vecFree;
+    mutable std::mutex                    m_cMutex;
+    size_t                                m_unNumAllocations;
+};
+
+#endif // REAL_DEEPRACER_MESSAGE_POOL_H
@@ -0,0 +1,70 @@
+#ifndef REAL_DEEPRACER_TRIGGER_H
+#define REAL_DEEPRACER_TRIGGER_H
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+using namespace argos;
+
+/**
+ * Wakes the control loop when a sensor delivers a new sample.
+ *
+ * The sensor callback calls Notify() after publishing its sample; the control
+ * thread waits for a notification it hasn't seen yet, up to a deadline. The
+ * count of notifications is kept rather than a flag, so samples arriving while
+ * the control step runs are not lost.
+ */
+class CRealDeepracerTrigger {
+public:
+
+    typedef std::chrono::steady_clock TClock;
+
+public:
+
+    CRealDeepracerTrigger() :
+        m_unCount(0) {}
+
+    /**
+     * Signals a new sample; called from an executor thread.
+     */
+    inline void Notify() {
+        {
+            std::lock_guard<std::mutex> cLock(m_cMutex);
+            ++m_unCount;
+        }
+        m_cCondition.notify_one();
+    }
+
+    /**
+     * Returns the number of notifications so far.
+     */
+    inline UInt64 GetCount() {
+        std::lock_guard<std::mutex> cLock(m_cMutex);
+        return m_unCount;
+    }
+
+    /**
+     * Waits until a notification newer than un_seen arrives or the deadline passes.
+     * @param un_seen the count seen so far, updated to the current one.
+     * @return true if a new notification arrived, false on timeout.
+     */
+    inline bool WaitUntil(UInt64& un_seen,
+                          const TClock::time_point& t_deadline) {
+        std::unique_lock<std::mutex> cLock(m_cMutex);
+        bool bNew = m_cCondition.wait_until(cLock, t_deadline,
+                                            [this, un_seen]() { return m_unCount != un_seen; });
+        un_seen = m_unCount;
+        return bNew;
+    }
+
+private:
+
+    std::mutex              m_cMutex;
+    std::condition_variable m_cCondition;
+    UInt64                  m_unCount;
+};
+
+#endif
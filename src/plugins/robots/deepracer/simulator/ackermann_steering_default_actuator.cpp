@@ -77,8 +77,8 @@ namespace argos {
                 CHECK_ATTRIBUTE("factor_stddev");
             /* Handle noise attributes, if any */
             if (bNoise) {
-                /* Create RNG */
-                m_pcRNG = CRandom::CreateRNG("argos");
+                /* Create RNG, once: Init() runs again when a checkpoint branch changes the parameters */
+                if (m_pcRNG == nullptr) m_pcRNG = CRandom::CreateRNG("argos");
                 /* Parse noise attributes */
                 Real fNoiseBiasAvg[4];
                 Real fNoiseBiasStdDev[4];
@@ -0,0 +1,252 @@
+#include "deepracer_asset_cache.h"
+
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/core/utility/string_utilities.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    static const char   CACHE_MAGIC[8] = { 'D', 'R', 'C', 'A', 'C', 'H', 'E', '\0' };
+    static const UInt32 CACHE_VERSION  = 1;
+
+    /* Sections start on cache lines */
+    static const size_t SECTION_ALIGNMENT = 64;
+
+    /* FNV-1a */
+    static const UInt64 HASH_OFFSET = 14695981039346656037ULL;
+    static const UInt64 HASH_PRIME  = 1099511628211ULL;
+
+    struct SCacheHeader {
+        char   Magic[8];
+        UInt32 Version;
+        UInt32 NumSections;
+        UInt64 Hash;
+        /** Size of the whole file */
+        UInt64 Size;
+    };
+
+    struct SCacheSection {
+        char   Name[32];
+        UInt32 ElementSize;
+        UInt32 Reserved;
+        UInt64 Offset;
+        UInt64 Count;
+    };
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerAssetKey::CDeepracerAssetKey(const std::string& str_kind) :
+        m_strKind(str_kind),
+        m_unHash(HASH_OFFSET) {
+        Add(str_kind);
+        /* Cached structures hold Reals */
+        AddValue<UInt32>(sizeof(Real));
+        AddValue<UInt32>(CACHE_VERSION);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerAssetKey& CDeepracerAssetKey::Add(const void* p_data,
+                                                size_t un_size) {
+        const UInt8* punData = static_cast<const UInt8*>(p_data);
+        for (size_t i = 0; i < un_size; ++i) {
+            m_unHash = (m_unHash ^ punData[i]) * HASH_PRIME;
+        }
+        return *this;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerAssetKey& CDeepracerAssetKey::Add(const std::string& str_value) {
+        /* The length keeps consecutive strings apart */
+        AddValue<UInt64>(str_value.size());
+        return Add(str_value.data(), str_value.size());
+    }
+
+    /****************************************/
+    /****************************************/
+
+    std::string CDeepracerAssetKey::GetFileName() const {
+        char pchHash[17];
+        ::snprintf(pchHash, sizeof(pchHash), "%016llx", static_cast<unsigned long long>(m_unHash));
+        return m_strKind + "-" + pchHash + ".drcache";
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerAssetBuilder::AddRawSection(const std::string& str_name,
+                                               UInt32 un_element_size,
+                                               const void* p_data,
+                                               size_t un_count) {
+        SSection sSection;
+        sSection.Name        = str_name.substr(0, sizeof(SCacheSection::Name) - 1);
+        sSection.ElementSize = un_element_size;
+        sSection.Count       = un_count;
+        sSection.Data.assign(static_cast<const char*>(p_data), un_element_size * un_count);
+        m_vecSections.push_back(sSection);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerAsset::~CDeepracerAsset() {
+        ::munmap(const_cast<char*>(m_pchData), m_unSize);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    bool CDeepracerAsset::FindSection(const std::string& str_name,
+                                      size_t un_element_size,
+                                      const void*& p_data,
+                                      UInt64& un_count) const {
+        const SCacheHeader* psHeader = reinterpret_cast<const SCacheHeader*>(m_pchData);
+        const SCacheSection* psSections = reinterpret_cast<const SCacheSection*>(m_pchData + sizeof(SCacheHeader));
+        for (UInt32 i = 0; i < psHeader->NumSections; ++i) {
+            if (str_name == psSections[i].Name) {
+                if (psSections[i].ElementSize != un_element_size) return false;
+                p_data   = m_pchData + psSections[i].Offset;
+                un_count = psSections[i].Count;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerAssetCache::CDeepracerAssetCache(const std::string& str_directory) :
+        m_strDirectory(str_directory) {
+        if (IsEnabled() &&
+            ::mkdir(m_strDirectory.c_str(), 0755) != 0 && errno != EEXIST) {
+            LOGERR << "[WARNING] Can't create the DeepRacer asset cache \"" << m_strDirectory
+                   << "\": " << ::strerror(errno) << ", caching disabled" << std::endl;
+            m_strDirectory.clear();
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    std::shared_ptr<const CDeepracerAsset> CDeepracerAssetCache::Find(const CDeepracerAssetKey& c_key) const {
+        if (!IsEnabled()) return std::shared_ptr<const CDeepracerAsset>();
+        return Map(m_strDirectory + "/" + c_key.GetFileName(), c_key);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    std::shared_ptr<const CDeepracerAsset> CDeepracerAssetCache::Store(const CDeepracerAssetKey& c_key,
+                                                                       const CDeepracerAssetBuilder& c_builder) const {
+        if (!IsEnabled()) return std::shared_ptr<const CDeepracerAsset>();
+        /* Lay out the file */
+        const std::vector<CDeepracerAssetBuilder::SSection>& vecSections = c_builder.m_vecSections;
+        std::vector<SCacheSection> vecTable(vecSections.size());
+        UInt64 unOffset = sizeof(SCacheHeader) + vecSections.size() * sizeof(SCacheSection);
+        for (size_t i = 0; i < vecSections.size(); ++i) {
+            unOffset = (unOffset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+            ::memset(&vecTable[i], 0, sizeof(SCacheSection));
+            ::strncpy(vecTable[i].Name, vecSections[i].Name.c_str(), sizeof(vecTable[i].Name) - 1);
+            vecTable[i].ElementSize = vecSections[i].ElementSize;
+            vecTable[i].Offset      = unOffset;
+            vecTable[i].Count       = vecSections[i].Count;
+            unOffset += vecSections[i].Data.size();
+        }
+        SCacheHeader sHeader;
+        ::memcpy(sHeader.Magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+        sHeader.Version     = CACHE_VERSION;
+        sHeader.NumSections = vecSections.size();
+        sHeader.Hash        = c_key.GetHash();
+        sHeader.Size        = unOffset;
+        std::string strContents(unOffset, '\0');
+        ::memcpy(&strContents[0], &sHeader, sizeof(sHeader));
+        if (!vecTable.empty()) {
+            ::memcpy(&strContents[sizeof(sHeader)], vecTable.data(), vecTable.size() * sizeof(SCacheSection));
+        }
+        for (size_t i = 0; i < vecSections.size(); ++i) {
+            if (!vecSections[i].Data.empty()) {
+                ::memcpy(&strContents[vecTable[i].Offset], vecSections[i].Data.data(), vecSections[i].Data.size());
+            }
+        }
+        /* Write under a name of this process, then publish atomically */
+        std::string strPath = m_strDirectory + "/" + c_key.GetFileName();
+        std::string strTemp = strPath + ".tmp." + ToString(::getpid());
+        FILE* pFile = ::fopen(strTemp.c_str(), "wb");
+        bool bWritten = (pFile != NULL) &&
+            (::fwrite(strContents.data(), 1, strContents.size(), pFile) == strContents.size());
+        if (pFile != NULL && ::fclose(pFile) != 0) bWritten = false;
+        if (!bWritten || ::rename(strTemp.c_str(), strPath.c_str()) != 0) {
+            LOGERR << "[WARNING] Can't store \"" << strPath << "\" in the DeepRacer asset cache: "
+                   << ::strerror(errno) << std::endl;
+            ::unlink(strTemp.c_str());
+            return std::shared_ptr<const CDeepracerAsset>();
+        }
+        return Map(strPath, c_key);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    std::string CDeepracerAssetCache::GetDefaultDirectory() {
+        const char* pchDirectory = ::getenv("ARGOS_DEEPRACER_CACHE");
+        return pchDirectory != NULL ? pchDirectory : "";
+    }
+
+    /****************************************/
+    /****************************************/
+
+    std::shared_ptr<const CDeepracerAsset> CDeepracerAssetCache::Map(const std::string& str_path,
+                                                                     const CDeepracerAssetKey& c_key) const {
+        int nFile = ::open(str_path.c_str(), O_RDONLY);
+        if (nFile < 0) return std::shared_ptr<const CDeepracerAsset>();
+        struct stat sStat;
+        void* pMap = MAP_FAILED;
+        if (::fstat(nFile, &sStat) == 0 && sStat.st_size >= static_cast<off_t>(sizeof(SCacheHeader))) {
+            pMap = ::mmap(NULL, sStat.st_size, PROT_READ, MAP_SHARED, nFile, 0);
+        }
+        ::close(nFile);
+        if (pMap == MAP_FAILED) return std::shared_ptr<const CDeepracerAsset>();
+        /* The asset unmaps the file if it is invalid */
+        std::shared_ptr<const CDeepracerAsset> pcAsset(new CDeepracerAsset(static_cast<const char*>(pMap), sStat.st_size));
+        const SCacheHeader* psHeader = static_cast<const SCacheHeader*>(pMap);
+        UInt64 unTableEnd = sizeof(SCacheHeader) + static_cast<UInt64>(psHeader->NumSections) * sizeof(SCacheSection);
+        if (::memcmp(psHeader->Magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+            psHeader->Version != CACHE_VERSION ||
+            psHeader->Hash != c_key.GetHash() ||
+            psHeader->Size != static_cast<UInt64>(sStat.st_size) ||
+            unTableEnd > psHeader->Size) {
+            LOGERR << "[WARNING] Ignoring invalid DeepRacer asset cache file \"" << str_path << "\"" << std::endl;
+            return std::shared_ptr<const CDeepracerAsset>();
+        }
+        const SCacheSection* psSections = reinterpret_cast<const SCacheSection*>(static_cast<const char*>(pMap) + sizeof(SCacheHeader));
+        for (UInt32 i = 0; i < psHeader->NumSections; ++i) {
+            if (psSections[i].Name[sizeof(psSections[i].Name) - 1] != '\0' ||
+                psSections[i].Offset < unTableEnd ||
+                psSections[i].Offset + psSections[i].ElementSize * psSections[i].Count > psHeader->Size) {
+                LOGERR << "[WARNING] Ignoring invalid DeepRacer asset cache file \"" << str_path << "\"" << std::endl;
+                return std::shared_ptr<const CDeepracerAsset>();
+            }
+        }
+        return pcAsset;
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
@@ -0,0 +1,326 @@
+#ifndef DEEPRACER_ASSET_CACHE_H
+#define DEEPRACER_ASSET_CACHE_H
+
+namespace argos {
+    class CDeepracerAsset;
+    class CDeepracerAssetBuilder;
+    class CDeepracerAssetCache;
+    class CDeepracerAssetKey;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace argos {
+
+    /**
+     * An immutable array that either owns its elements or refers to
+     * elements mapped from a cache file, which it keeps mapped.
+     *
+     * It has the read-only interface of a vector, so structures built once
+     * (BVH nodes, grids, tables) can be used the same way whether they were
+     * built by this process or mapped from the cache.
+     */
+    template <class T>
+    class CDeepracerSharedArray {
+    public:
+
+        CDeepracerSharedArray() :
+            m_ptData(NULL),
+            m_unSize(0) {}
+
+        CDeepracerSharedArray(const CDeepracerSharedArray& c_other) :
+            m_ptData(NULL),
+            m_unSize(0) {
+            *this = c_other;
+        }
+
+        CDeepracerSharedArray& operator=(const CDeepracerSharedArray& c_other) {
+            if (this != &c_other) {
+                m_vecOwned = c_other.m_vecOwned;
+                m_pcAsset  = c_other.m_pcAsset;
+                m_ptData   = m_pcAsset ? c_other.m_ptData : m_vecOwned.data();
+                m_unSize   = c_other.m_unSize;
+            }
+            return *this;
+        }
+
+        /**
+         * Takes the elements of a vector, which is left empty.
+         */
+        void Assign(std::vector<T>& vec_elements) {
+            m_pcAsset.reset();
+            m_vecOwned.swap(vec_elements);
+            vec_elements.clear();
+            m_ptData = m_vecOwned.data();
+            m_unSize = m_vecOwned.size();
+        }
+
+        /**
+         * Refers to elements mapped from a cache file.
+         */
+        void Map(const std::shared_ptr<const CDeepracerAsset>& pc_asset,
+                 const T* pt_data,
+                 size_t un_size) {
+            std::vector<T>().swap(m_vecOwned);
+            m_pcAsset = pc_asset;
+            m_ptData  = pt_data;
+            m_unSize  = un_size;
+        }
+
+        inline bool IsMapped() const {
+            return m_pcAsset.get() != NULL;
+        }
+
+        inline const T* data() const {
+            return m_ptData;
+        }
+
+        inline size_t size() const {
+            return m_unSize;
+        }
+
+        inline bool empty() const {
+            return m_unSize == 0;
+        }
+
+        inline const T& operator[](size_t un_index) const {
+            return m_ptData[un_index];
+        }
+
+    private:
+
+        std::vector<T>                         m_vecOwned;
+        std::shared_ptr<const CDeepracerAsset> m_pcAsset;
+        const T*                               m_ptData;
+        size_t                                 m_unSize;
+    };
+
+    /****************************************/
+    /****************************************/
+
+    /**
+     * The key of a cached asset: its kind and a hash of everything it is
+     * derived from (input data, parameters, version of the algorithm).
+     */
+    class CDeepracerAssetKey {
+    public:
+
+        explicit CDeepracerAssetKey(const std::string& str_kind);
+
+        /**
+         * Adds raw bytes to the hash; they must not contain padding.
+         */
+        CDeepracerAssetKey& Add(const void* p_data,
+                                size_t un_size);
+
+        CDeepracerAssetKey& Add(const std::string& str_value);
+
+        /**
+         * Adds a number to the hash.
+         */
+        template <class T>
+        CDeepracerAssetKey& AddValue(T t_value) {
+            return Add(&t_value, sizeof(T));
+        }
+
+        inline const std::string& GetKind() const {
+            return m_strKind;
+        }
+
+        inline UInt64 GetHash() const {
+            return m_unHash;
+        }
+
+        /**
+         * Returns the name of the cache file, "<kind>-<hash>.drcache".
+         */
+        std::string GetFileName() const;
+
+    private:
+
+        std::string m_strKind;
+        UInt64      m_unHash;
+    };
+
+    /****************************************/
+    /****************************************/
+
+    /**
+     * Collects the named sections of an asset before it is stored.
+     */
+    class CDeepracerAssetBuilder {
+    public:
+
+        /**
+         * Adds an array of trivially copyable elements.
+         */
+        template <class T>
+        void AddSection(const std::string& str_name,
+                        const T* pt_data,
+                        size_t un_count) {
+            AddRawSection(str_name, sizeof(T), pt_data, un_count);
+        }
+
+        template <class T>
+        void AddSection(const std::string& str_name,
+                        const CDeepracerSharedArray<T>& c_array) {
+            AddRawSection(str_name, sizeof(T), c_array.data(), c_array.size());
+        }
+
+        template <class T>
+        void AddValue(const std::string& str_name,
+                      const T& t_value) {
+            AddRawSection(str_name, sizeof(T), &t_value, 1);
+        }
+
+    private:
+
+        friend class CDeepracerAssetCache;
+
+        struct SSection {
+            std::string Name;
+            UInt32      ElementSize;
+            UInt64      Count;
+            std::string Data;
+        };
+
+        void AddRawSection(const std::string& str_name,
+                           UInt32 un_element_size,
+                           const void* p_data,
+                           size_t un_count);
+
+    private:
+
+        std::vector<SSection> m_vecSections;
+    };
+
+    /****************************************/
+    /****************************************/
+
+    /**
+     * A cache file mapped read-only in memory.
+     */
+    class CDeepracerAsset : public std::enable_shared_from_this<CDeepracerAsset> {
+    public:
+
+        ~CDeepracerAsset();
+
+        /**
+         * Makes an array refer to a section, without copying it.
+         * @return false if there is no such section or its elements have
+         * another size.
+         */
+        template <class T>
+        bool GetSection(const std::string& str_name,
+                        CDeepracerSharedArray<T>& c_array) const {
+            const void* pData;
+            UInt64 unCount;
+            if (!FindSection(str_name, sizeof(T), pData, unCount)) return false;
+            c_array.Map(shared_from_this(), static_cast<const T*>(pData), unCount);
+            return true;
+        }
+
+        /**
+         * Copies a section holding a single value.
+         */
+        template <class T>
+        bool GetValue(const std::string& str_name,
+                      T& t_value) const {
+            const void* pData;
+            UInt64 unCount;
+            if (!FindSection(str_name, sizeof(T), pData, unCount) || unCount != 1) return false;
+            t_value = *static_cast<const T*>(pData);
+            return true;
+        }
+
+        inline size_t GetSize() const {
+            return m_unSize;
+        }
+
+    private:
+
+        friend class CDeepracerAssetCache;
+
+        CDeepracerAsset(const char* pch_data,
+                        size_t un_size) :
+            m_pchData(pch_data),
+            m_unSize(un_size) {}
+
+        CDeepracerAsset(const CDeepracerAsset&);
+        CDeepracerAsset& operator=(const CDeepracerAsset&);
+
+        bool FindSection(const std::string& str_name,
+                         size_t un_element_size,
+                         const void*& p_data,
+                         UInt64& un_count) const;
+
+    private:
+
+        const char* m_pchData;
+        size_t      m_unSize;
+    };
+
+    /****************************************/
+    /****************************************/
+
+    /**
+     * A directory of content-addressed asset files shared by the ARGoS
+     * processes of a machine.
+     *
+     * The first process that needs an asset builds it and stores it; the
+     * others map the file read-only, so they skip the computation and the
+     * system keeps a single copy of its pages in memory for all of them.
+     * Files are written under a temporary name and renamed, so a process
+     * never maps a partial file, and processes racing to store the same
+     * asset write identical contents. Failures to read or write the cache
+     * are logged and the asset is built in memory instead.
+     */
+    class CDeepracerAssetCache {
+    public:
+
+        /**
+         * @param str_directory the cache directory, created if needed; the
+         * cache is disabled when it is empty.
+         */
+        explicit CDeepracerAssetCache(const std::string& str_directory);
+
+        inline bool IsEnabled() const {
+            return !m_strDirectory.empty();
+        }
+
+        /**
+         * Maps a cached asset.
+         * @return the asset, or NULL if it is not cached or the file is invalid.
+         */
+        std::shared_ptr<const CDeepracerAsset> Find(const CDeepracerAssetKey& c_key) const;
+
+        /**
+         * Stores an asset and maps the stored file.
+         * @return the asset, or NULL if it could not be stored.
+         */
+        std::shared_ptr<const CDeepracerAsset> Store(const CDeepracerAssetKey& c_key,
+                                                     const CDeepracerAssetBuilder& c_builder) const;
+
+        /**
+         * Returns the directory set in the ARGOS_DEEPRACER_CACHE environment
+         * variable, or an empty string.
+         */
+        static std::string GetDefaultDirectory();
+
+    private:
+
+        std::shared_ptr<const CDeepracerAsset> Map(const std::string& str_path,
+                                                   const CDeepracerAssetKey& c_key) const;
+
+    private:
+
+        std::string m_strDirectory;
+    };
+
+}
+
+#endif
@@ -0,0 +1,73 @@
+#include "deepracer_batch_controller.h"
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerBatchController::CDeepracerBatchController() :
+        m_pcLIDAR(NULL),
+        m_pcIMU(NULL),
+        m_pcSteering(NULL),
+        m_pfObservation(NULL) {}
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerBatchController::Init(TConfigurationNode& t_tree) {
+        try {
+            m_pcLIDAR    = GetSensor<CCI_DeepracerLIDARSensor>("deepracer_lidar");
+            m_pcIMU      = GetSensor<CCI_DeepracerIMUSensor>("deepracer_imu");
+            m_pcSteering = GetActuator<CCI_AckermannSteeringActuator>("ackermann_steering");
+        } catch (CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("The DeepRacer batch controller needs the deepracer_lidar and deepracer_imu sensors and the ackermann_steering actuator", ex);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerBatchController::ControlStep() {
+        /* The sensors have just been updated after the physics step */
+        WriteObservation();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerBatchController::Reset() {
+        SetAction(0.0, 0.0);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerBatchController::SetAction(Real f_steering_angle,
+                                              Real f_throttle_speed) {
+        m_pcSteering->SetSteeringAndThrottle(f_steering_angle, f_throttle_speed);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerBatchController::WriteObservation() {
+        if (m_pfObservation == NULL) return;
+        float* pfValue = m_pfObservation;
+        for (UInt32 i = 0; i < m_pcLIDAR->GetNumReadings(); ++i) {
+            *pfValue++ = m_pcLIDAR->GetReading(i);
+        }
+        const CCI_DeepracerIMUSensor::SReading& sIMU = m_pcIMU->GetReading();
+        *pfValue++ = sIMU.AngVelocity.GetX();
+        *pfValue++ = sIMU.AngVelocity.GetY();
+        *pfValue++ = sIMU.AngVelocity.GetZ();
+        *pfValue++ = sIMU.LinAcceleration.GetX();
+        *pfValue++ = sIMU.LinAcceleration.GetY();
+        *pfValue++ = sIMU.LinAcceleration.GetZ();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    REGISTER_CONTROLLER(CDeepracerBatchController, "deepracer_batch_controller");
+
+}
@@ -0,0 +1,78 @@
+#ifndef DEEPRACER_BATCH_CONTROLLER_H
+#define DEEPRACER_BATCH_CONTROLLER_H
+
+namespace argos {
+    class CDeepracerBatchController;
+}
+
+#include <argos3/core/control_interface/ci_controller.h>
+#include <argos3/plugins/robots/deepracer/control_interface/ci_ackermann_steering_actuator.h>
+#include <argos3/plugins/robots/deepracer/control_interface/ci_deepracer_imu_sensor.h>
+#include <argos3/plugins/robots/deepracer/control_interface/ci_deepracer_lidar_sensor.h>
+
+namespace argos {
+
+    /**
+     * The controller of the DeepRacers stepped by a CDeepracerBatchEnvironment.
+     *
+     * It takes no decision: the environment sets its steering and throttle
+     * before each step, and at the end of the step it writes the readings of
+     * its sensors into the row of the observation buffer it was given.
+     * A row holds the LIDAR ranges, then the IMU angular velocity (X,Y,Z) and
+     * linear acceleration (X,Y,Z), as 32-bit floats.
+     */
+    class CDeepracerBatchController : public CCI_Controller {
+    public:
+
+        /** Number of IMU values at the end of an observation */
+        static const UInt32 IMU_SIZE = 6;
+
+    public:
+
+        CDeepracerBatchController();
+
+        virtual ~CDeepracerBatchController() {}
+
+        virtual void Init(TConfigurationNode& t_tree);
+
+        virtual void ControlStep();
+
+        virtual void Reset();
+
+        /**
+         * Returns the number of floats in an observation.
+         */
+        inline UInt32 GetObservationSize() const {
+            return m_pcLIDAR->GetNumReadings() + IMU_SIZE;
+        }
+
+        /**
+         * Sets where the observations are written, NULL to stop writing them.
+         * The row must hold GetObservationSize() floats.
+         */
+        inline void SetObservation(float* pf_observation) {
+            m_pfObservation = pf_observation;
+        }
+
+        /**
+         * Sets the command applied during the next step.
+         */
+        void SetAction(Real f_steering_angle,
+                       Real f_throttle_speed);
+
+        /**
+         * Writes the current readings into the observation row, if any.
+         */
+        void WriteObservation();
+
+    private:
+
+        CCI_DeepracerLIDARSensor*      m_pcLIDAR;
+        CCI_DeepracerIMUSensor*        m_pcIMU;
+        CCI_AckermannSteeringActuator* m_pcSteering;
+        float*                         m_pfObservation;
+    };
+
+}
+
+#endif
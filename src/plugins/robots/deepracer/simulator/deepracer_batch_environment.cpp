@@ -0,0 +1,205 @@
+#include "deepracer_batch_environment.h"
+
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+
+#include <algorithm>
+
+#include "deepracer_batch_controller.h"
+#include "deepracer_entity.h"
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    /* Whether a batch environment owns the simulator */
+    static bool s_bEnvironmentExists = false;
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerBatchEnvironment::CDeepracerBatchEnvironment(const std::string& str_experiment_file) :
+        m_unObservationSize(0) {
+        if (s_bEnvironmentExists) {
+            THROW_ARGOSEXCEPTION("A DeepRacer batch environment already exists in this process");
+        }
+        CSimulator& cSimulator = CSimulator::GetInstance();
+        try {
+            CDynamicLoading::LoadAllLibraries();
+            cSimulator.SetExperimentFileName(str_experiment_file);
+            cSimulator.LoadExperiment();
+        } catch (CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("Error loading the experiment of the DeepRacer batch environment", ex);
+        }
+        s_bEnvironmentExists = true;
+        try {
+            /* The environments, sorted by id as in the snapshot */
+            std::vector<CDeepracerEntity*> vecRobots = CDeepracerEntity::CollectDeepracers();
+            for (size_t i = 0; i < vecRobots.size(); ++i) {
+                CDeepracerEntity& cRobot = *vecRobots[i];
+                CDeepracerBatchController* pcController =
+                    dynamic_cast<CDeepracerBatchController*>(&cRobot.GetControllableEntity().GetController());
+                if (pcController == NULL) {
+                    THROW_ARGOSEXCEPTION("DeepRacer \"" << cRobot.GetId() << "\" is not driven by a deepracer_batch_controller");
+                }
+                if (!m_vecControllers.empty() && pcController->GetObservationSize() != m_unObservationSize) {
+                    THROW_ARGOSEXCEPTION("DeepRacer \"" << cRobot.GetId() << "\" has " << pcController->GetObservationSize()
+                                         << " values per observation, the others have " << m_unObservationSize);
+                }
+                m_unObservationSize = pcController->GetObservationSize();
+                m_vecControllers.push_back(pcController);
+            }
+            if (m_vecControllers.empty()) {
+                THROW_ARGOSEXCEPTION("The experiment has no DeepRacer");
+            }
+            m_cInitialState.Capture();
+            m_vecObservations.assign(m_vecControllers.size() * m_unObservationSize, 0.0f);
+            m_vecActions.assign(m_vecControllers.size() * ACTION_SIZE, 0.0f);
+            for (size_t i = 0; i < m_vecControllers.size(); ++i) {
+                m_vecControllers[i]->SetObservation(&m_vecObservations[i * m_unObservationSize]);
+            }
+        } catch (CARGoSException& ex) {
+            cSimulator.Destroy();
+            s_bEnvironmentExists = false;
+            THROW_ARGOSEXCEPTION_NESTED("Error creating the DeepRacer batch environment", ex);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerBatchEnvironment::~CDeepracerBatchEnvironment() {
+        for (size_t i = 0; i < m_vecControllers.size(); ++i) {
+            m_vecControllers[i]->SetObservation(NULL);
+        }
+        CSimulator::GetInstance().Destroy();
+        s_bEnvironmentExists = false;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerBatchEnvironment::Step(UInt32 un_steps) {
+        /*
+         * The actuators are applied at the beginning of a step, and the
+         * controllers write the observations at its end, once the sensors
+         * have seen the result of the physics.
+         */
+        for (size_t i = 0; i < m_vecControllers.size(); ++i) {
+            m_vecControllers[i]->SetAction(m_vecActions[i * ACTION_SIZE],
+                                           m_vecActions[i * ACTION_SIZE + 1]);
+        }
+        CSimulator& cSimulator = CSimulator::GetInstance();
+        for (UInt32 i = 0; i < un_steps; ++i) {
+            cSimulator.UpdateSpace();
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerBatchEnvironment::Reset() {
+        m_cInitialState.Restore();
+        std::fill(m_vecActions.begin(), m_vecActions.end(), 0.0f);
+        Step();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerBatchEnvironment::ResetEnvironment(UInt32 un_index) {
+        m_cInitialState.RestoreRobot(un_index);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    UInt32 CDeepracerBatchEnvironment::GetSimulationClock() const {
+        return CSimulator::GetInstance().GetSpace().GetSimulationClock();
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
+
+/****************************************/
+/****************************************/
+
+using namespace argos;
+
+/* Message of the last error of the C interface */
+static thread_local std::string g_strLastError;
+
+/*
+ * Runs c_call, turning exceptions into an error code.
+ */
+template <class CALL>
+static int CallBatch(CALL c_call) {
+    try {
+        c_call();
+        return 0;
+    } catch (std::exception& ex) {
+        g_strLastError = ex.what();
+        return -1;
+    }
+}
+
+static CDeepracerBatchEnvironment& ToEnvironment(void* pt_env) {
+    return *static_cast<CDeepracerBatchEnvironment*>(pt_env);
+}
+
+/****************************************/
+/****************************************/
+
+void* deepracer_batch_create(const char* pch_experiment_file) {
+    CDeepracerBatchEnvironment* pcEnv = NULL;
+    CallBatch([&] { pcEnv = new CDeepracerBatchEnvironment(pch_experiment_file); });
+    return pcEnv;
+}
+
+void deepracer_batch_destroy(void* pt_env) {
+    delete static_cast<CDeepracerBatchEnvironment*>(pt_env);
+}
+
+UInt32 deepracer_batch_num_envs(void* pt_env) {
+    return ToEnvironment(pt_env).GetNumEnvironments();
+}
+
+UInt32 deepracer_batch_observation_size(void* pt_env) {
+    return ToEnvironment(pt_env).GetObservationSize();
+}
+
+UInt32 deepracer_batch_action_size(void*) {
+    return CDeepracerBatchEnvironment::ACTION_SIZE;
+}
+
+float* deepracer_batch_observations(void* pt_env) {
+    return ToEnvironment(pt_env).GetObservations();
+}
+
+float* deepracer_batch_actions(void* pt_env) {
+    return ToEnvironment(pt_env).GetActions();
+}
+
+int deepracer_batch_step(void* pt_env, UInt32 un_steps) {
+    return CallBatch([&] { ToEnvironment(pt_env).Step(un_steps); });
+}
+
+int deepracer_batch_reset(void* pt_env) {
+    return CallBatch([&] { ToEnvironment(pt_env).Reset(); });
+}
+
+int deepracer_batch_reset_env(void* pt_env, UInt32 un_index) {
+    return CallBatch([&] { ToEnvironment(pt_env).ResetEnvironment(un_index); });
+}
+
+const char* deepracer_batch_last_error() {
+    return g_strLastError.c_str();
+}
+
+/****************************************/
+/****************************************/
@@ -0,0 +1,143 @@
+#ifndef DEEPRACER_BATCH_ENVIRONMENT_H
+#define DEEPRACER_BATCH_ENVIRONMENT_H
+
+namespace argos {
+    class CDeepracerBatchController;
+    class CDeepracerBatchEnvironment;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <string>
+#include <vector>
+
+#include "deepracer_snapshot.h"
+
+namespace argos {
+
+    /**
+     * Steps many DeepRacer environments together, for reinforcement learning.
+     *
+     * An environment is a DeepRacer driven by a deepracer_batch_controller;
+     * all of them live in the experiment loaded by the constructor, ordered
+     * by id, and are stepped by a single ARGoS simulation, so the threads set
+     * in <system threads="N"/> run their sensors, controllers and physics in
+     * parallel. Robots that must not interact can be placed in separate areas
+     * or physics engines.
+     *
+     * The environment owns two contiguous float buffers that can be shared
+     * without copies: the observations, one row of GetObservationSize()
+     * values per environment (see CDeepracerBatchController), and the
+     * actions, one (steering angle in radians, throttle in cm/s) pair per
+     * environment. Step() applies the actions and fills the observations.
+     *
+     * ARGoS has one simulator per process, so there can be only one batch
+     * environment at a time.
+     */
+    class CDeepracerBatchEnvironment {
+    public:
+
+        /** Floats per action: steering angle, throttle */
+        static const UInt32 ACTION_SIZE = 2;
+
+    public:
+
+        /**
+         * Loads the experiment and collects its environments.
+         * @throws CARGoSException if the experiment can't be loaded, has no
+         * DeepRacer with a deepracer_batch_controller, or another batch
+         * environment exists.
+         */
+        explicit CDeepracerBatchEnvironment(const std::string& str_experiment_file);
+
+        ~CDeepracerBatchEnvironment();
+
+        /**
+         * Applies the actions, then runs the given number of simulation steps.
+         * The observations are those of the last step.
+         */
+        void Step(UInt32 un_steps = 1);
+
+        /**
+         * Puts all the environments back in their initial state, then runs one
+         * step with zero actions to fill the observations.
+         */
+        void Reset();
+
+        /**
+         * Puts one environment back in its initial state, without touching the
+         * others. Its observations are refreshed by the next Step().
+         */
+        void ResetEnvironment(UInt32 un_index);
+
+        inline UInt32 GetNumEnvironments() const {
+            return m_vecControllers.size();
+        }
+
+        inline UInt32 GetObservationSize() const {
+            return m_unObservationSize;
+        }
+
+        inline float* GetObservations() {
+            return m_vecObservations.data();
+        }
+
+        inline float* GetActions() {
+            return m_vecActions.data();
+        }
+
+        /**
+         * Returns the id of the robot of an environment.
+         */
+        inline const std::string& GetRobotId(UInt32 un_index) const {
+            return m_cInitialState.GetRobotIds()[un_index];
+        }
+
+        UInt32 GetSimulationClock() const;
+
+    private:
+
+        std::vector<CDeepracerBatchController*> m_vecControllers;
+        UInt32                                  m_unObservationSize;
+        std::vector<float>                      m_vecObservations;
+        std::vector<float>                      m_vecActions;
+        CDeepracerSnapshot                      m_cInitialState;
+    };
+
+}
+
+/*
+ * C interface, to load the library with ctypes or any FFI.
+ *
+ * Functions returning int return 0 on success and -1 on error; those
+ * returning pointers return NULL on error. The error message is then
+ * available through deepracer_batch_last_error(). The observation and action
+ * buffers stay valid until deepracer_batch_destroy().
+ */
+extern "C" {
+
+    void* deepracer_batch_create(const char* pch_experiment_file);
+
+    void deepracer_batch_destroy(void* pt_env);
+
+    argos::UInt32 deepracer_batch_num_envs(void* pt_env);
+
+    argos::UInt32 deepracer_batch_observation_size(void* pt_env);
+
+    argos::UInt32 deepracer_batch_action_size(void* pt_env);
+
+    float* deepracer_batch_observations(void* pt_env);
+
+    float* deepracer_batch_actions(void* pt_env);
+
+    int deepracer_batch_step(void* pt_env, argos::UInt32 un_steps);
+
+    int deepracer_batch_reset(void* pt_env);
+
+    int deepracer_batch_reset_env(void* pt_env, argos::UInt32 un_index);
+
+    const char* deepracer_batch_last_error();
+
+}
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef DEEPRACER_BUFFER_QUEUE_H
+#define DEEPRACER_BUFFER_QUEUE_H
+
+namespace argos {
+    template <class BUFFER> class CDeepracerBufferQueue;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace argos {
+
+    /**
+     * A fixed set of preallocated buffers handed between a producer and
+     * background writer threads.
+     *
+     * The producer takes a free buffer, fills it and queues it; the writers
+     * pass each queued buffer to the write function and put it back in the
+     * free list. Acquire() only waits when all the buffers are queued or
+     * being written; TryAcquire() returns NULL instead, for producers that
+     * would rather drop data than wait. Stop() writes everything queued
+     * before returning.
+     */
+    template <class BUFFER>
+    class CDeepracerBufferQueue {
+    public:
+
+        typedef std::function<void(BUFFER&)> TFunction;
+
+    public:
+
+        CDeepracerBufferQueue() :
+            m_bStop(false) {}
+
+        ~CDeepracerBufferQueue() {
+            Stop();
+        }
+
+        /**
+         * Allocates the buffers and starts the writers.
+         * @param un_buffers the number of buffers.
+         * @param un_writers the number of writer threads.
+         * @param c_write writes a buffer; called by the writer threads.
+         * @param c_prepare if set, called once on each buffer before starting, to preallocate it.
+         */
+        void Start(UInt32 un_buffers,
+                   UInt32 un_writers,
+                   const TFunction& c_write,
+                   const TFunction& c_prepare = TFunction()) {
+            Stop();
+            m_cWrite = c_write;
+            m_vecBuffers.clear();
+            m_vecBuffers.resize(un_buffers);
+            m_deqQueued.clear();
+            m_vecFree.clear();
+            for (size_t i = 0; i < m_vecBuffers.size(); ++i) {
+                if (c_prepare) c_prepare(m_vecBuffers[i]);
+                m_vecFree.push_back(&m_vecBuffers[i]);
+            }
+            m_bStop = false;
+            for (UInt32 i = 0; i < un_writers; ++i) {
+                m_vecWriters.push_back(std::thread(&CDeepracerBufferQueue::Work, this));
+            }
+        }
+
+        /**
+         * Writes the queued buffers and stops the writers.
+         */
+        void Stop() {
+            if (m_vecWriters.empty()) return;
+            {
+                std::lock_guard<std::mutex> cLock(m_cMutex);
+                m_bStop = true;
+            }
+            m_cQueued.notify_all();
+            for (size_t i = 0; i < m_vecWriters.size(); ++i) {
+                m_vecWriters[i].join();
+            }
+            m_vecWriters.clear();
+        }
+
+        inline bool IsRunning() const {
+            return !m_vecWriters.empty();
+        }
+
+        /**
+         * Returns a free buffer, waiting for the writers if there is none.
+         */
+        BUFFER* Acquire() {
+            std::unique_lock<std::mutex> cLock(m_cMutex);
+            m_cFreed.wait(cLock, [this] { return !m_vecFree.empty(); });
+            BUFFER* psBuffer = m_vecFree.back();
+            m_vecFree.pop_back();
+            return psBuffer;
+        }
+
+        /**
+         * Returns a free buffer, or NULL if there is none.
+         */
+        BUFFER* TryAcquire() {
+            std::lock_guard<std::mutex> cLock(m_cMutex);
+            if (m_vecFree.empty()) return NULL;
+            BUFFER* psBuffer = m_vecFree.back();
+            m_vecFree.pop_back();
+            return psBuffer;
+        }
+
+        /**
+         * Hands a buffer to the writers.
+         */
+        void Queue(BUFFER* ps_buffer) {
+            {
+                std::lock_guard<std::mutex> cLock(m_cMutex);
+                m_deqQueued.push_back(ps_buffer);
+            }
+            m_cQueued.notify_one();
+        }
+
+        /**
+         * Puts a buffer back in the free list without writing it.
+         */
+        void Release(BUFFER* ps_buffer) {
+            {
+                std::lock_guard<std::mutex> cLock(m_cMutex);
+                m_vecFree.push_back(ps_buffer);
+            }
+            m_cFreed.notify_one();
+        }
+
+    private:
+
+        void Work() {
+            std::unique_lock<std::mutex> cLock(m_cMutex);
+            while (true) {
+                m_cQueued.wait(cLock, [this] { return m_bStop || !m_deqQueued.empty(); });
+                /* Write everything queued before stopping */
+                if (m_deqQueued.empty()) return;
+                BUFFER* psBuffer = m_deqQueued.front();
+                m_deqQueued.pop_front();
+                cLock.unlock();
+                m_cWrite(*psBuffer);
+                cLock.lock();
+                m_vecFree.push_back(psBuffer);
+                m_cFreed.notify_one();
+            }
+        }
+
+    private:
+
+        TFunction                m_cWrite;
+        /** The buffers: being filled, queued or free */
+        std::vector<BUFFER>      m_vecBuffers;
+        std::deque<BUFFER*>      m_deqQueued;
+        std::vector<BUFFER*>     m_vecFree;
+        std::mutex               m_cMutex;
+        std::condition_variable  m_cQueued;
+        std::condition_variable  m_cFreed;
+        bool                     m_bStop;
+        std::vector<std::thread> m_vecWriters;
+    };
+
+}
+
+#endif
@@ -0,0 +1,307 @@
+#include "deepracer_camera_default_sensor.h"
+
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/plugins/simulator/entities/led_entity.h>
+#include <argos3/plugins/simulator/media/led_medium.h>
+
+#include "deepracer_measures.h"
+#include "deepracer_track_entity.h"
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    /* Closest depth a point can be seen at [m] */
+    static const Real CAMERA_NEAR_PLANE = 0.01;
+
+    /* An obstacle closer than this to the LED is taken as the LED's own surface [m] */
+    static const Real OCCLUSION_TOLERANCE = 0.02;
+
+    /****************************************/
+    /****************************************/
+
+    /**
+     * Projects the LEDs found in the range of the camera.
+     */
+    class CDeepracerCameraLEDCheckOperation : public CPositionalIndex<CLEDEntity>::COperation {
+    public:
+
+        CDeepracerCameraLEDCheckOperation(std::vector<CLEDEntity*>& vec_leds) :
+            m_vecLEDs(vec_leds) {}
+
+        virtual bool operator()(CLEDEntity& c_led) {
+            /* Switched off LEDs are not seen */
+            if (c_led.GetColor() != CColor::BLACK) {
+                m_vecLEDs.push_back(&c_led);
+            }
+            return true;
+        }
+
+    private:
+
+        std::vector<CLEDEntity*>& m_vecLEDs;
+    };
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerCameraDefaultSensor::CDeepracerCameraDefaultSensor() : m_pcEmbodiedEntity(NULL),
+                                                                     m_pcControllableEntity(NULL),
+                                                                     m_pcLEDMedium(NULL),
+                                                                     m_cOffset(DEEPRACER_LEFT_CAMERA_SENSORS_POS_WRT_BASE),
+                                                                     m_fFocalLength(0.0),
+                                                                     m_fRange(3.0),
+                                                                     m_fLEDRadius(0.01),
+                                                                     m_bCheckOcclusions(true),
+                                                                     m_bShowRays(false),
+                                                                     m_cSpace(CSimulator::GetInstance().GetSpace()) {
+        m_unWidth  = 160;
+        m_unHeight = 120;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCameraDefaultSensor::SetRobot(CComposableEntity& c_entity) {
+        try {
+            m_pcEmbodiedEntity     = &(c_entity.GetComponent<CEmbodiedEntity>("body"));
+            m_pcControllableEntity = &(c_entity.GetComponent<CControllableEntity>("controller"));
+        } catch (CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("Can't set robot for the Deepracer camera default sensor", ex);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCameraDefaultSensor::Init(TConfigurationNode& t_tree) {
+        try {
+            CCI_DeepracerCameraSensor::Init(t_tree);
+            /* Which camera? */
+            std::string strCamera = "left";
+            GetNodeAttributeOrDefault(t_tree, "camera", strCamera, strCamera);
+            if (strCamera == "left") {
+                m_cOffset = DEEPRACER_LEFT_CAMERA_SENSORS_POS_WRT_BASE;
+            } else if (strCamera == "right") {
+                m_cOffset = DEEPRACER_RIGHT_CAMERA_SENSORS_POS_WRT_BASE;
+            } else {
+                THROW_ARGOSEXCEPTION("Unknown camera \"" << strCamera << "\", expected \"left\" or \"right\"");
+            }
+            /* Image and optics */
+            GetNodeAttributeOrDefault(t_tree, "width", m_unWidth, m_unWidth);
+            GetNodeAttributeOrDefault(t_tree, "height", m_unHeight, m_unHeight);
+            CDegrees cFOV(120.0);
+            GetNodeAttributeOrDefault(t_tree, "fov", cFOV, cFOV);
+            if (m_unWidth == 0 || m_unHeight == 0) {
+                THROW_ARGOSEXCEPTION("The image size must be positive");
+            }
+            if (cFOV.GetValue() <= 0.0 || cFOV.GetValue() >= 180.0) {
+                THROW_ARGOSEXCEPTION("The field of view must be in (0,180) degrees");
+            }
+            m_fFocalLength = 0.5 * m_unWidth / Tan(ToRadians(cFOV * 0.5));
+            GetNodeAttributeOrDefault(t_tree, "range", m_fRange, m_fRange);
+            GetNodeAttributeOrDefault(t_tree, "led_radius", m_fLEDRadius, m_fLEDRadius);
+            GetNodeAttributeOrDefault(t_tree, "check_occlusions", m_bCheckOcclusions, m_bCheckOcclusions);
+            GetNodeAttributeOrDefault(t_tree, "show_rays", m_bShowRays, m_bShowRays);
+            /* LED medium */
+            std::string strMedium;
+            GetNodeAttribute(t_tree, "medium", strMedium);
+            m_pcLEDMedium = &CSimulator::GetInstance().GetMedium<CLEDMedium>(strMedium);
+        } catch (CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("Initialization error in default camera sensor", ex);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCameraDefaultSensor::Update() {
+        m_tBlobs.clear();
+        /* Camera pose */
+        const SAnchor& sOrigin = m_pcEmbodiedEntity->GetOriginAnchor();
+        m_cPosition = m_cOffset;
+        m_cPosition.Rotate(sOrigin.Orientation);
+        m_cPosition += sOrigin.Position;
+        m_cInvOrientation = sOrigin.Orientation.Inverse();
+        /* Tracks can hide LEDs too */
+        m_vecTracks.clear();
+        CSpace::TMapPerTypePerId& tEntities = m_cSpace.GetEntityMapPerTypePerId();
+        CSpace::TMapPerTypePerId::iterator itTracks = tEntities.find("deepracer_track");
+        if (itTracks != tEntities.end()) {
+            for (CSpace::TMapPerType::iterator it = itTracks->second.begin();
+                 it != itTracks->second.end();
+                 ++it) {
+                m_vecTracks.push_back(any_cast<CDeepracerTrackEntity*>(it->second));
+            }
+        }
+        /* LEDs within range */
+        std::vector<CLEDEntity*> vecLEDs;
+        CDeepracerCameraLEDCheckOperation cOperation(vecLEDs);
+        m_pcLEDMedium->GetIndex().ForEntitiesInBoxRange(m_cPosition,
+                                                        CVector3(m_fRange, m_fRange, m_fRange),
+                                                        cOperation);
+        /* Project them */
+        CVector2 cPixel;
+        Real fDepth;
+        for (size_t i = 0; i < vecLEDs.size(); ++i) {
+            const CVector3& cLEDPos = vecLEDs[i]->GetPosition();
+            if (!Project(cLEDPos, cPixel, fDepth)) continue;
+            if ((cLEDPos - m_cPosition).Length() > m_fRange) continue;
+            if (m_bCheckOcclusions && IsOccluded(cLEDPos)) continue;
+            Real fRadius = m_fFocalLength * m_fLEDRadius / fDepth;
+            CVector2 cMin(Max<Real>(cPixel.GetX() - fRadius, 0.0),
+                          Max<Real>(cPixel.GetY() - fRadius, 0.0));
+            CVector2 cMax(Min<Real>(cPixel.GetX() + fRadius, m_unWidth - 1),
+                          Min<Real>(cPixel.GetY() + fRadius, m_unHeight - 1));
+            AddBlob(vecLEDs[i]->GetColor(), cMin, cMax);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCameraDefaultSensor::Reset() {
+        m_tBlobs.clear();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    bool CDeepracerCameraDefaultSensor::Project(const CVector3& c_point,
+                                                CVector2& c_pixel,
+                                                Real& f_depth) const {
+        /* To the camera frame: X forward, Y left, Z up */
+        CVector3 cLocal = c_point - m_cPosition;
+        cLocal.Rotate(m_cInvOrientation);
+        if (cLocal.GetX() < CAMERA_NEAR_PLANE) return false;
+        f_depth = cLocal.GetX();
+        /* Image coordinates grow rightwards and downwards */
+        c_pixel.Set(0.5 * m_unWidth  - m_fFocalLength * cLocal.GetY() / f_depth,
+                    0.5 * m_unHeight - m_fFocalLength * cLocal.GetZ() / f_depth);
+        return
+            c_pixel.GetX() >= 0.0 && c_pixel.GetX() < m_unWidth &&
+            c_pixel.GetY() >= 0.0 && c_pixel.GetY() < m_unHeight;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    bool CDeepracerCameraDefaultSensor::IsOccluded(const CVector3& c_point) {
+        CRay3 cRay(m_cPosition, c_point);
+        Real fLength = cRay.GetLength();
+        /* Anything farther than this along the ray is the LED's own support */
+        Real fMaxT = 1.0 - OCCLUSION_TOLERANCE / fLength;
+        bool bOccluded = false;
+        Real fHitT = 1.0;
+        if (fMaxT > 0.0) {
+            for (size_t i = 0; i < m_vecTracks.size() && !bOccluded; ++i) {
+                Real fT;
+                if (m_vecTracks[i]->IntersectRay(cRay, fT) && fT < fMaxT) {
+                    bOccluded = true;
+                    fHitT     = fT;
+                }
+            }
+            SEmbodiedEntityIntersectionItem sIntersection;
+            if (!bOccluded &&
+                GetClosestEmbodiedEntityIntersectedByRay(sIntersection, cRay, *m_pcEmbodiedEntity) &&
+                sIntersection.TOnRay < fMaxT) {
+                bOccluded = true;
+                fHitT     = sIntersection.TOnRay;
+            }
+        }
+        if (m_bShowRays) {
+            if (bOccluded) {
+                m_pcControllableEntity->AddIntersectionPoint(cRay, fHitT);
+            }
+            m_pcControllableEntity->AddCheckedRay(bOccluded, cRay);
+        }
+        return bOccluded;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCameraDefaultSensor::AddBlob(const CColor& c_color,
+                                                const CVector2& c_min,
+                                                const CVector2& c_max) {
+        /* LEDs of the same color that overlap in the image form a single region */
+        for (size_t i = 0; i < m_tBlobs.size(); ++i) {
+            SBlob& sBlob = m_tBlobs[i];
+            if (sBlob.Color == c_color &&
+                sBlob.Min.GetX() <= c_max.GetX() && c_min.GetX() <= sBlob.Max.GetX() &&
+                sBlob.Min.GetY() <= c_max.GetY() && c_min.GetY() <= sBlob.Max.GetY()) {
+                sBlob.Min.Set(Min(sBlob.Min.GetX(), c_min.GetX()), Min(sBlob.Min.GetY(), c_min.GetY()));
+                sBlob.Max.Set(Max(sBlob.Max.GetX(), c_max.GetX()), Max(sBlob.Max.GetY(), c_max.GetY()));
+                return;
+            }
+        }
+        m_tBlobs.push_back(SBlob(c_color, c_min));
+        m_tBlobs.back().Max = c_max;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    REGISTER_SENSOR(CDeepracerCameraDefaultSensor,
+                    "deepracer_camera", "default",
+                    "Khai Yi Chin [khaiyichin@gmail.com]",
+                    "1.0",
+                    "The AWS DeepRacer camera, as a blob detector.",
+                    "This sensor returns the colored blobs seen by one of the AWS DeepRacer\n"
+                    "cameras. No image is rendered: the LEDs within range are projected into the\n"
+                    "image with a pinhole model and those hidden by bodies or track walls are\n"
+                    "discarded. Each visible LED becomes a blob sized after its apparent size, and\n"
+                    "overlapping blobs of the same color are merged, as a blob detector would do on\n"
+                    "a real image. GetPixels() returns NULL. In controllers, you must include the\n"
+                    "ci_deepracer_camera_sensor.h header.\n\n"
+                    "REQUIRED XML CONFIGURATION\n\n"
+                    "  <controllers>\n"
+                    "    ...\n"
+                    "    <my_controller ...>\n"
+                    "      ...\n"
+                    "      <sensors>\n"
+                    "        ...\n"
+                    "        <deepracer_camera implementation=\"default\"\n"
+                    "                          medium=\"leds\" />\n"
+                    "        ...\n"
+                    "      </sensors>\n"
+                    "      ...\n"
+                    "    </my_controller>\n"
+                    "    ...\n"
+                    "  </controllers>\n\n"
+                    "The 'medium' attribute must be set to the id of the LED medium declared in the\n"
+                    "<media> section.\n\n"
+                    "OPTIONAL XML CONFIGURATION\n\n"
+                    "The 'camera' attribute selects the 'left' (default) or 'right' camera. The\n"
+                    "'width' and 'height' attributes set the image size in pixels (default 160x120)\n"
+                    "and 'fov' the horizontal field of view in degrees (default 120). LEDs farther\n"
+                    "than 'range' meters (default 3) are not seen. The 'led_radius' attribute sets\n"
+                    "the radius of an LED in meters (default 0.01), which gives the size of its\n"
+                    "blob. Occlusion checks can be turned off with 'check_occlusions=\"false\"', and\n"
+                    "the occlusion rays can be drawn in the OpenGL visualization with\n"
+                    "'show_rays=\"true\"':\n\n"
+                    "  <controllers>\n"
+                    "    ...\n"
+                    "    <my_controller ...>\n"
+                    "      ...\n"
+                    "      <sensors>\n"
+                    "        ...\n"
+                    "        <deepracer_camera implementation=\"default\"\n"
+                    "                          medium=\"leds\"\n"
+                    "                          camera=\"right\"\n"
+                    "                          width=\"320\"\n"
+                    "                          height=\"240\"\n"
+                    "                          fov=\"90\"\n"
+                    "                          range=\"5\"\n"
+                    "                          show_rays=\"true\" />\n"
+                    "        ...\n"
+                    "      </sensors>\n"
+                    "      ...\n"
+                    "    </my_controller>\n"
+                    "    ...\n"
+                    "  </controllers>\n\n",
+                    "Usable");
+
+}
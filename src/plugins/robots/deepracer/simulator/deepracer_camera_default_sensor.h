@@ -0,0 +1,120 @@
+#ifndef DEEPRACER_CAMERA_DEFAULT_SENSOR_H
+#define DEEPRACER_CAMERA_DEFAULT_SENSOR_H
+
+#include <string>
+#include <vector>
+
+namespace argos {
+    class CDeepracerCameraDefaultSensor;
+    class CDeepracerTrackEntity;
+    class CLEDMedium;
+    class CLEDEntity;
+}
+
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/sensor.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/plugins/robots/deepracer/control_interface/ci_deepracer_camera_sensor.h>
+
+namespace argos {
+
+    /**
+     * A camera that outputs blobs without rendering images.
+     *
+     * The LEDs within range are projected into the image plane of a pinhole
+     * camera placed at one of the DeepRacer cameras; the visible ones become
+     * blobs, sized after the apparent size of the LED. Occlusions are checked
+     * with a ray from the camera to each LED.
+     */
+    class CDeepracerCameraDefaultSensor : public CCI_DeepracerCameraSensor,
+                                          public CSimulatedSensor {
+    public:
+
+        CDeepracerCameraDefaultSensor();
+
+        virtual ~CDeepracerCameraDefaultSensor() {}
+
+        virtual void SetRobot(CComposableEntity& c_entity);
+
+        virtual void Init(TConfigurationNode& t_tree);
+
+        virtual void Update();
+
+        virtual void Reset();
+
+        /**
+         * No image is rendered: always returns NULL.
+         */
+        virtual const unsigned char* GetPixels() const {
+            return NULL;
+        }
+
+        /**
+         * Projects a point in the global frame into the image.
+         * @param c_point the point.
+         * @param c_pixel the pixel coordinates, (0,0) being the top left corner.
+         * @param f_depth the distance along the optical axis.
+         * @return false if the point is behind the camera or outside the image.
+         */
+        bool Project(const CVector3& c_point,
+                     CVector2& c_pixel,
+                     Real& f_depth) const;
+
+    private:
+
+        /**
+         * Returns true if something lies between the camera and c_point.
+         */
+        bool IsOccluded(const CVector3& c_point);
+
+        /**
+         * Adds a blob, merging it with an overlapping blob of the same color.
+         */
+        void AddBlob(const CColor& c_color,
+                     const CVector2& c_min,
+                     const CVector2& c_max);
+
+    private:
+
+        /** Reference to embodied entity associated to this sensor */
+        CEmbodiedEntity* m_pcEmbodiedEntity;
+
+        /** Reference to controllable entity associated to this sensor */
+        CControllableEntity* m_pcControllableEntity;
+
+        /** The medium the LEDs are taken from */
+        CLEDMedium* m_pcLEDMedium;
+
+        /** Camera position with respect to the base */
+        CVector3 m_cOffset;
+
+        /** Camera pose in the global frame, updated at each step */
+        CVector3    m_cPosition;
+        CQuaternion m_cInvOrientation;
+
+        /** Focal length in pixels */
+        Real m_fFocalLength;
+
+        /** Farthest visible distance [m] */
+        Real m_fRange;
+
+        /** Radius of an LED, for the size of its blob [m] */
+        Real m_fLEDRadius;
+
+        /** Whether LEDs hidden by bodies or walls are discarded */
+        bool m_bCheckOcclusions;
+
+        /** Flag to show the occlusion rays in the simulator */
+        bool m_bShowRays;
+
+        /** Reference to the space */
+        CSpace& m_cSpace;
+
+        /** Tracks in the space, checked for occlusions through their BVH */
+        std::vector<CDeepracerTrackEntity*> m_vecTracks;
+    };
+
+}
+
+#endif
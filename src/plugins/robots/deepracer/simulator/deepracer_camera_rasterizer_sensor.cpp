@@ -0,0 +1,173 @@
+#include "deepracer_camera_rasterizer_sensor.h"
+
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/simulator/simulator.h>
+
+#include "deepracer_measures.h"
+#include "deepracer_raster_scene.h"
+#include "deepracer_thread_pool.h"
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerCameraRasterizerSensor::CDeepracerCameraRasterizerSensor() : m_pcRobot(NULL),
+                                                                           m_pcEmbodiedEntity(NULL),
+                                                                           m_cOffset(DEEPRACER_LEFT_CAMERA_SENSORS_POS_WRT_BASE),
+                                                                           m_pcPool(NULL) {
+        m_unWidth  = 160;
+        m_unHeight = 120;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCameraRasterizerSensor::SetRobot(CComposableEntity& c_entity) {
+        try {
+            m_pcRobot          = &c_entity;
+            m_pcEmbodiedEntity = &(c_entity.GetComponent<CEmbodiedEntity>("body"));
+        } catch (CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("Can't set robot for the Deepracer camera rasterizer sensor", ex);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCameraRasterizerSensor::Init(TConfigurationNode& t_tree) {
+        try {
+            CCI_DeepracerCameraSensor::Init(t_tree);
+            /* Which camera? */
+            std::string strCamera = "left";
+            GetNodeAttributeOrDefault(t_tree, "camera", strCamera, strCamera);
+            if (strCamera == "left") {
+                m_cOffset = DEEPRACER_LEFT_CAMERA_SENSORS_POS_WRT_BASE;
+            } else if (strCamera == "right") {
+                m_cOffset = DEEPRACER_RIGHT_CAMERA_SENSORS_POS_WRT_BASE;
+            } else {
+                THROW_ARGOSEXCEPTION("Unknown camera \"" << strCamera << "\", expected \"left\" or \"right\"");
+            }
+            /* Image and optics */
+            GetNodeAttributeOrDefault(t_tree, "width", m_unWidth, m_unWidth);
+            GetNodeAttributeOrDefault(t_tree, "height", m_unHeight, m_unHeight);
+            CDegrees cFOV(120.0);
+            GetNodeAttributeOrDefault(t_tree, "fov", cFOV, cFOV);
+            Real fRange = 10.0;
+            GetNodeAttributeOrDefault(t_tree, "range", fRange, fRange);
+            UInt32 unTileSize = 16;
+            GetNodeAttributeOrDefault(t_tree, "tile_size", unTileSize, unTileSize);
+            if (m_unWidth == 0 || m_unHeight == 0 || unTileSize == 0) {
+                THROW_ARGOSEXCEPTION("The image and tile sizes must be positive");
+            }
+            if (cFOV.GetValue() <= 0.0 || cFOV.GetValue() >= 180.0) {
+                THROW_ARGOSEXCEPTION("The field of view must be in (0,180) degrees");
+            }
+            m_pcRasterizer.reset(
+                new CDeepracerSoftwareRasterizer(m_unWidth,
+                                                 m_unHeight,
+                                                 0.5 * m_unWidth / Tan(ToRadians(cFOV * 0.5)),
+                                                 fRange,
+                                                 unTileSize));
+            /* Threads filling the tiles */
+            UInt32 unThreads = 0;
+            GetNodeAttributeOrDefault(t_tree, "threads", unThreads, unThreads);
+            if (unThreads > 1) {
+                /* All the cameras share the pool, and its loops are serialized:
+                   with ARGoS threads, the cameras would wait for each other */
+                if (CSimulator::GetInstance().GetNumThreads() > 0) {
+                    THROW_ARGOSEXCEPTION("'threads' greater than 1 requires <system threads=\"0\" />; with ARGoS threads, the cameras are already rendered in parallel");
+                }
+                m_pcPool = &CDeepracerThreadPool::GetShared(unThreads);
+            }
+        } catch (CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("Initialization error in rasterizer camera sensor", ex);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCameraRasterizerSensor::Update() {
+        const SAnchor& sOrigin = m_pcEmbodiedEntity->GetOriginAnchor();
+        CVector3 cPosition = m_cOffset;
+        cPosition.Rotate(sOrigin.Orientation);
+        cPosition += sOrigin.Position;
+        m_pcRasterizer->Render(CDeepracerRasterScene::GetShared(),
+                               cPosition,
+                               sOrigin.Orientation,
+                               m_pcRobot,
+                               m_pcPool);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCameraRasterizerSensor::Reset() {
+        CDeepracerRasterScene::InvalidateShared();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    REGISTER_SENSOR(CDeepracerCameraRasterizerSensor,
+                    "deepracer_camera", "rasterizer",
+                    "Khai Yi Chin [khaiyichin@gmail.com]",
+                    "1.0",
+                    "The AWS DeepRacer camera, rendered on the CPU.",
+                    "This sensor returns the RGB images of one of the AWS DeepRacer cameras,\n"
+                    "rendered by a software rasterizer: no GPU or display is needed. The arena is\n"
+                    "drawn with flat-shaded triangles: the floor, the DeepRacer tracks (road,\n"
+                    "center line and walls), the DeepRacers, boxes, cylinders and the bounding\n"
+                    "boxes of the other bodies. The robot's own body is not drawn. GetPixels()\n"
+                    "returns the image as rows from top to bottom, with 3 bytes (RGB) per pixel. No\n"
+                    "blobs are computed: use the 'default' implementation for those. In\n"
+                    "controllers, you must include the ci_deepracer_camera_sensor.h header.\n\n"
+                    "REQUIRED XML CONFIGURATION\n\n"
+                    "  <controllers>\n"
+                    "    ...\n"
+                    "    <my_controller ...>\n"
+                    "      ...\n"
+                    "      <sensors>\n"
+                    "        ...\n"
+                    "        <deepracer_camera implementation=\"rasterizer\" />\n"
+                    "        ...\n"
+                    "      </sensors>\n"
+                    "      ...\n"
+                    "    </my_controller>\n"
+                    "    ...\n"
+                    "  </controllers>\n\n"
+                    "OPTIONAL XML CONFIGURATION\n\n"
+                    "The 'camera' attribute selects the 'left' (default) or 'right' camera. The\n"
+                    "'width' and 'height' attributes set the image size in pixels (default 160x120)\n"
+                    "and 'fov' the horizontal field of view in degrees (default 120). Nothing\n"
+                    "farther than 'range' meters (default 10) is drawn.\n"
+                    "The image is split in square tiles of 'tile_size' pixels (default 16). With\n"
+                    "'threads' greater than 1, the tiles are filled by a pool of that many threads\n"
+                    "shared by all the cameras, which render one at a time; this helps with large\n"
+                    "images. It requires '<system threads=\"0\" />': with ARGoS threads, the\n"
+                    "robots are already rendered in parallel and would wait for each other on the\n"
+                    "pool.\n\n"
+                    "  <controllers>\n"
+                    "    ...\n"
+                    "    <my_controller ...>\n"
+                    "      ...\n"
+                    "      <sensors>\n"
+                    "        ...\n"
+                    "        <deepracer_camera implementation=\"rasterizer\"\n"
+                    "                          camera=\"right\"\n"
+                    "                          width=\"320\"\n"
+                    "                          height=\"240\"\n"
+                    "                          fov=\"90\"\n"
+                    "                          range=\"5\"\n"
+                    "                          tile_size=\"32\"\n"
+                    "                          threads=\"8\" />\n"
+                    "        ...\n"
+                    "      </sensors>\n"
+                    "      ...\n"
+                    "    </my_controller>\n"
+                    "    ...\n"
+                    "  </controllers>\n\n",
+                    "Usable");
+
+}
@@ -0,0 +1,68 @@
+#ifndef DEEPRACER_CAMERA_RASTERIZER_SENSOR_H
+#define DEEPRACER_CAMERA_RASTERIZER_SENSOR_H
+
+namespace argos {
+    class CDeepracerCameraRasterizerSensor;
+    class CDeepracerThreadPool;
+}
+
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/sensor.h>
+#include <argos3/plugins/robots/deepracer/control_interface/ci_deepracer_camera_sensor.h>
+
+#include <memory>
+
+#include "deepracer_software_rasterizer.h"
+
+namespace argos {
+
+    /**
+     * A camera that renders RGB images on the CPU, for headless runs.
+     *
+     * The arena is converted into triangles once per step and shared by all
+     * the cameras (see CDeepracerRasterScene); each camera keeps its own
+     * rasterizer and image.
+     */
+    class CDeepracerCameraRasterizerSensor : public CCI_DeepracerCameraSensor,
+                                             public CSimulatedSensor {
+    public:
+
+        CDeepracerCameraRasterizerSensor();
+
+        virtual ~CDeepracerCameraRasterizerSensor() {}
+
+        virtual void SetRobot(CComposableEntity& c_entity);
+
+        virtual void Init(TConfigurationNode& t_tree);
+
+        virtual void Update();
+
+        virtual void Reset();
+
+        /**
+         * Returns the last image: rows from top to bottom, 3 bytes (RGB) per pixel.
+         */
+        virtual const unsigned char* GetPixels() const {
+            return m_pcRasterizer->GetPixels();
+        }
+
+    private:
+
+        /** The robot, whose own body is not drawn */
+        CComposableEntity* m_pcRobot;
+
+        /** Reference to embodied entity associated to this sensor */
+        CEmbodiedEntity* m_pcEmbodiedEntity;
+
+        /** Camera position with respect to the base */
+        CVector3 m_cOffset;
+
+        std::unique_ptr<CDeepracerSoftwareRasterizer> m_pcRasterizer;
+
+        /** Pool filling the tiles, NULL to render in the sensor's thread */
+        CDeepracerThreadPool* m_pcPool;
+    };
+
+}
+
+#endif
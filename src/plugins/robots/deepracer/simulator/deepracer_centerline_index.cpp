@@ -0,0 +1,351 @@
+#include "deepracer_centerline_index.h"
+
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <argos3/core/utility/math/angles.h>
+
+#include <cmath>
+
+#include "deepracer_track.h"
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    /* Longest walk from a hint before falling back to the grid */
+    static const UInt32 MAX_WALK_STEPS = 8;
+
+    /* Largest number of grid cells, the cells grow beyond it */
+    static const UInt32 MAX_CELLS = 1 << 22;
+
+    /* Arc length between curvature samples */
+    static const Real CURVATURE_STEP = 0.05;
+
+    /* Arc length over which the heading change gives the curvature, to smooth the waypoint corners */
+    static const Real CURVATURE_WINDOW = 0.5;
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerCenterlineIndex::CDeepracerCenterlineIndex() :
+        m_fLength(0.0),
+        m_bClosed(false),
+        m_unNumWaypoints(0),
+        m_fMargin(0.0),
+        m_fCellSize(1.0),
+        m_unCellsX(0),
+        m_unCellsY(0) {}
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCenterlineIndex::Build(const CDeepracerTrack& c_track,
+                                          Real f_cell_size) {
+        if (f_cell_size <= 0.0) {
+            THROW_ARGOSEXCEPTION("The cell size of the center line index must be positive");
+        }
+        const CDeepracerTrack::TWaypoints& tCenter = c_track.GetCenterLine();
+        m_unNumWaypoints = tCenter.size();
+        m_bClosed = c_track.IsClosed();
+        std::vector<SSegment> vecSegments;
+        m_fLength = 0.0;
+        Real fMaxWidth = 0.0;
+        /* Segments, skipping repeated waypoints */
+        UInt32 unSegments = m_bClosed ? m_unNumWaypoints : m_unNumWaypoints - 1;
+        for (UInt32 i = 0; i < unSegments; ++i) {
+            UInt32 j = (i + 1) % m_unNumWaypoints;
+            Real fStartWidth = (c_track.GetOuterBorder()[i] - c_track.GetInnerBorder()[i]).Length();
+            Real fEndWidth   = (c_track.GetOuterBorder()[j] - c_track.GetInnerBorder()[j]).Length();
+            fMaxWidth = Max(fMaxWidth, Max(fStartWidth, fEndWidth));
+            CVector2 cSegment = tCenter[j] - tCenter[i];
+            Real fLength = cSegment.Length();
+            if (fLength <= 0.0) continue;
+            SSegment sSegment;
+            sSegment.Start      = tCenter[i];
+            sSegment.Direction  = cSegment / fLength;
+            sSegment.Length     = fLength;
+            sSegment.ArcStart   = m_fLength;
+            sSegment.StartWidth = fStartWidth;
+            sSegment.EndWidth   = fEndWidth;
+            sSegment.Waypoint   = i;
+            vecSegments.push_back(sSegment);
+            m_fLength += fLength;
+        }
+        if (vecSegments.empty()) {
+            THROW_ARGOSEXCEPTION("The center line of the track has no length");
+        }
+        /* Exact lookups up to a track width from the center line */
+        m_fMargin = Max(fMaxWidth, f_cell_size);
+        /* Grid over the center line, grown by the margin */
+        CVector2 cMin(vecSegments[0].Start), cMax(cMin);
+        for (size_t i = 0; i < vecSegments.size(); ++i) {
+            CVector2 cEnd = vecSegments[i].Start + vecSegments[i].Direction * vecSegments[i].Length;
+            cMin.Set(Min(cMin.GetX(), Min(vecSegments[i].Start.GetX(), cEnd.GetX())),
+                     Min(cMin.GetY(), Min(vecSegments[i].Start.GetY(), cEnd.GetY())));
+            cMax.Set(Max(cMax.GetX(), Max(vecSegments[i].Start.GetX(), cEnd.GetX())),
+                     Max(cMax.GetY(), Max(vecSegments[i].Start.GetY(), cEnd.GetY())));
+        }
+        m_cGridMin = cMin - CVector2(m_fMargin, m_fMargin);
+        CVector2 cExtent = cMax + CVector2(m_fMargin, m_fMargin) - m_cGridMin;
+        m_fCellSize = Max(f_cell_size, ::sqrt(cExtent.GetX() * cExtent.GetY() / MAX_CELLS));
+        m_unCellsX = static_cast<UInt32>(::ceil(cExtent.GetX() / m_fCellSize)) + 1;
+        m_unCellsY = static_cast<UInt32>(::ceil(cExtent.GetY() / m_fCellSize)) + 1;
+        /* Count, then fill the segments of each cell */
+        std::vector<UInt32> vecCounts(m_unCellsX * m_unCellsY + 1, 0);
+        std::vector<UInt32> vecCellStart;
+        std::vector<UInt32> vecCellSegments;
+        for (UInt32 unPass = 0; unPass < 2; ++unPass) {
+            for (UInt32 i = 0; i < vecSegments.size(); ++i) {
+                const SSegment& sSeg = vecSegments[i];
+                CVector2 cEnd = sSeg.Start + sSeg.Direction * sSeg.Length;
+                UInt32 unX0 = static_cast<UInt32>((Min(sSeg.Start.GetX(), cEnd.GetX()) - m_fMargin - m_cGridMin.GetX()) / m_fCellSize);
+                UInt32 unY0 = static_cast<UInt32>((Min(sSeg.Start.GetY(), cEnd.GetY()) - m_fMargin - m_cGridMin.GetY()) / m_fCellSize);
+                UInt32 unX1 = Min<UInt32>(m_unCellsX - 1, (Max(sSeg.Start.GetX(), cEnd.GetX()) + m_fMargin - m_cGridMin.GetX()) / m_fCellSize);
+                UInt32 unY1 = Min<UInt32>(m_unCellsY - 1, (Max(sSeg.Start.GetY(), cEnd.GetY()) + m_fMargin - m_cGridMin.GetY()) / m_fCellSize);
+                for (UInt32 y = unY0; y <= unY1; ++y) {
+                    for (UInt32 x = unX0; x <= unX1; ++x) {
+                        UInt32 unCell = y * m_unCellsX + x;
+                        if (unPass == 0) {
+                            ++vecCounts[unCell + 1];
+                        } else {
+                            vecCellSegments[vecCounts[unCell]++] = i;
+                        }
+                    }
+                }
+            }
+            if (unPass == 0) {
+                for (size_t c = 1; c < vecCounts.size(); ++c) {
+                    vecCounts[c] += vecCounts[c - 1];
+                }
+                vecCellStart = vecCounts;
+                vecCellSegments.resize(vecCounts.back());
+            }
+        }
+        m_tSegments.Assign(vecSegments);
+        m_tCellStart.Assign(vecCellStart);
+        m_tCellSegments.Assign(vecCellSegments);
+        BuildCurvatures();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCenterlineIndex::BuildCurvatures() {
+        UInt32 unSamples = static_cast<UInt32>(::ceil(m_fLength / CURVATURE_STEP)) + 1;
+        std::vector<Real> vecCurvatures(unSamples);
+        Real fWindow = Min(CURVATURE_WINDOW, 0.5 * m_fLength);
+        for (UInt32 i = 0; i < unSamples; ++i) {
+            Real fArc = i * CURVATURE_STEP;
+            /* Heading change across the window; open tracks use the part of it within the track */
+            Real fBack  = m_bClosed ? fArc - 0.5 * fWindow : Max(fArc - 0.5 * fWindow, 0.0);
+            Real fAhead = m_bClosed ? fArc + 0.5 * fWindow : Min(fArc + 0.5 * fWindow, m_fLength);
+            if (fAhead <= fBack) {
+                vecCurvatures[i] = 0.0;
+                continue;
+            }
+            const CVector2& cDirBack  = m_tSegments[FindSegment(fBack)].Direction;
+            const CVector2& cDirAhead = m_tSegments[FindSegment(fAhead)].Direction;
+            CRadians cTurn = ATan2(cDirBack.CrossProduct(cDirAhead), cDirBack.DotProduct(cDirAhead));
+            vecCurvatures[i] = cTurn.GetValue() / (fAhead - fBack);
+        }
+        m_tCurvatures.Assign(vecCurvatures);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    /* Scalars of the index in an asset */
+    struct SCenterlineScalars {
+        CVector2 GridMin;
+        Real     Length;
+        Real     Margin;
+        Real     CellSize;
+        UInt32   NumWaypoints;
+        UInt32   CellsX;
+        UInt32   CellsY;
+        UInt32   Closed;
+    };
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCenterlineIndex::Save(CDeepracerAssetBuilder& c_builder,
+                                         const std::string& str_prefix) const {
+        SCenterlineScalars sScalars;
+        sScalars.GridMin      = m_cGridMin;
+        sScalars.Length       = m_fLength;
+        sScalars.Margin       = m_fMargin;
+        sScalars.CellSize     = m_fCellSize;
+        sScalars.NumWaypoints = m_unNumWaypoints;
+        sScalars.CellsX       = m_unCellsX;
+        sScalars.CellsY       = m_unCellsY;
+        sScalars.Closed       = m_bClosed ? 1 : 0;
+        c_builder.AddValue(str_prefix + ".scalars", sScalars);
+        c_builder.AddSection(str_prefix + ".segments", m_tSegments);
+        c_builder.AddSection(str_prefix + ".cell_start", m_tCellStart);
+        c_builder.AddSection(str_prefix + ".cell_segments", m_tCellSegments);
+        c_builder.AddSection(str_prefix + ".curvatures", m_tCurvatures);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    bool CDeepracerCenterlineIndex::Load(const CDeepracerAsset& c_asset,
+                                         const std::string& str_prefix) {
+        SCenterlineScalars sScalars;
+        TSegments tSegments;
+        CDeepracerSharedArray<UInt32> tCellStart, tCellSegments;
+        CDeepracerSharedArray<Real> tCurvatures;
+        if (!c_asset.GetValue(str_prefix + ".scalars", sScalars) ||
+            !c_asset.GetSection(str_prefix + ".segments", tSegments) ||
+            !c_asset.GetSection(str_prefix + ".cell_start", tCellStart) ||
+            !c_asset.GetSection(str_prefix + ".cell_segments", tCellSegments) ||
+            !c_asset.GetSection(str_prefix + ".curvatures", tCurvatures) ||
+            tSegments.empty() || tCurvatures.empty() ||
+            tCellStart.size() != static_cast<size_t>(sScalars.CellsX) * sScalars.CellsY + 1) {
+            return false;
+        }
+        m_cGridMin       = sScalars.GridMin;
+        m_fLength        = sScalars.Length;
+        m_fMargin        = sScalars.Margin;
+        m_fCellSize      = sScalars.CellSize;
+        m_unNumWaypoints = sScalars.NumWaypoints;
+        m_unCellsX       = sScalars.CellsX;
+        m_unCellsY       = sScalars.CellsY;
+        m_bClosed        = (sScalars.Closed != 0);
+        m_tSegments      = tSegments;
+        m_tCellStart     = tCellStart;
+        m_tCellSegments  = tCellSegments;
+        m_tCurvatures    = tCurvatures;
+        return true;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    Real CDeepracerCenterlineIndex::WrapArcLength(Real f_arc_length) const {
+        if (m_bClosed) {
+            f_arc_length = ::fmod(f_arc_length, m_fLength);
+            return f_arc_length < 0.0 ? f_arc_length + m_fLength : f_arc_length;
+        }
+        return Min(Max(f_arc_length, 0.0), m_fLength);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    UInt32 CDeepracerCenterlineIndex::FindSegment(Real f_arc_length) const {
+        f_arc_length = WrapArcLength(f_arc_length);
+        /* Last segment starting at or before the arc length */
+        UInt32 unLow = 0, unHigh = m_tSegments.size();
+        while (unHigh - unLow > 1) {
+            UInt32 unMid = (unLow + unHigh) / 2;
+            if (m_tSegments[unMid].ArcStart <= f_arc_length) unLow = unMid;
+            else unHigh = unMid;
+        }
+        return unLow;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    Real CDeepracerCenterlineIndex::GetCurvature(Real f_arc_length) const {
+        UInt32 unSample = static_cast<UInt32>(WrapArcLength(f_arc_length) / CURVATURE_STEP + 0.5);
+        return m_tCurvatures[Min<UInt32>(unSample, m_tCurvatures.size() - 1)];
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCenterlineIndex::Project(const CVector2& c_point,
+                                            UInt32 un_hint,
+                                            SProjection& s_projection) const {
+        /* Cars on the track near their last segment */
+        if (un_hint < m_tSegments.size() &&
+            Walk(c_point, un_hint, s_projection) &&
+            s_projection.Distance <= 0.5 * s_projection.TrackWidth) {
+            return;
+        }
+        /* Grid lookup */
+        Real fX = (c_point.GetX() - m_cGridMin.GetX()) / m_fCellSize;
+        Real fY = (c_point.GetY() - m_cGridMin.GetY()) / m_fCellSize;
+        if (fX >= 0.0 && fY >= 0.0 && fX < m_unCellsX && fY < m_unCellsY) {
+            UInt32 unCell = static_cast<UInt32>(fY) * m_unCellsX + static_cast<UInt32>(fX);
+            SProjection sCandidate;
+            s_projection.Distance = m_fMargin + 1.0;
+            for (UInt32 i = m_tCellStart[unCell]; i < m_tCellStart[unCell + 1]; ++i) {
+                ProjectOnSegment(m_tCellSegments[i], c_point, sCandidate);
+                if (sCandidate.Distance < s_projection.Distance) s_projection = sCandidate;
+            }
+            if (s_projection.Distance <= m_fMargin) return;
+        }
+        /* Far from the track */
+        ProjectOnAll(c_point, s_projection);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCenterlineIndex::ProjectOnSegment(UInt32 un_segment,
+                                                     const CVector2& c_point,
+                                                     SProjection& s_projection) const {
+        const SSegment& sSeg = m_tSegments[un_segment];
+        CVector2 cOffset = c_point - sSeg.Start;
+        Real fS = Min(Max(cOffset.DotProduct(sSeg.Direction), 0.0), sSeg.Length);
+        s_projection.Segment    = un_segment;
+        s_projection.Point      = sSeg.Start + sSeg.Direction * fS;
+        s_projection.Distance   = (c_point - s_projection.Point).Length();
+        s_projection.ArcLength  = sSeg.ArcStart + fS;
+        s_projection.TrackWidth = sSeg.StartWidth + (sSeg.EndWidth - sSeg.StartWidth) * fS / sSeg.Length;
+        s_projection.IsLeft     = sSeg.Direction.CrossProduct(cOffset) > 0.0;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    bool CDeepracerCenterlineIndex::Walk(const CVector2& c_point,
+                                         UInt32 un_hint,
+                                         SProjection& s_projection) const {
+        UInt32 unNum = m_tSegments.size();
+        ProjectOnSegment(un_hint, c_point, s_projection);
+        SProjection sCandidate;
+        for (UInt32 unStep = 0; unStep < MAX_WALK_STEPS; ++unStep) {
+            UInt32 unCurrent = s_projection.Segment;
+            bool bMoved = false;
+            /* Next and previous segments, wrapping around loops */
+            if (m_bClosed || unCurrent + 1 < unNum) {
+                ProjectOnSegment((unCurrent + 1) % unNum, c_point, sCandidate);
+                if (sCandidate.Distance < s_projection.Distance) {
+                    s_projection = sCandidate;
+                    bMoved = true;
+                }
+            }
+            if (!bMoved && (m_bClosed || unCurrent > 0)) {
+                ProjectOnSegment((unCurrent + unNum - 1) % unNum, c_point, sCandidate);
+                if (sCandidate.Distance < s_projection.Distance) {
+                    s_projection = sCandidate;
+                    bMoved = true;
+                }
+            }
+            if (!bMoved) return true;
+        }
+        return false;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCenterlineIndex::ProjectOnAll(const CVector2& c_point,
+                                                 SProjection& s_projection) const {
+        SProjection sCandidate;
+        ProjectOnSegment(0, c_point, s_projection);
+        for (UInt32 i = 1; i < m_tSegments.size(); ++i) {
+            ProjectOnSegment(i, c_point, sCandidate);
+            if (sCandidate.Distance < s_projection.Distance) s_projection = sCandidate;
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
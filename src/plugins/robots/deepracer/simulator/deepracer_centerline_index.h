@@ -0,0 +1,185 @@
+#ifndef DEEPRACER_CENTERLINE_INDEX_H
+#define DEEPRACER_CENTERLINE_INDEX_H
+
+namespace argos {
+    class CDeepracerCenterlineIndex;
+    class CDeepracerTrack;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/math/vector2.h>
+
+#include <vector>
+
+#include "deepracer_asset_cache.h"
+
+namespace argos {
+
+    /**
+     * The center line of a track as arc-length parameterized segments, with a
+     * uniform grid to find the segment closest to a point.
+     *
+     * Each grid cell lists the segments passing within GetMargin() of it, so
+     * the closest segment to a point up to that far from the center line is
+     * found with a handful of distance computations; points farther away fall
+     * back to a scan of all the segments. A lookup can also start from a hint, the
+     * segment found at the previous step: it then walks along the center line
+     * to the closest segment, which costs O(1) for a car that moved less than
+     * a few segments.
+     *
+     * The signed curvature of the center line (positive when it turns left) is
+     * tabulated at regular arc-length intervals, so it can be looked up ahead
+     * of a car at no cost.
+     */
+    class CDeepracerCenterlineIndex {
+    public:
+
+        /** Value of the hint when there is none */
+        static const UInt32 NO_HINT = 0xFFFFFFFF;
+
+        struct SSegment {
+            CVector2 Start;
+            /** Unit vector from the start to the end */
+            CVector2 Direction;
+            Real     Length;
+            /** Arc length of the start from the first waypoint */
+            Real     ArcStart;
+            /** Track width at the start and at the end */
+            Real     StartWidth;
+            Real     EndWidth;
+            /** Index of the waypoint at the start */
+            UInt32   Waypoint;
+        };
+
+        typedef CDeepracerSharedArray<SSegment> TSegments;
+
+        struct SProjection {
+            /** Closest segment */
+            UInt32   Segment;
+            /** Closest point on the center line */
+            CVector2 Point;
+            /** Distance from the center line */
+            Real     Distance;
+            /** Arc length of the closest point */
+            Real     ArcLength;
+            /** Track width at the closest point */
+            Real     TrackWidth;
+            /** Whether the point is on the left of the center line */
+            bool     IsLeft;
+        };
+
+    public:
+
+        CDeepracerCenterlineIndex();
+
+        /**
+         * Indexes the center line of a track.
+         * @param f_cell_size the side of the grid cells.
+         */
+        void Build(const CDeepracerTrack& c_track,
+                   Real f_cell_size = 0.25);
+
+        /**
+         * Adds the index to an asset, in sections named after the prefix.
+         */
+        void Save(CDeepracerAssetBuilder& c_builder,
+                  const std::string& str_prefix) const;
+
+        /**
+         * Uses an index stored in an asset, without copying it.
+         * @return false if the asset doesn't contain it.
+         */
+        bool Load(const CDeepracerAsset& c_asset,
+                  const std::string& str_prefix);
+
+        /**
+         * Projects a point, given in the frame of the track, on the center line.
+         * @param un_hint the segment found for the same car at the previous
+         * step, or NO_HINT.
+         */
+        void Project(const CVector2& c_point,
+                     UInt32 un_hint,
+                     SProjection& s_projection) const;
+
+        /**
+         * Returns the segment at the given arc length, wrapped around loops
+         * and clamped to the ends of open tracks.
+         */
+        UInt32 FindSegment(Real f_arc_length) const;
+
+        /**
+         * Returns the curvature of the center line at the given arc length, in 1/m.
+         */
+        Real GetCurvature(Real f_arc_length) const;
+
+        inline const TSegments& GetSegments() const {
+            return m_tSegments;
+        }
+
+        /**
+         * Returns the length of the center line, back to the first waypoint for loops.
+         */
+        inline Real GetLength() const {
+            return m_fLength;
+        }
+
+        inline bool IsClosed() const {
+            return m_bClosed;
+        }
+
+        inline UInt32 GetNumWaypoints() const {
+            return m_unNumWaypoints;
+        }
+
+        /**
+         * Returns the distance from the center line under which grid lookups are exact.
+         */
+        inline Real GetMargin() const {
+            return m_fMargin;
+        }
+
+    private:
+
+        void ProjectOnSegment(UInt32 un_segment,
+                              const CVector2& c_point,
+                              SProjection& s_projection) const;
+
+        /**
+         * Follows the center line from the hint while the distance decreases.
+         * @return false if the walk was too long to be worth it.
+         */
+        bool Walk(const CVector2& c_point,
+                  UInt32 un_hint,
+                  SProjection& s_projection) const;
+
+        void ProjectOnAll(const CVector2& c_point,
+                          SProjection& s_projection) const;
+
+        /**
+         * Wraps an arc length around loops, clamps it to open tracks.
+         */
+        Real WrapArcLength(Real f_arc_length) const;
+
+        void BuildCurvatures();
+
+    private:
+
+        TSegments                     m_tSegments;
+        Real                          m_fLength;
+        bool                          m_bClosed;
+        UInt32                        m_unNumWaypoints;
+        Real                          m_fMargin;
+        /** Grid, with the segments of each cell stored contiguously */
+        CVector2                      m_cGridMin;
+        Real                          m_fCellSize;
+        UInt32                        m_unCellsX;
+        UInt32                        m_unCellsY;
+        CDeepracerSharedArray<UInt32> m_tCellStart;
+        CDeepracerSharedArray<UInt32> m_tCellSegments;
+        /** Curvature every CURVATURE_STEP meters of arc length */
+        CDeepracerSharedArray<Real>   m_tCurvatures;
+    };
+
+}
+
+#endif
@@ -0,0 +1,240 @@
+#include "deepracer_checkpoint.h"
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/core/utility/math/rng.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    static const char   CHECKPOINT_MAGIC[4] = {'D', 'R', 'C', 'K'};
+    static const UInt32 CHECKPOINT_VERSION  = 1;
+
+    SInt32 CDeepracerCheckpoint::m_nBranchIndex = -1;
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerCheckpoint::CDeepracerCheckpoint() :
+        m_bHasPending(false),
+        m_bWriting(false),
+        m_bStop(false) {}
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerCheckpoint::~CDeepracerCheckpoint() {
+        {
+            std::lock_guard<std::mutex> cLock(m_cMutex);
+            m_bStop = true;
+        }
+        m_cCondVar.notify_all();
+        if (m_cThread.joinable()) m_cThread.join();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCheckpoint::Write(const CDeepracerSnapshot& c_snapshot,
+                                     const std::string& str_file_name) {
+        /* Write to a temporary file first, so that a crash leaves the previous checkpoint intact */
+        std::string strTmpFile = str_file_name + ".tmp";
+        FILE* ptFile = ::fopen(strTmpFile.c_str(), "wb");
+        if (ptFile == NULL) {
+            THROW_ARGOSEXCEPTION("Can't open checkpoint file \"" << strTmpFile << "\": " << ::strerror(errno));
+        }
+        UInt32 unRecordSize = sizeof(CDeepracerSnapshot::SRobotState);
+        bool bOk =
+            ::fwrite(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC), 1, ptFile) == 1 &&
+            ::fwrite(&CHECKPOINT_VERSION, sizeof(CHECKPOINT_VERSION), 1, ptFile) == 1 &&
+            ::fwrite(&unRecordSize, sizeof(unRecordSize), 1, ptFile) == 1 &&
+            ::fwrite(&c_snapshot.GetHeader(), sizeof(CDeepracerSnapshot::SHeader), 1, ptFile) == 1;
+        const std::vector<std::string>& vecIds = c_snapshot.GetRobotIds();
+        for (size_t i = 0; bOk && i < vecIds.size(); ++i) {
+            UInt32 unLength = vecIds[i].size();
+            bOk = ::fwrite(&unLength, sizeof(unLength), 1, ptFile) == 1 &&
+                  ::fwrite(vecIds[i].data(), 1, unLength, ptFile) == unLength;
+        }
+        const std::vector<CDeepracerSnapshot::SRobotState>& vecStates = c_snapshot.GetStates();
+        bOk = bOk && ::fwrite(vecStates.data(), unRecordSize, vecStates.size(), ptFile) == vecStates.size();
+        bOk = (::fclose(ptFile) == 0) && bOk;
+        if (!bOk || ::rename(strTmpFile.c_str(), str_file_name.c_str()) != 0) {
+            int nError = errno;
+            ::unlink(strTmpFile.c_str());
+            THROW_ARGOSEXCEPTION("Error writing checkpoint file \"" << str_file_name << "\": " << ::strerror(nError));
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCheckpoint::Read(CDeepracerSnapshot& c_snapshot,
+                                    const std::string& str_file_name) {
+        FILE* ptFile = ::fopen(str_file_name.c_str(), "rb");
+        if (ptFile == NULL) {
+            THROW_ARGOSEXCEPTION("Can't open checkpoint file \"" << str_file_name << "\": " << ::strerror(errno));
+        }
+        try {
+            char pchMagic[4];
+            UInt32 unVersion, unRecordSize;
+            CDeepracerSnapshot::SHeader sHeader;
+            if (::fread(pchMagic, sizeof(pchMagic), 1, ptFile) != 1 ||
+                ::memcmp(pchMagic, CHECKPOINT_MAGIC, sizeof(pchMagic)) != 0) {
+                THROW_ARGOSEXCEPTION("Not a DeepRacer checkpoint");
+            }
+            if (::fread(&unVersion, sizeof(unVersion), 1, ptFile) != 1 ||
+                unVersion != CHECKPOINT_VERSION) {
+                THROW_ARGOSEXCEPTION("Unsupported checkpoint version");
+            }
+            if (::fread(&unRecordSize, sizeof(unRecordSize), 1, ptFile) != 1 ||
+                unRecordSize != sizeof(CDeepracerSnapshot::SRobotState)) {
+                THROW_ARGOSEXCEPTION("The checkpoint was written by an incompatible build");
+            }
+            if (::fread(&sHeader, sizeof(sHeader), 1, ptFile) != 1) {
+                THROW_ARGOSEXCEPTION("Truncated checkpoint header");
+            }
+            std::vector<std::string> vecIds(sHeader.NumRobots);
+            for (UInt32 i = 0; i < sHeader.NumRobots; ++i) {
+                UInt32 unLength;
+                if (::fread(&unLength, sizeof(unLength), 1, ptFile) != 1) {
+                    THROW_ARGOSEXCEPTION("Truncated robot id table");
+                }
+                vecIds[i].resize(unLength);
+                if (unLength > 0 && ::fread(&vecIds[i][0], 1, unLength, ptFile) != unLength) {
+                    THROW_ARGOSEXCEPTION("Truncated robot id table");
+                }
+            }
+            std::vector<CDeepracerSnapshot::SRobotState> vecStates(sHeader.NumRobots);
+            if (::fread(vecStates.data(), unRecordSize, sHeader.NumRobots, ptFile) != sHeader.NumRobots) {
+                THROW_ARGOSEXCEPTION("Truncated robot states");
+            }
+            c_snapshot.Set(sHeader, vecIds, vecStates.data());
+            ::fclose(ptFile);
+        } catch (CARGoSException& ex) {
+            ::fclose(ptFile);
+            THROW_ARGOSEXCEPTION_NESTED("Error reading checkpoint file \"" << str_file_name << "\"", ex);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCheckpoint::WriteAsync(const CDeepracerSnapshot& c_snapshot,
+                                          const std::string& str_file_name) {
+        {
+            std::lock_guard<std::mutex> cLock(m_cMutex);
+            /* Newer snapshots replace the ones not yet written */
+            m_cPending       = c_snapshot;
+            m_strPendingFile = str_file_name;
+            m_bHasPending    = true;
+            /* The thread is started on demand, and stopped before forking */
+            if (!m_cThread.joinable()) {
+                m_bStop   = false;
+                m_cThread = std::thread(&CDeepracerCheckpoint::WriterThread, this);
+            }
+        }
+        m_cCondVar.notify_all();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCheckpoint::Flush() {
+        std::unique_lock<std::mutex> cLock(m_cMutex);
+        m_cCondVar.wait(cLock, [this] { return !m_bHasPending && !m_bWriting; });
+        if (!m_strError.empty()) {
+            std::string strError;
+            strError.swap(m_strError);
+            THROW_ARGOSEXCEPTION("Background checkpoint write failed: " << strError);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCheckpoint::WriterThread() {
+        CDeepracerSnapshot cSnapshot;
+        std::string strFile;
+        std::unique_lock<std::mutex> cLock(m_cMutex);
+        while (true) {
+            m_cCondVar.wait(cLock, [this] { return m_bHasPending || m_bStop; });
+            if (!m_bHasPending) break;
+            std::swap(cSnapshot, m_cPending);
+            strFile       = m_strPendingFile;
+            m_bHasPending = false;
+            m_bWriting    = true;
+            cLock.unlock();
+            std::string strError;
+            try {
+                Write(cSnapshot, strFile);
+            } catch (CARGoSException& ex) {
+                strError = ex.what();
+            }
+            cLock.lock();
+            if (!strError.empty()) m_strError = strError;
+            m_bWriting = false;
+            m_cCondVar.notify_all();
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    SInt32 CDeepracerCheckpoint::Branch(UInt32 un_branches,
+                                        UInt32 un_seed) {
+        /* fork() only duplicates the calling thread: the physics engines must not run in a pool */
+        if (CSimulator::GetInstance().GetNumThreads() > 0) {
+            THROW_ARGOSEXCEPTION("Branching a DeepRacer experiment requires <system threads=\"0\" />");
+        }
+        /* Finish the pending writes and stop the writer thread, it would not survive the fork */
+        Flush();
+        {
+            std::lock_guard<std::mutex> cLock(m_cMutex);
+            m_bStop = true;
+        }
+        m_cCondVar.notify_all();
+        if (m_cThread.joinable()) m_cThread.join();
+        /* Make sure the buffered output is not duplicated */
+        LOG.Flush();
+        LOGERR.Flush();
+        std::vector<pid_t> vecChildren;
+        for (UInt32 i = 0; i < un_branches; ++i) {
+            pid_t tPid = ::fork();
+            if (tPid < 0) {
+                THROW_ARGOSEXCEPTION("Can't fork branch " << i << ": " << ::strerror(errno));
+            }
+            if (tPid == 0) {
+                /* Child */
+                m_nBranchIndex = i;
+                ::setenv("DEEPRACER_BRANCH", std::to_string(i).c_str(), 1);
+                CRandom::GetCategory("argos").SetSeed(un_seed + i);
+                CRandom::GetCategory("argos").ResetRNGs();
+                return i;
+            }
+            vecChildren.push_back(tPid);
+        }
+        /* Parent: wait for the branches */
+        for (size_t i = 0; i < vecChildren.size(); ++i) {
+            int nStatus;
+            ::waitpid(vecChildren[i], &nStatus, 0);
+            if (!WIFEXITED(nStatus) || WEXITSTATUS(nStatus) != 0) {
+                LOGERR << "[WARNING] DeepRacer branch " << i << " (pid " << vecChildren[i] << ") failed" << std::endl;
+            }
+        }
+        return -1;
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
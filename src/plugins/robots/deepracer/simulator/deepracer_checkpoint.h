@@ -0,0 +1,108 @@
+#ifndef DEEPRACER_CHECKPOINT_H
+#define DEEPRACER_CHECKPOINT_H
+
+namespace argos {
+    class CDeepracerCheckpoint;
+}
+
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "deepracer_snapshot.h"
+
+namespace argos {
+
+    /**
+     * On-disk checkpoints of DeepRacer experiments.
+     *
+     * A checkpoint file contains a CDeepracerSnapshot: a small header, the
+     * robot ids and the flat robot records. The size of a record is stored
+     * too, so files written by a build with a different layout are rejected
+     * instead of being misread.
+     *
+     * Writing can be asynchronous: WriteAsync() copies the snapshot and a
+     * background thread writes it to a temporary file that is then renamed,
+     * so a crash never leaves a truncated checkpoint behind. If a new request
+     * arrives before the previous one was written, only the newest is kept.
+     *
+     * Branch() forks the process into N children that continue from the
+     * current state, e.g., right after restoring a warmed-up checkpoint, so
+     * that each can run with different parameters.
+     */
+    class CDeepracerCheckpoint {
+    public:
+
+        CDeepracerCheckpoint();
+
+        ~CDeepracerCheckpoint();
+
+        /**
+         * Writes the snapshot to the given file.
+         * @throws CARGoSException on I/O errors.
+         */
+        static void Write(const CDeepracerSnapshot& c_snapshot,
+                          const std::string& str_file_name);
+
+        /**
+         * Reads the snapshot from the given file.
+         * @throws CARGoSException on I/O errors or if the format doesn't match.
+         */
+        static void Read(CDeepracerSnapshot& c_snapshot,
+                         const std::string& str_file_name);
+
+        /**
+         * Queues the snapshot for writing in the background.
+         */
+        void WriteAsync(const CDeepracerSnapshot& c_snapshot,
+                        const std::string& str_file_name);
+
+        /**
+         * Waits until the queued snapshot, if any, has been written.
+         * @throws CARGoSException if the last background write failed.
+         */
+        void Flush();
+
+        /**
+         * Forks the process into un_branches children.
+         * The experiment must run in a single thread, and pending writes are
+         * flushed first. Each child gets its branch index also in the
+         * DEEPRACER_BRANCH environment variable and reseeds the "argos" random
+         * category with un_seed + index.
+         * @return the branch index in the children; in the parent, -1 once all
+         * the children are done.
+         * @throws CARGoSException if the process can't be forked.
+         */
+        SInt32 Branch(UInt32 un_branches,
+                      UInt32 un_seed);
+
+        /**
+         * Returns the branch index of this process, -1 if it was not forked.
+         */
+        static inline SInt32 GetBranchIndex() {
+            return m_nBranchIndex;
+        }
+
+    private:
+
+        void WriterThread();
+
+    private:
+
+        std::thread             m_cThread;
+        std::mutex              m_cMutex;
+        std::condition_variable m_cCondVar;
+        CDeepracerSnapshot      m_cPending;
+        std::string             m_strPendingFile;
+        bool                    m_bHasPending;
+        bool                    m_bWriting;
+        bool                    m_bStop;
+        std::string             m_strError;
+
+        static SInt32           m_nBranchIndex;
+    };
+
+}
+
+#endif
@@ -0,0 +1,209 @@
+#include "deepracer_checkpoint_loop_functions.h"
+
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/core/utility/string_utilities.h>
+
+#include "deepracer_entity.h"
+#include "deepracer_memory_stats.h"
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerCheckpointLoopFunctions::CDeepracerCheckpointLoopFunctions() :
+        m_unInterval(0),
+        m_unBranches(0),
+        m_unBranchStep(0),
+        m_unBranchSeed(0),
+        m_bBranched(false),
+        m_bBranchParent(false) {}
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCheckpointLoopFunctions::Init(TConfigurationNode& t_tree) {
+        try {
+            if (!NodeExists(t_tree, "checkpoint")) return;
+            TConfigurationNode& tCheckpoint = GetNode(t_tree, "checkpoint");
+            GetNodeAttributeOrDefault(tCheckpoint, "file", m_strFile, m_strFile);
+            GetNodeAttributeOrDefault(tCheckpoint, "interval", m_unInterval, m_unInterval);
+            GetNodeAttributeOrDefault(tCheckpoint, "branches", m_unBranches, m_unBranches);
+            GetNodeAttributeOrDefault(tCheckpoint, "branch_step", m_unBranchStep, m_unBranchStep);
+            m_unBranchSeed = CSimulator::GetInstance().GetRandomSeed();
+            GetNodeAttributeOrDefault(tCheckpoint, "branch_seed", m_unBranchSeed, m_unBranchSeed);
+            /* Parameters of each branch */
+            TConfigurationNodeIterator itBranch("branch");
+            for (itBranch = itBranch.begin(&tCheckpoint);
+                 itBranch != itBranch.end();
+                 ++itBranch) {
+                SBranchParam sParam;
+                GetNodeAttribute(*itBranch, "index", sParam.Branch);
+                if (sParam.Branch >= m_unBranches) {
+                    THROW_ARGOSEXCEPTION("Branch index " << sParam.Branch << " out of range, there are " << m_unBranches << " branches");
+                }
+                TConfigurationNodeIterator itParam("param");
+                for (itParam = itParam.begin(&*itBranch);
+                     itParam != itParam.end();
+                     ++itParam) {
+                    GetNodeAttribute(*itParam, "controller", sParam.Controller);
+                    GetNodeAttribute(*itParam, "path", sParam.Path);
+                    GetNodeAttribute(*itParam, "attribute", sParam.Attribute);
+                    GetNodeAttribute(*itParam, "value", sParam.Value);
+                    /* The rays are part of the robot, built before the fork */
+                    if (sParam.Attribute == "num_readings") {
+                        THROW_ARGOSEXCEPTION("Branch " << sParam.Branch << " can't change \"num_readings\" of \""
+                                             << sParam.Controller << "/" << sParam.Path << "\"");
+                    }
+                    m_vecBranchParams.push_back(sParam);
+                }
+            }
+            /* Continue a previous run */
+            std::string strRestore;
+            GetNodeAttributeOrDefault(tCheckpoint, "restore", strRestore, strRestore);
+            if (!strRestore.empty()) {
+                CDeepracerCheckpoint::Read(m_cSnapshot, strRestore);
+                m_cSnapshot.Restore();
+                LOG << "[INFO] Restored " << m_cSnapshot.GetHeader().NumRobots
+                    << " DeepRacers from \"" << strRestore
+                    << "\" at step " << m_cSnapshot.GetHeader().Clock
+                    << std::endl;
+            }
+        } catch (CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("Error initializing the DeepRacer checkpoint loop functions", ex);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCheckpointLoopFunctions::PreStep() {
+        if (m_unBranches == 0 || m_bBranched) return;
+        if (GetSpace().GetSimulationClock() < m_unBranchStep) return;
+        m_bBranched = true;
+        SInt32 nBranch = m_cCheckpoint.Branch(m_unBranches, m_unBranchSeed);
+        if (nBranch < 0) {
+            /* The parent only waits for the branches */
+            m_bBranchParent = true;
+            LOG << "[INFO] All " << m_unBranches << " DeepRacer branches are done" << std::endl;
+        } else {
+            ConfigureBranch(nBranch);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCheckpointLoopFunctions::ConfigureBranch(UInt32 un_branch) {
+        try {
+            /* The process is a copy: the configuration tree can be changed in place */
+            TConfigurationNode& tControllers = GetNode(CSimulator::GetInstance().GetConfigurationRoot(), "controllers");
+            std::vector<CDeepracerEntity*> vecRobots = CDeepracerEntity::CollectDeepracers();
+            for (size_t i = 0; i < m_vecBranchParams.size(); ++i) {
+                const SBranchParam& sParam = m_vecBranchParams[i];
+                if (sParam.Branch != un_branch) continue;
+                /* Node of the controller, then of the path */
+                TConfigurationNodeIterator itController;
+                for (itController = itController.begin(&tControllers);
+                     itController != itController.end();
+                     ++itController) {
+                    std::string strId;
+                    GetNodeAttributeOrDefault(*itController, "id", strId, strId);
+                    if (strId == sParam.Controller) break;
+                }
+                if (itController == itController.end()) {
+                    THROW_ARGOSEXCEPTION("Unknown controller \"" << sParam.Controller << "\"");
+                }
+                std::vector<std::string> vecPath;
+                Tokenize(sParam.Path, vecPath, "/");
+                if (vecPath.empty() || vecPath.size() > 2 ||
+                    (vecPath.size() == 1) != (vecPath[0] == "params") ||
+                    (vecPath.size() == 2 && vecPath[0] != "sensors" && vecPath[0] != "actuators")) {
+                    THROW_ARGOSEXCEPTION("Invalid path \"" << sParam.Path << "\", expected \"params\", \"sensors/<name>\" or \"actuators/<name>\"");
+                }
+                TConfigurationNode* ptNode = &GetNode(*itController, vecPath[0]);
+                if (vecPath.size() == 2) ptNode = &GetNode(*ptNode, vecPath[1]);
+                SetNodeAttribute(*ptNode, sParam.Attribute, sParam.Value);
+                /* Initialize the live objects again */
+                ReinitBranchTargets(vecRobots, sParam, vecPath, *ptNode);
+                LOG << "[INFO] DeepRacer branch " << un_branch << ": "
+                    << sParam.Controller << "/" << sParam.Path << "@" << sParam.Attribute
+                    << " = \"" << sParam.Value << "\"" << std::endl;
+            }
+        } catch (CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("Error configuring DeepRacer branch " << un_branch, ex);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCheckpointLoopFunctions::ReinitBranchTargets(const std::vector<CDeepracerEntity*>& vec_robots,
+                                                                 const SBranchParam& s_param,
+                                                                 const std::vector<std::string>& vec_path,
+                                                                 TConfigurationNode& t_node) {
+        for (size_t i = 0; i < vec_robots.size(); ++i) {
+            CDeepracerEntity& cRobot = *vec_robots[i];
+            if (cRobot.GetControllerId() != s_param.Controller) continue;
+            CCI_Controller& cController = cRobot.GetControllableEntity().GetController();
+            if (vec_path[0] == "params") {
+                cController.Init(t_node);
+            } else if (vec_path[0] == "sensors") {
+                CCI_Controller::TMapSensors::iterator itSensor = cController.GetAllSensors().find(vec_path[1]);
+                if (itSensor != cController.GetAllSensors().end()) itSensor->second->Init(t_node);
+            } else {
+                CCI_Controller::TMapActuators::iterator itActuator = cController.GetAllActuators().find(vec_path[1]);
+                if (itActuator != cController.GetAllActuators().end()) itActuator->second->Init(t_node);
+            }
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCheckpointLoopFunctions::PostStep() {
+        if (m_strFile.empty() || m_unInterval == 0 || m_bBranchParent) return;
+        if (GetSpace().GetSimulationClock() % m_unInterval != 0) return;
+        m_cSnapshot.Capture();
+        m_cCheckpoint.WriteAsync(m_cSnapshot, GetCheckpointFile());
+    }
+
+    /****************************************/
+    /****************************************/
+
+    bool CDeepracerCheckpointLoopFunctions::IsExperimentFinished() {
+        return m_bBranchParent;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCheckpointLoopFunctions::PostExperiment() {
+        CDeepracerMemoryStats::LogExperimentSummary();
+        if (m_strFile.empty() || m_bBranchParent) return;
+        /* The last checkpoint is written synchronously */
+        m_cCheckpoint.Flush();
+        m_cSnapshot.Capture();
+        CDeepracerCheckpoint::Write(m_cSnapshot, GetCheckpointFile());
+    }
+
+    /****************************************/
+    /****************************************/
+
+    std::string CDeepracerCheckpointLoopFunctions::GetCheckpointFile() const {
+        if (CDeepracerCheckpoint::GetBranchIndex() < 0) return m_strFile;
+        return m_strFile + ".branch" + std::to_string(CDeepracerCheckpoint::GetBranchIndex());
+    }
+
+    /****************************************/
+    /****************************************/
+
+    REGISTER_LOOP_FUNCTIONS(CDeepracerCheckpointLoopFunctions, "deepracer_checkpoint_loop_functions");
+
+    /****************************************/
+    /****************************************/
+
+}
@@ -0,0 +1,109 @@
+#ifndef DEEPRACER_CHECKPOINT_LOOP_FUNCTIONS_H
+#define DEEPRACER_CHECKPOINT_LOOP_FUNCTIONS_H
+
+namespace argos {
+    class CDeepracerCheckpointLoopFunctions;
+    class CDeepracerEntity;
+}
+
+#include <argos3/core/simulator/loop_functions.h>
+
+#include <string>
+#include <vector>
+
+#include "deepracer_checkpoint.h"
+#include "deepracer_snapshot.h"
+
+namespace argos {
+
+    /**
+     * Loop functions that checkpoint DeepRacer experiments periodically,
+     * restore them from a checkpoint and branch them into parallel runs.
+     *
+     *   <loop_functions library="..." label="deepracer_checkpoint_loop_functions">
+     *     <checkpoint file="run.drck" interval="1000"
+     *                 branches="2" branch_step="5000">
+     *       <branch index="1">
+     *         <param controller="ctrl" path="params" attribute="speed" value="0.8" />
+     *         <param controller="ctrl" path="sensors/deepracer_lidar" attribute="noise_std_dev" value="0.01" />
+     *       </branch>
+     *     </checkpoint>
+     *   </loop_functions>
+     *
+     * After the fork, each branch sets the attributes of its <param> nodes in
+     * the node at path ("params", "sensors/<name>" or "actuators/<name>")
+     * under the given controller of the <controllers> section, and calls
+     * Init() again with that node on the matching controller, sensor or
+     * actuator of every DeepRacer using it. Devices and controllers must
+     * therefore accept being initialized again. Subclasses can configure the
+     * branches differently by overriding ConfigureBranch().
+     */
+    class CDeepracerCheckpointLoopFunctions : public CLoopFunctions {
+    public:
+
+        CDeepracerCheckpointLoopFunctions();
+
+        virtual ~CDeepracerCheckpointLoopFunctions() {}
+
+        virtual void Init(TConfigurationNode& t_tree);
+
+        virtual void PreStep();
+
+        virtual void PostStep();
+
+        virtual bool IsExperimentFinished();
+
+        virtual void PostExperiment();
+
+    protected:
+
+        /**
+         * Called in each branch right after the fork, with its index.
+         * Applies the <param> overrides of the branch.
+         */
+        virtual void ConfigureBranch(UInt32 un_branch);
+
+    private:
+
+        /**
+         * An attribute set in the configuration of a controller for one branch.
+         */
+        struct SBranchParam {
+            UInt32      Branch;
+            std::string Controller;
+            std::string Path;
+            std::string Attribute;
+            std::string Value;
+        };
+
+        /**
+         * Returns the checkpoint file of this process, with the branch suffix.
+         */
+        std::string GetCheckpointFile() const;
+
+        /**
+         * Initializes again the targets of a parameter on the robots using its controller.
+         */
+        void ReinitBranchTargets(const std::vector<CDeepracerEntity*>& vec_robots,
+                                 const SBranchParam& s_param,
+                                 const std::vector<std::string>& vec_path,
+                                 TConfigurationNode& t_node);
+
+    private:
+
+        std::vector<SBranchParam> m_vecBranchParams;
+
+        CDeepracerCheckpoint m_cCheckpoint;
+        CDeepracerSnapshot   m_cSnapshot;
+        std::string          m_strFile;
+        UInt32               m_unInterval;
+        UInt32               m_unBranches;
+        UInt32               m_unBranchStep;
+        UInt32               m_unBranchSeed;
+        bool                 m_bBranched;
+        bool                 m_bBranchParent;
+    };
+
+}
+
+#endif
@@ -0,0 +1,95 @@
+#include "deepracer_collision_default_sensor.h"
+
+#include "deepracer_entity.h"
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerCollisionDefaultSensor::CDeepracerCollisionDefaultSensor() : m_pcDeepracerEntity(NULL) {}
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCollisionDefaultSensor::SetRobot(CComposableEntity& c_entity) {
+        m_pcDeepracerEntity = dynamic_cast<CDeepracerEntity*>(&c_entity);
+        if (m_pcDeepracerEntity == NULL) {
+            THROW_ARGOSEXCEPTION("The DeepRacer collision sensor can be associated only to a DeepRacer, not to entity \"" << c_entity.GetId() << "\"");
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCollisionDefaultSensor::Init(TConfigurationNode& t_tree) {
+        try {
+            CCI_DeepracerCollisionSensor::Init(t_tree);
+        } catch (CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("Initialization error in default DeepRacer collision sensor", ex);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCollisionDefaultSensor::Update() {
+        /* The physics engine has collected the events of this step already */
+        const CDeepracerEntity::TContacts& tContacts = m_pcDeepracerEntity->GetContacts();
+        m_tContacts.clear();
+        for (size_t i = 0; i < tContacts.size(); ++i) {
+            m_tContacts.push_back(
+                SContact(tContacts[i].Begin ? CONTACT_BEGIN : CONTACT_END,
+                         tContacts[i].Other != NULL ? tContacts[i].Other->GetId() : "",
+                         tContacts[i].Impulse));
+        }
+        m_bColliding = (m_pcDeepracerEntity->GetNumActiveContacts() > 0);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerCollisionDefaultSensor::Reset() {
+        m_tContacts.clear();
+        m_bColliding = false;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    REGISTER_SENSOR(CDeepracerCollisionDefaultSensor,
+                    "deepracer_collision", "default",
+                    "Carlo Pinciroli [ilpincy@gmail.com], Khai Yi Chin [khaiyichin@gmail.com]",
+                    "1.0",
+                    "The AWS DeepRacer collision sensor.",
+
+                    "This sensor returns the contacts of the robot body that started or ended in\n"
+                    "the last step, with the id of the entity touched and the impulse exchanged\n"
+                    "when the contact started. The events are collected by the dynamics2d engine\n"
+                    "through Chipmunk collision handlers, so no polling of the surroundings is\n"
+                    "needed. The same events are available to loop functions through\n"
+                    "CDeepracerEntity::GetContacts(). In controllers, you must include the\n"
+                    "ci_deepracer_collision_sensor.h header.\n\n"
+
+                    "REQUIRED XML CONFIGURATION\n\n"
+                    "  <controllers>\n"
+                    "    ...\n"
+                    "    <my_controller ...>\n"
+                    "      ...\n"
+                    "      <sensors>\n"
+                    "        ...\n"
+                    "        <deepracer_collision implementation=\"default\" />\n"
+                    "        ...\n"
+                    "      </sensors>\n"
+                    "      ...\n"
+                    "    </my_controller>\n"
+                    "    ...\n"
+                    "  </controllers>\n\n"
+
+                    "OPTIONAL XML CONFIGURATION\n\n"
+
+                    "None.\n",
+
+                    "Usable");
+
+}
@@ -0,0 +1,40 @@
+#ifndef DEEPRACER_COLLISION_DEFAULT_SENSOR_H
+#define DEEPRACER_COLLISION_DEFAULT_SENSOR_H
+
+#include <string>
+
+namespace argos {
+    class CDeepracerCollisionDefaultSensor;
+    class CDeepracerEntity;
+}
+
+#include <argos3/core/simulator/sensor.h>
+#include <argos3/plugins/robots/deepracer/control_interface/ci_deepracer_collision_sensor.h>
+
+namespace argos {
+
+    class CDeepracerCollisionDefaultSensor : public CSimulatedSensor,
+                                             public CCI_DeepracerCollisionSensor {
+    public:
+
+        CDeepracerCollisionDefaultSensor();
+
+        virtual ~CDeepracerCollisionDefaultSensor() {}
+
+        virtual void SetRobot(CComposableEntity& c_entity);
+
+        virtual void Init(TConfigurationNode& t_tree);
+
+        virtual void Update();
+
+        virtual void Reset();
+
+    protected:
+
+        /** Reference to the DeepRacer entity associated to this sensor */
+        CDeepracerEntity* m_pcDeepracerEntity;
+    };
+
+}
+
+#endif
@@ -0,0 +1,44 @@
+#include "deepracer_dataset_loop_functions.h"
+
+#include <argos3/core/utility/string_utilities.h>
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    bool CDeepracerDatasetLoopFunctions::Configure(TConfigurationNode& t_tree) {
+        if (!NodeExists(t_tree, "dataset")) return false;
+        TConfigurationNode& tDataset = GetNode(t_tree, "dataset");
+        m_strDirectory = "dataset";
+        m_strPrefix = "shard";
+        m_unStepsPerShard = 1000;
+        m_unBuffers = 3;
+        m_unThreads = 1;
+        GetNodeAttributeOrDefault(tDataset, "directory", m_strDirectory, m_strDirectory);
+        GetNodeAttributeOrDefault(tDataset, "prefix", m_strPrefix, m_strPrefix);
+        GetNodeAttributeOrDefault(tDataset, "steps_per_shard", m_unStepsPerShard, m_unStepsPerShard);
+        GetNodeAttributeOrDefault(tDataset, "buffers", m_unBuffers, m_unBuffers);
+        GetNodeAttributeOrDefault(tDataset, "threads", m_unThreads, m_unThreads);
+        ExpandEnvVariables(m_strDirectory);
+        return true;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerDatasetLoopFunctions::Open(UInt32 un_run) {
+        std::string strPrefix = m_strPrefix;
+        if (un_run > 0) strPrefix += "_run" + ToString(un_run);
+        m_cRecorder.Open(m_strDirectory, strPrefix, m_unStepsPerShard, m_unBuffers, m_unThreads);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    REGISTER_LOOP_FUNCTIONS(CDeepracerDatasetLoopFunctions, "deepracer_dataset_loop_functions");
+
+    /****************************************/
+    /****************************************/
+
+}
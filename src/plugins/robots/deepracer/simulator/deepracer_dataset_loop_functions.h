@@ -0,0 +1,46 @@
+#ifndef DEEPRACER_DATASET_LOOP_FUNCTIONS_H
+#define DEEPRACER_DATASET_LOOP_FUNCTIONS_H
+
+namespace argos {
+    class CDeepracerDatasetLoopFunctions;
+}
+
+#include "deepracer_recording_loop_functions.h"
+#include "deepracer_dataset_recorder.h"
+
+namespace argos {
+
+    /**
+     * Loop functions that record the readings and commands of all the
+     * DeepRacers after each step into a binary dataset. The runs after a
+     * reset are written with the prefix followed by "_run<N>".
+     */
+    class CDeepracerDatasetLoopFunctions : public CDeepracerRecordingLoopFunctions<CDeepracerDatasetRecorder> {
+    public:
+
+        CDeepracerDatasetLoopFunctions() :
+            CDeepracerRecordingLoopFunctions<CDeepracerDatasetRecorder>("dataset"),
+            m_unStepsPerShard(1000),
+            m_unBuffers(3),
+            m_unThreads(1) {}
+
+        virtual ~CDeepracerDatasetLoopFunctions() {}
+
+    protected:
+
+        virtual bool Configure(TConfigurationNode& t_tree);
+
+        virtual void Open(UInt32 un_run);
+
+    private:
+
+        std::string m_strDirectory;
+        std::string m_strPrefix;
+        UInt32      m_unStepsPerShard;
+        UInt32      m_unBuffers;
+        UInt32      m_unThreads;
+    };
+
+}
+
+#endif
@@ -0,0 +1,287 @@
+#include "deepracer_dataset_recorder.h"
+
+#include <argos3/core/control_interface/ci_controller.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/plugins/robots/deepracer/control_interface/ci_ackermann_steering_actuator.h>
+#include <argos3/plugins/robots/deepracer/control_interface/ci_deepracer_imu_sensor.h>
+#include <argos3/plugins/robots/deepracer/control_interface/ci_deepracer_lidar_sensor.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+#include <sys/stat.h>
+
+#include "deepracer_entity.h"
+#include "deepracer_thread_pool.h"
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    /* Robot index and step */
+    static const size_t ROW_HEADER_SIZE = 2 * sizeof(UInt32);
+
+    /* IMU values, steering and throttle */
+    static const UInt32 ROW_EXTRA_VALUES = 8;
+
+    /* NumPy headers are padded to a multiple of this */
+    static const size_t NPY_ALIGNMENT = 64;
+
+    /****************************************/
+    /****************************************/
+
+    static Real SecondsSince(const std::chrono::steady_clock::time_point& t_start) {
+        return std::chrono::duration<Real>(std::chrono::steady_clock::now() - t_start).count();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerDatasetRecorder::CDeepracerDatasetRecorder() :
+        m_unStepsPerShard(0),
+        m_unThreads(1),
+        m_unNumReadings(0),
+        m_unRowSize(0),
+        m_psCurrent(NULL),
+        m_unNextShard(0),
+        m_unRows(0),
+        m_unFailedShards(0),
+        m_fRecordSeconds(0.0),
+        m_fWaitSeconds(0.0) {}
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerDatasetRecorder::~CDeepracerDatasetRecorder() {
+        Close();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerDatasetRecorder::Open(const std::string& str_directory,
+                                         const std::string& str_prefix,
+                                         UInt32 un_steps_per_shard,
+                                         UInt32 un_buffers,
+                                         UInt32 un_threads) {
+        if (IsOpen()) {
+            THROW_ARGOSEXCEPTION("The DeepRacer dataset recorder is already recording");
+        }
+        if (un_steps_per_shard == 0 || un_buffers < 2) {
+            THROW_ARGOSEXCEPTION("A DeepRacer dataset needs at least one step per shard and two shard buffers");
+        }
+        m_strDirectory    = str_directory;
+        m_strPrefix       = str_prefix;
+        m_unStepsPerShard = un_steps_per_shard;
+        m_unThreads       = Max<UInt32>(un_threads, 1);
+        /* The robots and their devices, sorted by id */
+        m_vecRobots.clear();
+        m_vecRobotIds.clear();
+        std::vector<CDeepracerEntity*> vecRobots = CDeepracerEntity::CollectDeepracers();
+        for (size_t i = 0; i < vecRobots.size(); ++i) {
+            CDeepracerEntity& cRobot = *vecRobots[i];
+            CCI_Controller& cController = cRobot.GetControllableEntity().GetController();
+            CCI_Controller::TMapSensors::iterator itLIDAR = cController.GetAllSensors().find("deepracer_lidar");
+            CCI_Controller::TMapSensors::iterator itIMU = cController.GetAllSensors().find("deepracer_imu");
+            CCI_Controller::TMapActuators::iterator itSteering = cController.GetAllActuators().find("ackermann_steering");
+            if (itLIDAR == cController.GetAllSensors().end() ||
+                itIMU == cController.GetAllSensors().end() ||
+                itSteering == cController.GetAllActuators().end()) {
+                THROW_ARGOSEXCEPTION("DeepRacer \"" << cRobot.GetId() << "\" needs the deepracer_lidar and deepracer_imu sensors and the ackermann_steering actuator to be recorded");
+            }
+            SRobot sRobot;
+            sRobot.Entity   = &cRobot;
+            sRobot.LIDAR    = dynamic_cast<CCI_DeepracerLIDARSensor*>(itLIDAR->second);
+            sRobot.IMU      = dynamic_cast<CCI_DeepracerIMUSensor*>(itIMU->second);
+            sRobot.Steering = dynamic_cast<CCI_AckermannSteeringActuator*>(itSteering->second);
+            if (!m_vecRobots.empty() && sRobot.LIDAR->GetNumReadings() != m_unNumReadings) {
+                THROW_ARGOSEXCEPTION("DeepRacer \"" << cRobot.GetId() << "\" has " << sRobot.LIDAR->GetNumReadings()
+                                     << " LIDAR readings, the others have " << m_unNumReadings);
+            }
+            m_unNumReadings = sRobot.LIDAR->GetNumReadings();
+            m_vecRobots.push_back(sRobot);
+            m_vecRobotIds.push_back(cRobot.GetId());
+        }
+        if (m_vecRobots.empty()) {
+            THROW_ARGOSEXCEPTION("There is no DeepRacer to record");
+        }
+        m_unRowSize = ROW_HEADER_SIZE + (m_unNumReadings + ROW_EXTRA_VALUES) * sizeof(float);
+        /* Output directory and index */
+        if (::mkdir(m_strDirectory.c_str(), 0755) != 0 && errno != EEXIST) {
+            THROW_ARGOSEXCEPTION("Can't create directory \"" << m_strDirectory << "\": " << ::strerror(errno));
+        }
+        std::string strIndex = m_strDirectory + "/" + m_strPrefix + "_index.csv";
+        m_cIndex.open(strIndex.c_str(), std::ios::trunc);
+        if (!m_cIndex) {
+            THROW_ARGOSEXCEPTION("Can't open \"" << strIndex << "\"");
+        }
+        m_cIndex << "# robots:";
+        for (size_t i = 0; i < m_vecRobotIds.size(); ++i) {
+            m_cIndex << " " << m_vecRobotIds[i];
+        }
+        m_cIndex << std::endl
+                 << "# dtype: " << MakeDescr() << std::endl
+                 << "file,first_step,steps,rows" << std::endl;
+        m_unNextShard    = 0;
+        m_unRows         = 0;
+        m_unFailedShards = 0;
+        m_fRecordSeconds = 0.0;
+        m_fWaitSeconds   = 0.0;
+        /* Shard buffers, written by one thread to keep the index in order */
+        size_t unShardSize = m_unStepsPerShard * m_vecRobots.size() * m_unRowSize;
+        m_cShards.Start(un_buffers, 1,
+                        [this](SShard& s_shard) { WriteShard(s_shard); },
+                        [unShardSize](SShard& s_shard) { s_shard.Data.resize(unShardSize); });
+        m_psCurrent = m_cShards.Acquire();
+        m_psCurrent->Steps = 0;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerDatasetRecorder::Record(UInt32 un_step) {
+        if (m_psCurrent == NULL) return;
+        std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+        if (m_psCurrent->Steps == 0) m_psCurrent->FirstStep = un_step;
+        UInt8* punRows = &m_psCurrent->Data[m_psCurrent->Steps * m_vecRobots.size() * m_unRowSize];
+        if (m_unThreads > 1) {
+            CDeepracerThreadPool::GetShared(m_unThreads).ParallelFor(
+                m_vecRobots.size(),
+                [this, punRows, un_step](UInt32 un_robot) {
+                    RecordRobot(un_robot, punRows + un_robot * m_unRowSize, un_step);
+                });
+        } else {
+            for (UInt32 i = 0; i < m_vecRobots.size(); ++i) {
+                RecordRobot(i, punRows + i * m_unRowSize, un_step);
+            }
+        }
+        m_unRows += m_vecRobots.size();
+        if (++m_psCurrent->Steps == m_unStepsPerShard) Submit();
+        m_fRecordSeconds += SecondsSince(tStart);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerDatasetRecorder::Close() {
+        if (!IsOpen()) return;
+        /* The last shard is partial */
+        if (m_psCurrent->Steps > 0) {
+            m_psCurrent->Index = m_unNextShard++;
+            m_cShards.Queue(m_psCurrent);
+        } else {
+            m_cShards.Release(m_psCurrent);
+        }
+        m_psCurrent = NULL;
+        m_cShards.Stop();
+        m_cIndex.close();
+        LOG << "[INFO] DeepRacer dataset: " << m_unRows << " records of " << m_vecRobots.size()
+            << " robots in " << m_unNextShard << " shards in \"" << m_strDirectory << "\", "
+            << m_fRecordSeconds << " s recording, of which "
+            << m_fWaitSeconds << " s waiting for the writer";
+        if (m_unFailedShards > 0) {
+            LOG << ", " << m_unFailedShards << " shards failed to write";
+        }
+        LOG << std::endl;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerDatasetRecorder::RecordRobot(UInt32 un_robot,
+                                                UInt8* pun_row,
+                                                UInt32 un_step) {
+        const SRobot& sRobot = m_vecRobots[un_robot];
+        UInt32 punHeader[2] = { un_robot, un_step };
+        ::memcpy(pun_row, punHeader, ROW_HEADER_SIZE);
+        /* Rows are a multiple of 4 bytes, so the values are aligned */
+        float* pfValue = reinterpret_cast<float*>(pun_row + ROW_HEADER_SIZE);
+        for (UInt32 i = 0; i < m_unNumReadings; ++i) {
+            *pfValue++ = sRobot.LIDAR->GetReading(i);
+        }
+        const CCI_DeepracerIMUSensor::SReading& sIMU = sRobot.IMU->GetReading();
+        *pfValue++ = sIMU.AngVelocity.GetX();
+        *pfValue++ = sIMU.AngVelocity.GetY();
+        *pfValue++ = sIMU.AngVelocity.GetZ();
+        *pfValue++ = sIMU.LinAcceleration.GetX();
+        *pfValue++ = sIMU.LinAcceleration.GetY();
+        *pfValue++ = sIMU.LinAcceleration.GetZ();
+        /* The command decided in this step, applied at the next one */
+        *pfValue++ = sRobot.Steering->GetSteeringAngle();
+        *pfValue++ = sRobot.Steering->GetThrottleSpeed();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerDatasetRecorder::Submit() {
+        std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+        m_psCurrent->Index = m_unNextShard++;
+        m_cShards.Queue(m_psCurrent);
+        /* Waits only if all the buffers are queued */
+        m_psCurrent = m_cShards.Acquire();
+        m_psCurrent->Steps = 0;
+        m_fWaitSeconds += SecondsSince(tStart);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerDatasetRecorder::WriteShard(const SShard& s_shard) {
+        std::ostringstream cName;
+        cName << m_strPrefix << "_" << std::setw(6) << std::setfill('0') << s_shard.Index << ".npy";
+        std::string strFile = m_strDirectory + "/" + cName.str();
+        UInt32 unRows = s_shard.Steps * m_vecRobots.size();
+        std::string strHeader = MakeHeader(unRows);
+        std::ofstream cFile(strFile.c_str(), std::ios::binary | std::ios::trunc);
+        cFile.write(strHeader.data(), strHeader.size());
+        cFile.write(reinterpret_cast<const char*>(s_shard.Data.data()), unRows * m_unRowSize);
+        cFile.close();
+        if (!cFile) {
+            ++m_unFailedShards;
+            LOGERR << "[WARNING] Can't write DeepRacer dataset shard \"" << strFile << "\"" << std::endl;
+            return;
+        }
+        /* Only complete shards are listed */
+        m_cIndex << cName.str() << "," << s_shard.FirstStep << "," << s_shard.Steps << "," << unRows << std::endl;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    std::string CDeepracerDatasetRecorder::MakeDescr() const {
+        std::ostringstream cDescr;
+        cDescr << "[('robot', '<u4'), ('step', '<u4'), "
+               << "('lidar', '<f4', (" << m_unNumReadings << ",)), ('imu', '<f4', (6,)), "
+               << "('steering', '<f4'), ('throttle', '<f4')]";
+        return cDescr.str();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    std::string CDeepracerDatasetRecorder::MakeHeader(UInt32 un_rows) const {
+        std::ostringstream cDict;
+        cDict << "{'descr': " << MakeDescr() << ", "
+              << "'fortran_order': False, 'shape': (" << un_rows << ",), }";
+        std::string strDict = cDict.str();
+        /* Magic, version 1.0, 16-bit header length, dictionary padded with spaces and a newline */
+        size_t unPreamble = 10;
+        size_t unPadding = NPY_ALIGNMENT - (unPreamble + strDict.size() + 1) % NPY_ALIGNMENT;
+        if (unPadding == NPY_ALIGNMENT) unPadding = 0;
+        strDict.append(unPadding, ' ');
+        strDict.push_back('\n');
+        std::string strHeader("\x93NUMPY\x01\x00", 8);
+        strHeader.push_back(static_cast<char>(strDict.size() & 0xFF));
+        strHeader.push_back(static_cast<char>(strDict.size() >> 8));
+        return strHeader + strDict;
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
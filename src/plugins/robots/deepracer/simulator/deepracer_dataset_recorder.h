@@ -0,0 +1,143 @@
+#ifndef DEEPRACER_DATASET_RECORDER_H
+#define DEEPRACER_DATASET_RECORDER_H
+
+namespace argos {
+    class CCI_AckermannSteeringActuator;
+    class CCI_DeepracerIMUSensor;
+    class CCI_DeepracerLIDARSensor;
+    class CDeepracerDatasetRecorder;
+    class CDeepracerEntity;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "deepracer_buffer_queue.h"
+
+namespace argos {
+
+    /**
+     * Records the sensor readings and commands of all the DeepRacers at every
+     * step, for imitation learning, without going through text logs.
+     *
+     * Each record is a fixed-size binary row: robot index and step (uint32),
+     * LIDAR ranges, IMU angular velocity and linear acceleration (X,Y,Z), then
+     * the steering angle and throttle speed decided by the controller in that
+     * step (float32). The rows of a number of steps fill a preallocated shard
+     * buffer; the robots write their own rows, so they can be recorded by
+     * several threads without locking. Full shards go to a writer thread that
+     * saves each as a NumPy file with a structured data type and appends it to
+     * an index; the recording only waits when all the shard buffers are
+     * queued for writing.
+     */
+    class CDeepracerDatasetRecorder {
+    public:
+
+        CDeepracerDatasetRecorder();
+
+        ~CDeepracerDatasetRecorder();
+
+        /**
+         * Starts recording the DeepRacers in the space into a directory.
+         * @param un_steps_per_shard steps stored in each shard.
+         * @param un_buffers shard buffers, the one being filled included.
+         * @param un_threads threads sharing the robots in Record().
+         * @throws CARGoSException if the robots lack the recorded devices or
+         * the directory can't be written.
+         */
+        void Open(const std::string& str_directory,
+                  const std::string& str_prefix,
+                  UInt32 un_steps_per_shard,
+                  UInt32 un_buffers = 3,
+                  UInt32 un_threads = 1);
+
+        /**
+         * Records the current readings and commands of all the robots.
+         */
+        void Record(UInt32 un_step);
+
+        /**
+         * Writes the last, partial shard and waits for the writer.
+         */
+        void Close();
+
+        inline bool IsOpen() const {
+            return m_cShards.IsRunning();
+        }
+
+        /**
+         * Returns the size of a record in bytes.
+         */
+        inline size_t GetRowSize() const {
+            return m_unRowSize;
+        }
+
+    private:
+
+        struct SRobot {
+            CDeepracerEntity*              Entity;
+            CCI_DeepracerLIDARSensor*      LIDAR;
+            CCI_DeepracerIMUSensor*        IMU;
+            CCI_AckermannSteeringActuator* Steering;
+        };
+
+        struct SShard {
+            std::vector<UInt8> Data;
+            UInt32             Index;
+            UInt32             FirstStep;
+            UInt32             Steps;
+        };
+
+    private:
+
+        void RecordRobot(UInt32 un_robot,
+                         UInt8* pun_row,
+                         UInt32 un_step);
+
+        /**
+         * Hands the shard being filled to the writer and takes a free one.
+         */
+        void Submit();
+
+        void WriteShard(const SShard& s_shard);
+
+        /**
+         * Returns the NumPy structured data type of the records.
+         */
+        std::string MakeDescr() const;
+
+        /**
+         * Returns the NumPy header of a shard with the given number of rows.
+         */
+        std::string MakeHeader(UInt32 un_rows) const;
+
+    private:
+
+        std::string              m_strDirectory;
+        std::string              m_strPrefix;
+        UInt32                   m_unStepsPerShard;
+        UInt32                   m_unThreads;
+        std::vector<SRobot>      m_vecRobots;
+        std::vector<std::string> m_vecRobotIds;
+        UInt32                   m_unNumReadings;
+        size_t                   m_unRowSize;
+
+        /** Shard buffers and the one being filled */
+        CDeepracerBufferQueue<SShard> m_cShards;
+        SShard*                  m_psCurrent;
+        UInt32                   m_unNextShard;
+        std::ofstream            m_cIndex;
+
+        /** Statistics */
+        UInt64                   m_unRows;
+        UInt32                   m_unFailedShards;
+        Real                     m_fRecordSeconds;
+        Real                     m_fWaitSeconds;
+    };
+
+}
+
+#endif
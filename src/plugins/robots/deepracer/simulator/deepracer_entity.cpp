@@ -2,25 +2,48 @@
 
 #include <argos3/core/simulator/entity/controllable_entity.h>
 #include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/simulator.h>
 #include <argos3/core/simulator/space/space.h>
 #include <argos3/plugins/simulator/entities/battery_equipped_entity.h>
 #include <argos3/plugins/simulator/entities/proximity_sensor_equipped_entity.h>
 #include <argos3/plugins/simulator/entities/rab_equipped_entity.h>
 
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include "deepracer_init_profiler.h"
+#include "deepracer_lidar_default_sensor.h"
 #include "deepracer_measures.h"
+#include "deepracer_spatial_hash.h"
+#include "deepracer_track_entity.h"
 
 namespace argos {
 
     /****************************************/
     /****************************************/
 
+    /*
+     * The optional components of each controller, and the controllers whose
+     * skipped components were logged. They come from the configuration of the
+     * current experiment, so they are cleared with its last DeepRacer.
+     */
+    static std::map<std::string, CDeepracerEntity::SRequiredComponents> REQUIRED_COMPONENTS;
+    static std::set<std::string>                                        LOGGED_CONTROLLERS;
+
+    /****************************************/
+    /****************************************/
+
     CDeepracerEntity::CDeepracerEntity()
         : CComposableEntity(NULL),
           m_pcControllableEntity(NULL),
           m_pcEmbodiedEntity(NULL),
           m_pcLIDARSensorEquippedEntity(NULL),
           m_pcRABEquippedEntity(NULL),
-          m_pcAckermannWheeledEntity(NULL) {
+          m_pcAckermannWheeledEntity(NULL),
+          m_pcBatteryEquippedEntity(NULL),
+          m_unNumActiveContacts(0) {
     }
 
     /****************************************/
@@ -38,36 +61,83 @@ namespace argos {
           m_pcEmbodiedEntity(NULL),
           m_pcLIDARSensorEquippedEntity(NULL),
           m_pcRABEquippedEntity(NULL),
-          m_pcAckermannWheeledEntity(NULL) {
+          m_pcAckermannWheeledEntity(NULL),
+          m_pcBatteryEquippedEntity(NULL),
+          m_unNumActiveContacts(0) {
         try {
-            /*
-             * Create and init components
-             */
-            /* Embodied entity */
-            m_pcEmbodiedEntity = new CEmbodiedEntity(this, "body_0", c_position, c_orientation);
-            AddComponent(*m_pcEmbodiedEntity);
-            /* Wheeled entity and wheel positions (rear left, rear right, front left, front right) */
-            m_pcAckermannWheeledEntity = new CAckermannWheeledEntity(this, "wheels_0");
-            AddComponent(*m_pcAckermannWheeledEntity);
-            m_pcAckermannWheeledEntity->SetWheel(0,
-                                                 DEEPRACER_REAR_LEFT_WHEEL_POS_WRT_BASE,
-                                                 DEEPRACER_WHEEL_RADIUS);
-            m_pcAckermannWheeledEntity->SetWheel(1,
-                                                 DEEPRACER_REAR_RIGHT_WHEEL_POS_WRT_BASE,
-                                                 DEEPRACER_WHEEL_RADIUS);
-            m_pcAckermannWheeledEntity->SetWheel(2,
-                                                 DEEPRACER_FRONT_LEFT_WHEEL_POS_WRT_BASE,
-                                                 DEEPRACER_WHEEL_RADIUS);
-            m_pcAckermannWheeledEntity->SetWheel(3,
-                                                 DEEPRACER_FRONT_RIGHT_WHEEL_POS_WRT_BASE,
-                                                 DEEPRACER_WHEEL_RADIUS);
-            /* Camera sensor equipped entity */
-            /* LIDAR sensor equipped entity */
+            /* Only create the optional components the controller uses */
+            SRequiredComponents sRequired = GetRequiredComponents(str_controller_id);
+            sRequired.Battery = sRequired.Battery || !str_bat_model.empty();
+            LogSkippedComponents(str_controller_id, sRequired, un_rab_data_size);
+            CDeepracerInitProfiler::CScope cComponentsProfile(CDeepracerInitProfiler::PHASE_COMPONENTS);
+            CreateComponents(c_position, c_orientation, f_rab_range, un_rab_data_size, str_bat_model, sRequired);
+            cComponentsProfile.Stop();
+            CDeepracerInitProfiler::CScope cControllerProfile(CDeepracerInitProfiler::PHASE_CONTROLLER);
+            CreateControllableEntity(str_controller_id);
+            cControllerProfile.Stop();
+            /* Update components */
+            UpdateComponents();
+        } catch (CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("Failed to initialize entity \"" << GetId() << "\".", ex);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerEntity::CDeepracerEntity(const std::string& str_id)
+        : CComposableEntity(NULL, str_id),
+          m_pcControllableEntity(NULL),
+          m_pcEmbodiedEntity(NULL),
+          m_pcLIDARSensorEquippedEntity(NULL),
+          m_pcRABEquippedEntity(NULL),
+          m_pcAckermannWheeledEntity(NULL),
+          m_pcBatteryEquippedEntity(NULL),
+          m_unNumActiveContacts(0) {
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerEntity::CreateComponents(const CVector3&            c_position,
+                                            const CQuaternion&         c_orientation,
+                                            Real                       f_rab_range,
+                                            size_t                     un_rab_data_size,
+                                            const std::string&         str_bat_model,
+                                            const SRequiredComponents& s_required) {
+        /* Embodied entity */
+        m_pcEmbodiedEntity = new CEmbodiedEntity(this, "body_0", c_position, c_orientation);
+        AddComponent(*m_pcEmbodiedEntity);
+        /* Wheeled entity and wheel positions (rear left, rear right, front left, front right) */
+        m_pcAckermannWheeledEntity = new CAckermannWheeledEntity(this, "wheels_0");
+        AddComponent(*m_pcAckermannWheeledEntity);
+        m_pcAckermannWheeledEntity->SetWheel(0,
+                                             DEEPRACER_REAR_LEFT_WHEEL_POS_WRT_BASE,
+                                             DEEPRACER_WHEEL_RADIUS);
+        m_pcAckermannWheeledEntity->SetWheel(1,
+                                             DEEPRACER_REAR_RIGHT_WHEEL_POS_WRT_BASE,
+                                             DEEPRACER_WHEEL_RADIUS);
+        m_pcAckermannWheeledEntity->SetWheel(2,
+                                             DEEPRACER_FRONT_LEFT_WHEEL_POS_WRT_BASE,
+                                             DEEPRACER_WHEEL_RADIUS);
+        m_pcAckermannWheeledEntity->SetWheel(3,
+                                             DEEPRACER_FRONT_RIGHT_WHEEL_POS_WRT_BASE,
+                                             DEEPRACER_WHEEL_RADIUS);
+        /* Camera: the deepracer_camera sensor only needs the body, so there is no component */
+        /* LIDAR sensor equipped entity, with its rays when the controller's LIDAR sensor is known */
+        if (s_required.LIDAR) {
             m_pcLIDARSensorEquippedEntity =
                 new CProximitySensorEquippedEntity(this,
                                                    "lidar");
             AddComponent(*m_pcLIDARSensorEquippedEntity);
-            /* RAB equipped entity */
+            if (s_required.LIDARReadings > 0) {
+                CDeepracerLIDARDefaultSensor::AddFan(*m_pcLIDARSensorEquippedEntity,
+                                                     s_required.LIDARReadings,
+                                                     m_pcEmbodiedEntity->GetOriginAnchor());
+            }
+        }
+        /* RAB equipped entity */
+        if (s_required.RAB) {
             m_pcRABEquippedEntity =
                 new CRABEquippedEntity(this,
                                        "rab_0",
@@ -77,24 +147,27 @@ namespace argos {
                                        *m_pcEmbodiedEntity,
                                        CVector3(0.0f, 0.0f, DEEPRACER_BASE_TOP));
             AddComponent(*m_pcRABEquippedEntity);
-            /* Battery equipped entity */
+        }
+        /* Battery equipped entity */
+        if (s_required.Battery) {
             m_pcBatteryEquippedEntity = new CBatteryEquippedEntity(this, "battery_0", str_bat_model);
             AddComponent(*m_pcBatteryEquippedEntity);
-            /* Controllable entity
-                It must be the last one, for actuators/sensors to link to composing entities correctly */
-            m_pcControllableEntity = new CControllableEntity(this, "controller_0");
-            AddComponent(*m_pcControllableEntity);
-            m_pcControllableEntity->SetController(str_controller_id);
-            /* Update components */
-            UpdateComponents();
-        } catch (CARGoSException& ex) {
-            THROW_ARGOSEXCEPTION_NESTED("Failed to initialize entity \"" << GetId() << "\".", ex);
         }
     }
 
     /****************************************/
     /****************************************/
 
+    void CDeepracerEntity::CreateControllableEntity(const std::string& str_controller_id) {
+        m_pcControllableEntity = new CControllableEntity(this, "controller_0");
+        AddComponent(*m_pcControllableEntity);
+        m_pcControllableEntity->SetController(str_controller_id);
+        m_strControllerId = str_controller_id;
+    }
+
+    /****************************************/
+    /****************************************/
+
     void CDeepracerEntity::Init(TConfigurationNode& t_tree) {
         try {
             /*
@@ -104,6 +177,7 @@ namespace argos {
             /*
              * Create and init components
              */
+            CDeepracerInitProfiler::CScope cComponentsProfile(CDeepracerInitProfiler::PHASE_COMPONENTS);
             /* Embodied entity */
             m_pcEmbodiedEntity = new CEmbodiedEntity(this);
             AddComponent(*m_pcEmbodiedEntity);
@@ -123,37 +197,55 @@ namespace argos {
             m_pcAckermannWheeledEntity->SetWheel(3,
                                                  DEEPRACER_FRONT_RIGHT_WHEEL_POS_WRT_BASE,
                                                  DEEPRACER_WHEEL_RADIUS);
-            /* Camera sensor equipped entity */
-            // TODO: populate this
-            /* LIDAR sensor equipped entity */
-            m_pcLIDARSensorEquippedEntity =
-                new CProximitySensorEquippedEntity(this,
-                                                   "lidar");
-            AddComponent(*m_pcLIDARSensorEquippedEntity);
-            /* RAB equipped entity */
+            /* Only create the optional components the controller uses, unless told otherwise */
             Real fRange = 3.0f;
             GetNodeAttributeOrDefault(t_tree, "rab_range", fRange, fRange);
             UInt32 unDataSize = 10;
             GetNodeAttributeOrDefault(t_tree, "rab_data_size", unDataSize, unDataSize);
-            m_pcRABEquippedEntity =
-                new CRABEquippedEntity(this,
-                                       "rab_0",
-                                       unDataSize,
-                                       fRange,
-                                       m_pcEmbodiedEntity->GetOriginAnchor(),
-                                       *m_pcEmbodiedEntity,
-                                       CVector3(0.0f, 0.0f, DEEPRACER_BASE_TOP));
-            AddComponent(*m_pcRABEquippedEntity);
+            bool bLazyComponents = true;
+            GetNodeAttributeOrDefault(t_tree, "lazy_components", bLazyComponents, bLazyComponents);
+            SRequiredComponents sRequired;
+            GetNodeAttribute(GetNode(t_tree, "controller"), "config", m_strControllerId);
+            if (bLazyComponents) {
+                sRequired = GetRequiredComponents(m_strControllerId);
+                sRequired.Battery = sRequired.Battery || NodeExists(t_tree, "battery");
+                LogSkippedComponents(m_strControllerId, sRequired, unDataSize);
+            }
+            /* Camera: the deepracer_camera sensor only needs the body, so there is no component */
+            /* LIDAR sensor equipped entity */
+            if (sRequired.LIDAR) {
+                m_pcLIDARSensorEquippedEntity =
+                    new CProximitySensorEquippedEntity(this,
+                                                       "lidar");
+                AddComponent(*m_pcLIDARSensorEquippedEntity);
+            }
+            /* RAB equipped entity */
+            if (sRequired.RAB) {
+                m_pcRABEquippedEntity =
+                    new CRABEquippedEntity(this,
+                                           "rab_0",
+                                           unDataSize,
+                                           fRange,
+                                           m_pcEmbodiedEntity->GetOriginAnchor(),
+                                           *m_pcEmbodiedEntity,
+                                           CVector3(0.0f, 0.0f, DEEPRACER_BASE_TOP));
+                AddComponent(*m_pcRABEquippedEntity);
+            }
             /* Battery equipped entity */
-            m_pcBatteryEquippedEntity = new CBatteryEquippedEntity(this, "battery_0");
-            if (NodeExists(t_tree, "battery"))
-                m_pcBatteryEquippedEntity->Init(GetNode(t_tree, "battery"));
-            AddComponent(*m_pcBatteryEquippedEntity);
+            if (sRequired.Battery) {
+                m_pcBatteryEquippedEntity = new CBatteryEquippedEntity(this, "battery_0");
+                if (NodeExists(t_tree, "battery"))
+                    m_pcBatteryEquippedEntity->Init(GetNode(t_tree, "battery"));
+                AddComponent(*m_pcBatteryEquippedEntity);
+            }
+            cComponentsProfile.Stop();
             /* Controllable entity
                It must be the last one, for actuators/sensors to link to composing entities correctly */
+            CDeepracerInitProfiler::CScope cControllerProfile(CDeepracerInitProfiler::PHASE_CONTROLLER);
             m_pcControllableEntity = new CControllableEntity(this);
             AddComponent(*m_pcControllableEntity);
             m_pcControllableEntity->Init(GetNode(t_tree, "controller"));
+            cControllerProfile.Stop();
             /* Update components */
             UpdateComponents();
         } catch (CARGoSException& ex) {
@@ -167,6 +259,9 @@ namespace argos {
     void CDeepracerEntity::Reset() {
         /* Reset all components */
         CComposableEntity::Reset();
+        /* Forget the contacts */
+        m_tContacts.clear();
+        m_unNumActiveContacts = 0;
         /* Update components */
         UpdateComponents();
     }
@@ -176,6 +271,13 @@ namespace argos {
 
     void CDeepracerEntity::Destroy() {
         CComposableEntity::Destroy();
+        /* The next robots may belong to another experiment */
+        CSpace::TMapPerTypePerId& tEntities = CSimulator::GetInstance().GetSpace().GetEntityMapPerTypePerId();
+        CSpace::TMapPerTypePerId::iterator itRobots = tEntities.find("deepracer");
+        if (itRobots == tEntities.end() || itRobots->second.size() <= 1) {
+            REQUIRED_COMPONENTS.clear();
+            LOGGED_CONTROLLERS.clear();
+        }
     }
 
     /****************************************/
@@ -184,17 +286,267 @@ namespace argos {
     void CDeepracerEntity::UpdateComponents() {
         // if (m_pcCameraSensorEquippedEntity->IsEnabled())
         //     m_pcCameraSensorEquippedEntity->Update();
-        if (m_pcLIDARSensorEquippedEntity->IsEnabled())
+        if (m_pcLIDARSensorEquippedEntity != NULL && m_pcLIDARSensorEquippedEntity->IsEnabled())
             m_pcLIDARSensorEquippedEntity->Update();
-        if (m_pcRABEquippedEntity->IsEnabled())
+        if (m_pcRABEquippedEntity != NULL && m_pcRABEquippedEntity->IsEnabled())
             m_pcRABEquippedEntity->Update();
-        if (m_pcBatteryEquippedEntity->IsEnabled())
+        if (m_pcBatteryEquippedEntity != NULL && m_pcBatteryEquippedEntity->IsEnabled())
             m_pcBatteryEquippedEntity->Update();
     }
 
     /****************************************/
     /****************************************/
 
+    CDeepracerEntity::SRequiredComponents CDeepracerEntity::GetRequiredComponents(const std::string& str_controller_id) {
+        /* The configuration does not change during an experiment: scan each controller once */
+        std::map<std::string, SRequiredComponents>::iterator itCached = REQUIRED_COMPONENTS.find(str_controller_id);
+        if (itCached != REQUIRED_COMPONENTS.end()) return itCached->second;
+        SRequiredComponents& sRequired = REQUIRED_COMPONENTS[str_controller_id];
+        /* Look for the controller; if it's not there, keep everything and let the controllable entity complain */
+        TConfigurationNode& tRoot = CSimulator::GetInstance().GetConfigurationRoot();
+        if (!NodeExists(tRoot, "controllers")) return sRequired;
+        TConfigurationNode& tControllers = GetNode(tRoot, "controllers");
+        TConfigurationNodeIterator itController;
+        for (itController = itController.begin(&tControllers);
+             itController != itController.end();
+             ++itController) {
+            std::string strId;
+            GetNodeAttributeOrDefault(*itController, "id", strId, strId);
+            if (strId == str_controller_id) break;
+        }
+        if (itController == itController.end()) return sRequired;
+        /* Collect the names of the sensors and actuators */
+        std::set<std::string> setDevices;
+        const char* ppchSections[] = {"sensors", "actuators"};
+        for (UInt32 i = 0; i < 2; ++i) {
+            if (!NodeExists(*itController, ppchSections[i])) continue;
+            TConfigurationNodeIterator itDevice;
+            for (itDevice = itDevice.begin(&GetNode(*itController, ppchSections[i]));
+                 itDevice != itDevice.end();
+                 ++itDevice) {
+                setDevices.insert(itDevice->Value());
+                if (itDevice->Value() == "deepracer_lidar") {
+                    sRequired.LIDARReadings = DEEPRACER_LIDAR_DEFAULT_NUM_READINGS;
+                    GetNodeAttributeOrDefault(*itDevice, "num_readings", sRequired.LIDARReadings, sRequired.LIDARReadings);
+                }
+            }
+        }
+        sRequired.LIDAR   = setDevices.count("deepracer_lidar") > 0;
+        sRequired.RAB     = setDevices.count("range_and_bearing") > 0;
+        sRequired.Battery = setDevices.count("battery") > 0;
+        return sRequired;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerEntity::LogSkippedComponents(const std::string& str_controller_id,
+                                                const SRequiredComponents& s_required,
+                                                size_t un_rab_data_size) {
+        if (!LOGGED_CONTROLLERS.insert(str_controller_id).second) return;
+        /* Memory that is not allocated for each robot; per-tick updates are skipped as well */
+        std::vector<std::string> vecSkipped;
+        size_t unBytes = 0;
+        if (!s_required.LIDAR) {
+            vecSkipped.push_back("LIDAR");
+            unBytes += sizeof(CProximitySensorEquippedEntity);
+        }
+        if (!s_required.RAB) {
+            vecSkipped.push_back("range-and-bearing");
+            unBytes += sizeof(CRABEquippedEntity) + un_rab_data_size;
+        }
+        if (!s_required.Battery) {
+            vecSkipped.push_back("battery");
+            unBytes += sizeof(CBatteryEquippedEntity);
+        }
+        if (vecSkipped.empty()) return;
+        LOG << "[INFO] DeepRacers with controller \"" << str_controller_id
+            << "\" are created without the components their controller does not use (";
+        for (size_t i = 0; i < vecSkipped.size(); ++i) {
+            LOG << (i > 0 ? ", " : "") << vecSkipped[i];
+        }
+        LOG << "): about " << unBytes << " bytes and "
+            << vecSkipped.size() << " component updates saved per robot and per step"
+            << std::endl;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    std::vector<CDeepracerEntity*> CDeepracerEntity::SpawnMany(const SSpawnTemplate& s_template,
+                                                               UInt32 un_count,
+                                                               const CVector2& c_area_min,
+                                                               const CVector2& c_area_max,
+                                                               CRandom::CRNG* pc_rng) {
+        CSpace& cSpace = CSimulator::GetInstance().GetSpace();
+        if (pc_rng == NULL) pc_rng = CRandom::CreateRNG("argos");
+        Real fRadius = DEEPRACER_BASE_RADIUS + s_template.Clearance;
+        /*
+         * Obstacles: bounding boxes of the existing bodies, walls of the tracks
+         */
+        CDeepracerSpatialHash cHash(2.0 * fRadius);
+        CSpace::TMapPerType& tEntities = cSpace.GetEntityMapPerId();
+        for (CSpace::TMapPerType::iterator it = tEntities.begin(); it != tEntities.end(); ++it) {
+            CEntity* pcEntity = any_cast<CEntity*>(it->second);
+            if (pcEntity->HasParent()) continue;
+            if (CDeepracerTrackEntity* pcTrack = dynamic_cast<CDeepracerTrackEntity*>(pcEntity)) {
+                const SAnchor& sOrigin = pcTrack->GetEmbodiedEntity().GetOriginAnchor();
+                CRadians cZAngle, cYAngle, cXAngle;
+                sOrigin.Orientation.ToEulerAngles(cZAngle, cYAngle, cXAngle);
+                CVector2 cOffset(sOrigin.Position.GetX(), sOrigin.Position.GetY());
+                const CDeepracerSegmentBVH::TSegments& tWalls = pcTrack->GetWalls().GetSegments();
+                for (size_t i = 0; i < tWalls.size(); ++i) {
+                    CVector2 cStart(tWalls[i].Start), cEnd(tWalls[i].End);
+                    cHash.AddSegment(cStart.Rotate(cZAngle) + cOffset,
+                                     cEnd.Rotate(cZAngle) + cOffset,
+                                     pcTrack->GetWalls().GetRadius());
+                }
+                continue;
+            }
+            CComposableEntity* pcComposable = dynamic_cast<CComposableEntity*>(pcEntity);
+            if (pcComposable != NULL && pcComposable->HasComponent("body")) {
+                const SBoundingBox& sBox = pcComposable->GetComponent<CEmbodiedEntity>("body").GetBoundingBox();
+                cHash.AddBox(CVector2(sBox.MinCorner.GetX(), sBox.MinCorner.GetY()),
+                             CVector2(sBox.MaxCorner.GetX(), sBox.MaxCorner.GetY()));
+            }
+        }
+        /*
+         * Placement: all the poses are found before anything is created
+         */
+        CRange<Real> cRangeX(c_area_min.GetX() + fRadius, c_area_max.GetX() - fRadius);
+        CRange<Real> cRangeY(c_area_min.GetY() + fRadius, c_area_max.GetY() - fRadius);
+        if (cRangeX.GetSpan() < 0.0 || cRangeY.GetSpan() < 0.0) {
+            THROW_ARGOSEXCEPTION("The spawn area is smaller than a DeepRacer");
+        }
+        CDeepracerInitProfiler::CScope cPlacementProfile(CDeepracerInitProfiler::PHASE_PLACEMENT, un_count);
+        std::vector<CVector3>    vecPositions;
+        std::vector<CQuaternion> vecOrientations;
+        std::vector<std::string> vecIds;
+        vecPositions.reserve(un_count);
+        vecOrientations.reserve(un_count);
+        vecIds.reserve(un_count);
+        UInt32 unNextId = 0;
+        for (UInt32 i = 0; i < un_count; ++i) {
+            CVector2 cPos;
+            UInt32 unTrials = 0;
+            do {
+                if (++unTrials > s_template.MaxTrials) {
+                    THROW_ARGOSEXCEPTION("Can't place DeepRacer " << i << " of " << un_count << " after " << s_template.MaxTrials << " trials; no robot was created");
+                }
+                cPos.Set(pc_rng->Uniform(cRangeX), pc_rng->Uniform(cRangeY));
+            } while (!cHash.IsFree(cPos, fRadius));
+            cHash.AddCircle(cPos, fRadius);
+            vecPositions.push_back(CVector3(cPos.GetX(), cPos.GetY(), 0.0));
+            vecOrientations.push_back(CQuaternion(pc_rng->Uniform(CRadians::UNSIGNED_RANGE), CVector3::Z));
+            /* Skip the ids that are taken */
+            std::string strId;
+            do {
+                strId = s_template.IdPrefix + std::to_string(unNextId++);
+            } while (tEntities.count(strId) > 0);
+            vecIds.push_back(strId);
+        }
+        cPlacementProfile.Stop();
+        /*
+         * Components: each robot only touches its own, so they are built in parallel
+         */
+        SRequiredComponents sRequired = GetRequiredComponents(s_template.ControllerId);
+        sRequired.Battery = sRequired.Battery || !s_template.BatteryModel.empty();
+        LogSkippedComponents(s_template.ControllerId, sRequired, s_template.RABDataSize);
+        UInt32 unNumThreads = s_template.NumThreads;
+        if (unNumThreads == 0) unNumThreads = Max<UInt32>(std::thread::hardware_concurrency(), 1);
+        unNumThreads = Max<UInt32>(Min(unNumThreads, un_count), 1);
+        std::vector<CDeepracerEntity*> vecRobots(un_count, NULL);
+        std::vector<std::string> vecErrors(unNumThreads);
+        auto CreateComponentsOf = [&](UInt32 un_thread) {
+            UInt32 i = un_thread;
+            try {
+                for (; i < un_count; i += unNumThreads) {
+                    vecRobots[i] = new CDeepracerEntity(vecIds[i]);
+                    vecRobots[i]->CreateComponents(vecPositions[i],
+                                                   vecOrientations[i],
+                                                   s_template.RABRange,
+                                                   s_template.RABDataSize,
+                                                   s_template.BatteryModel,
+                                                   sRequired);
+                }
+            } catch (std::exception& ex) {
+                vecErrors[un_thread] = "Failed to initialize entity \"" + vecIds[i] + "\": " + ex.what();
+            }
+        };
+        CDeepracerInitProfiler::CScope cComponentsProfile(CDeepracerInitProfiler::PHASE_COMPONENTS, un_count);
+        std::vector<std::thread> vecThreads;
+        for (UInt32 t = 1; t < unNumThreads; ++t) {
+            vecThreads.push_back(std::thread(CreateComponentsOf, t));
+        }
+        CreateComponentsOf(0);
+        for (size_t t = 0; t < vecThreads.size(); ++t) {
+            vecThreads[t].join();
+        }
+        cComponentsProfile.Stop();
+        /* Nothing is in the space yet: on failure, drop all the robots */
+        auto DiscardRobots = [&vecRobots]() {
+            for (size_t i = 0; i < vecRobots.size(); ++i) {
+                if (vecRobots[i] == NULL) continue;
+                vecRobots[i]->Destroy();
+                delete vecRobots[i];
+            }
+        };
+        for (UInt32 t = 0; t < unNumThreads; ++t) {
+            if (!vecErrors[t].empty()) {
+                DiscardRobots();
+                THROW_ARGOSEXCEPTION(vecErrors[t]);
+            }
+        }
+        /*
+         * Controllers: sensors and actuators may share state (random
+         * generators, the space), so they are created one robot at a time
+         */
+        CDeepracerInitProfiler::CScope cControllerProfile(CDeepracerInitProfiler::PHASE_CONTROLLER, un_count);
+        for (UInt32 i = 0; i < un_count; ++i) {
+            try {
+                vecRobots[i]->CreateControllableEntity(s_template.ControllerId);
+                vecRobots[i]->UpdateComponents();
+            } catch (CARGoSException& ex) {
+                DiscardRobots();
+                THROW_ARGOSEXCEPTION_NESTED("Failed to initialize entity \"" << vecIds[i] << "\".", ex);
+            }
+        }
+        cControllerProfile.Stop();
+        /*
+         * Insertion in the space and the physics engines
+         */
+        CDeepracerInitProfiler::CScope cSpaceProfile(CDeepracerInitProfiler::PHASE_SPACE, un_count);
+        for (UInt32 i = 0; i < un_count; ++i) {
+            CallEntityOperation<CSpaceOperationAddEntity, CSpace, void>(cSpace, *vecRobots[i]);
+        }
+        cSpaceProfile.Stop();
+        std::ostringstream cProfile;
+        CDeepracerInitProfiler::Print(cProfile);
+        LOG << cProfile.str();
+        return vecRobots;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    std::vector<CDeepracerEntity*> CDeepracerEntity::CollectDeepracers() {
+        std::vector<CDeepracerEntity*> vecRobots;
+        CSpace::TMapPerTypePerId& tEntities = CSimulator::GetInstance().GetSpace().GetEntityMapPerTypePerId();
+        CSpace::TMapPerTypePerId::iterator itRobots = tEntities.find("deepracer");
+        if (itRobots == tEntities.end()) return vecRobots;
+        vecRobots.reserve(itRobots->second.size());
+        /* The map is sorted by id */
+        for (CSpace::TMapPerType::iterator it = itRobots->second.begin();
+             it != itRobots->second.end();
+             ++it) {
+            vecRobots.push_back(any_cast<CDeepracerEntity*>(it->second));
+        }
+        return vecRobots;
+    }
+
+    /****************************************/
+    /****************************************/
+
     REGISTER_ENTITY(CDeepracerEntity,
                     "deepracer",
                     "Carlo Pinciroli [ilpincy@gmail.com], Khai Yi Chin [khaiyichin@gmail.com]",
@@ -288,7 +640,48 @@ namespace argos {
                     "                                   orient_factor=\"1e-3\"/>\n"
                     "    </deepracer>\n"
                     "    ...\n"
-                    "  </arena>\n\n",
+                    "  </arena>\n\n"
+                    "The LIDAR, range-and-bearing and battery components are created only if the\n"
+                    "controller lists a sensor or actuator that uses them (deepracer_lidar,\n"
+                    "range_and_bearing, battery), or, for the battery, if a <battery> node is\n"
+                    "given. The components that are left out are reported once per\n"
+                    "controller at startup. If loop functions access the components directly,\n"
+                    "you can create all of them with the 'lazy_components' attribute:\n\n"
+                    "  <arena ...>\n"
+                    "    ...\n"
+                    "    <deepracer id=\"dr0\" lazy_components=\"false\">\n"
+                    "      <body position=\"0.4,2.3,0.25\" orientation=\"45,0,0\" />\n"
+                    "      <controller config=\"mycntrl\" />\n"
+                    "    </deepracer>\n"
+                    "    ...\n"
+                    "  </arena>\n\n"
+                    "By default, the dynamics2d engine drives the body to the velocities given by\n"
+                    "the Ackermann kinematics, which is stable only with small ticks. You can\n"
+                    "switch to a dynamic single-track model with lateral tire forces and slip,\n"
+                    "whose velocities are integrated in sub-steps adapted to the speed and\n"
+                    "steering rate, so that they stay stable with a coarse tick also when\n"
+                    "cornering fast. The engine still moves the pose once per tick:\n\n"
+                    "  <arena ...>\n"
+                    "    ...\n"
+                    "    <deepracer id=\"dr0\">\n"
+                    "      <body position=\"0.4,2.3,0.25\" orientation=\"45,0,0\" />\n"
+                    "      <controller config=\"mycntrl\" />\n"
+                    "      <dynamics2d>\n"
+                    "        <ackermann_steering model=\"dynamic\"\n"
+                    "                            cornering_stiffness_front=\"40\"\n"
+                    "                            cornering_stiffness_rear=\"40\"\n"
+                    "                            friction=\"0.7\"\n"
+                    "                            throttle_time_constant=\"0.1\"\n"
+                    "                            kinematic_speed=\"0.3\"\n"
+                    "                            max_steering_per_substep=\"0.02\"\n"
+                    "                            max_substeps=\"100\" />\n"
+                    "      </dynamics2d>\n"
+                    "    </deepracer>\n"
+                    "    ...\n"
+                    "  </arena>\n\n"
+                    "Cornering stiffnesses are in N/rad, the throttle time constant in s, the\n"
+                    "kinematic speed (below which the kinematic model is used) in m/s and the\n"
+                    "steering limit per sub-step in rad. All attributes are optional.\n\n",
                     "Under development");
 
     /****************************************/
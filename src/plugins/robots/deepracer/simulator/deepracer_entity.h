@@ -11,6 +11,9 @@ namespace argos {
 }
 
 #include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/utility/math/rng.h>
+
+#include <vector>
 
 #include "ackermann_wheeled_entity.h" // TODO: fix path when the CAckermannWheeledEntity class gets integrated to the main ARGoS3 code
 
@@ -21,6 +24,60 @@ namespace argos {
 
         ENABLE_VTABLE();
 
+        /**
+         * A contact event reported by the physics engine.
+         */
+        struct SContact {
+            /** True when the contact started, false when it ended */
+            bool     Begin;
+            /** Root entity touched, NULL if it could not be determined */
+            CEntity* Other;
+            /** Impulse exchanged in the first step of the contact [N*s] */
+            Real     Impulse;
+        };
+
+        typedef std::vector<SContact> TContacts;
+
+        /**
+         * The optional components a controller needs.
+         */
+        struct SRequiredComponents {
+            bool   LIDAR;
+            bool   RAB;
+            bool   Battery;
+            /** Rays of the deepracer_lidar sensor, 0 if the controller does not use it */
+            UInt32 LIDARReadings;
+
+            SRequiredComponents() :
+                LIDAR(true), RAB(true), Battery(true), LIDARReadings(0) {}
+        };
+
+        /**
+         * The parameters shared by the robots created with SpawnMany().
+         */
+        struct SSpawnTemplate {
+            /** The robot ids are the prefix followed by a number */
+            std::string IdPrefix;
+            std::string ControllerId;
+            Real        RABRange;
+            size_t      RABDataSize;
+            std::string BatteryModel;
+            /** Minimum free space around the footprint of each robot [m] */
+            Real        Clearance;
+            /** Placement attempts per robot before giving up */
+            UInt32      MaxTrials;
+            /** Threads creating the components, 0 for one per core */
+            UInt32      NumThreads;
+
+            SSpawnTemplate() :
+                IdPrefix("dr"),
+                RABRange(3.0),
+                RABDataSize(10),
+                Clearance(0.05),
+                MaxTrials(100),
+                NumThreads(0) {}
+        };
+
     public:
 
         CDeepracerEntity();
@@ -47,22 +104,148 @@ namespace argos {
             return *m_pcEmbodiedEntity;
         }
 
+        /**
+         * Returns the id of the controller in the <controllers> section.
+         */
+        inline const std::string& GetControllerId() const {
+            return m_strControllerId;
+        }
+
+        /**
+         * Returns the LIDAR component. It exists only if the controller uses it,
+         * check with HasLIDARSensorEquippedEntity().
+         */
         inline CProximitySensorEquippedEntity& GetLIDARSensorEquippedEntity() {
             return *m_pcLIDARSensorEquippedEntity;
         }
 
+        inline bool HasLIDARSensorEquippedEntity() const {
+            return m_pcLIDARSensorEquippedEntity != NULL;
+        }
+
+        /**
+         * Returns the RAB component. It exists only if the controller uses it,
+         * check with HasRABEquippedEntity().
+         */
         inline CRABEquippedEntity& GetRABEquippedEntity() {
             return *m_pcRABEquippedEntity;
         }
 
+        inline bool HasRABEquippedEntity() const {
+            return m_pcRABEquippedEntity != NULL;
+        }
+
+        /**
+         * Returns the battery component. It exists only if the controller or the
+         * configuration uses it, check with HasBatteryEquippedEntity().
+         */
+        inline CBatteryEquippedEntity& GetBatteryEquippedEntity() {
+            return *m_pcBatteryEquippedEntity;
+        }
+
+        inline bool HasBatteryEquippedEntity() const {
+            return m_pcBatteryEquippedEntity != NULL;
+        }
+
         inline CAckermannWheeledEntity& GetWheeledEntity() {
             return *m_pcAckermannWheeledEntity;
         }
 
+        /**
+         * Returns the contacts that started or ended in the last physics step.
+         * The list is written only by the engine the robot belongs to, so it
+         * can be read without locks once the physics step is over.
+         */
+        inline TContacts& GetContacts() {
+            return m_tContacts;
+        }
+
+        inline const TContacts& GetContacts() const {
+            return m_tContacts;
+        }
+
+        /**
+         * Returns the number of contacts still open at the end of the last step.
+         */
+        inline UInt32 GetNumActiveContacts() const {
+            return m_unNumActiveContacts;
+        }
+
+        inline void SetNumActiveContacts(UInt32 un_num_contacts) {
+            m_unNumActiveContacts = un_num_contacts;
+        }
+
         virtual std::string GetTypeDescription() const {
             return "deepracer";
         }
 
+        /**
+         * Creates un_count robots from a template and adds them to the space.
+         *
+         * Positions and orientations are drawn uniformly in the given area,
+         * rejecting the ones whose footprint overlaps existing bodies, track
+         * walls or robots placed earlier; the candidates are checked against
+         * a spatial hash, so each check only looks at nearby obstacles. All
+         * the robots are placed before any is created, so on failure the
+         * space is left untouched.
+         *
+         * The robots are then built in three phases: the components (body,
+         * wheels, LIDAR fan, RAB, battery) of all robots in parallel, then the
+         * controllers, whose sensors and actuators may share state, and
+         * finally the insertion in the space and physics engines, one robot
+         * at a time. The time of each phase is logged.
+         * @param pc_rng the generator for the placement; if NULL, one in the "argos" category is used.
+         * @return the created robots.
+         * @throws CARGoSException if a robot can't be placed within the allowed trials.
+         */
+        static std::vector<CDeepracerEntity*> SpawnMany(const SSpawnTemplate& s_template,
+                                                        UInt32 un_count,
+                                                        const CVector2& c_area_min,
+                                                        const CVector2& c_area_max,
+                                                        CRandom::CRNG* pc_rng = NULL);
+
+        /**
+         * Returns the DeepRacers in the space, sorted by id.
+         */
+        static std::vector<CDeepracerEntity*> CollectDeepracers();
+
+    private:
+
+        /**
+         * Creates a robot without components, for SpawnMany().
+         */
+        explicit CDeepracerEntity(const std::string& str_id);
+
+        /**
+         * Creates all the components but the controllable entity.
+         * Touches nothing outside the robot, so robots can be built in parallel.
+         */
+        void CreateComponents(const CVector3&            c_position,
+                              const CQuaternion&         c_orientation,
+                              Real                       f_rab_range,
+                              size_t                     un_rab_data_size,
+                              const std::string&         str_bat_model,
+                              const SRequiredComponents& s_required);
+
+        /**
+         * Creates the controllable entity and its controller. It must come
+         * last, for sensors and actuators to find the other components.
+         */
+        void CreateControllableEntity(const std::string& str_controller_id);
+
+        /**
+         * Finds the components referenced by the sensors and actuators of the
+         * given controller in the <controllers> section of the configuration.
+         */
+        static SRequiredComponents GetRequiredComponents(const std::string& str_controller_id);
+
+        /**
+         * Logs, once per controller and experiment, the components that were not created.
+         */
+        static void LogSkippedComponents(const std::string& str_controller_id,
+                                         const SRequiredComponents& s_required,
+                                         size_t un_rab_data_size);
+
     private:
 
         CControllableEntity*            m_pcControllableEntity;
@@ -71,6 +254,9 @@ namespace argos {
         CRABEquippedEntity*             m_pcRABEquippedEntity;
         CAckermannWheeledEntity*        m_pcAckermannWheeledEntity;
         CBatteryEquippedEntity*         m_pcBatteryEquippedEntity;
+        TContacts                       m_tContacts;
+        UInt32                          m_unNumActiveContacts;
+        std::string                     m_strControllerId;
     };
 }
 
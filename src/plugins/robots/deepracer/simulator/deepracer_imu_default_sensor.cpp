@@ -2,6 +2,7 @@
 
 #include <argos3/core/simulator/entity/composable_entity.h>
 #include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
 #include <argos3/core/simulator/simulator.h>
 
 namespace argos {
@@ -38,14 +39,8 @@ namespace argos {
                 m_pcRNG     = CRandom::CreateRNG("argos");
             }
 
-            /* Populate the number of ticks in one second */
-            UInt32 nNumTicksPerSec;
-
-            TConfigurationNode& tNode =
-                GetNode(GetNode(CSimulator::GetInstance().GetConfigurationRoot(), "framework"), "experiment");
-            GetNodeAttribute(tNode, "ticks_per_second", nNumTicksPerSec);
-
-            m_fNumTicksPerSec = static_cast<Real>(nNumTicksPerSec);
+            /* Populate the number of ticks in one second, already parsed by the simulator */
+            m_fNumTicksPerSec = CPhysicsEngine::GetInverseSimulationClockTick();
 
             /* sensor is enabled by default */
             Enable();
@@ -106,6 +101,26 @@ namespace argos {
     /****************************************/
     /****************************************/
 
+    void CDeepracerIMUDefaultSensor::GetState(SState& s_state) const {
+        s_state.Position     = m_cCurrentPosition;
+        s_state.Orientation  = m_cCurrentOrientation;
+        s_state.LinVel       = m_cCurrentLinVel;
+        s_state.PreviousTime = m_fPreviousTime;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerIMUDefaultSensor::SetState(const SState& s_state) {
+        m_cCurrentPosition    = s_state.Position;
+        m_cCurrentOrientation = s_state.Orientation;
+        m_cCurrentLinVel      = s_state.LinVel;
+        m_fPreviousTime       = s_state.PreviousTime;
+    }
+
+    /****************************************/
+    /****************************************/
+
     REGISTER_SENSOR(CDeepracerIMUDefaultSensor,
                     "deepracer_imu", "default",
                     "Carlo Pinciroli [ilpincy@gmail.com], Khai Yi Chin [khaiyichin@gmail.com]",
@@ -33,6 +33,16 @@ namespace argos {
             }
         };
 
+        /**
+         * Internal state used to differentiate the pose, e.g., to store it in a snapshot.
+         */
+        struct SState {
+            CVector3    Position;
+            CQuaternion Orientation;
+            CVector3    LinVel;
+            Real        PreviousTime;
+        };
+
     public:
 
         CDeepracerIMUDefaultSensor();
@@ -47,6 +57,10 @@ namespace argos {
 
         virtual void Reset();
 
+        void GetState(SState& s_state) const;
+
+        void SetState(const SState& s_state);
+
     protected:
 
         /** Reference to embodied entity associated to this sensor */
@@ -0,0 +1,81 @@
+#include "deepracer_init_profiler.h"
+
+#include <iomanip>
+#include <mutex>
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    static const char* PHASE_NAMES[CDeepracerInitProfiler::NUM_PHASES] = {
+        "placement",
+        "components",
+        "controller",
+        "physics",
+        "space"
+    };
+
+    static std::mutex s_cMutex;
+    static Real       s_pfSeconds[CDeepracerInitProfiler::NUM_PHASES] = {};
+    static UInt32     s_punRobots[CDeepracerInitProfiler::NUM_PHASES] = {};
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerInitProfiler::Add(EPhase e_phase,
+                                     Real f_seconds,
+                                     UInt32 un_robots) {
+        std::lock_guard<std::mutex> cLock(s_cMutex);
+        s_pfSeconds[e_phase] += f_seconds;
+        s_punRobots[e_phase] += un_robots;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    Real CDeepracerInitProfiler::GetSeconds(EPhase e_phase) {
+        std::lock_guard<std::mutex> cLock(s_cMutex);
+        return s_pfSeconds[e_phase];
+    }
+
+    /****************************************/
+    /****************************************/
+
+    UInt32 CDeepracerInitProfiler::GetNumRobots(EPhase e_phase) {
+        std::lock_guard<std::mutex> cLock(s_cMutex);
+        return s_punRobots[e_phase];
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerInitProfiler::Reset() {
+        std::lock_guard<std::mutex> cLock(s_cMutex);
+        for (UInt32 i = 0; i < NUM_PHASES; ++i) {
+            s_pfSeconds[i] = 0.0;
+            s_punRobots[i] = 0;
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerInitProfiler::Print(std::ostream& c_stream) {
+        std::lock_guard<std::mutex> cLock(s_cMutex);
+        c_stream << "[INFO] DeepRacer initialization time:" << std::endl;
+        for (UInt32 i = 0; i < NUM_PHASES; ++i) {
+            if (s_punRobots[i] == 0) continue;
+            c_stream << "[INFO]   " << std::setw(12) << std::left << PHASE_NAMES[i] << std::right
+                     << std::fixed << std::setprecision(3)
+                     << std::setw(10) << s_pfSeconds[i] << " s for "
+                     << s_punRobots[i] << " robots ("
+                     << std::setprecision(3) << (1000.0 * s_pfSeconds[i] / s_punRobots[i]) << " ms/robot)"
+                     << std::endl;
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
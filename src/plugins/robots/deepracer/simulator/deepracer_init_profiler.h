@@ -0,0 +1,96 @@
+#ifndef DEEPRACER_INIT_PROFILER_H
+#define DEEPRACER_INIT_PROFILER_H
+
+namespace argos {
+    class CDeepracerInitProfiler;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <chrono>
+#include <ostream>
+
+namespace argos {
+
+    /**
+     * Wall-clock time spent in the phases of DeepRacer initialization,
+     * accumulated over all the robots created in the process.
+     *
+     * The phases are timed where they happen: the entity (XML or
+     * SpawnMany()), the dynamics2d model and the space insertion of
+     * SpawnMany(). Phases run in parallel by SpawnMany() are timed once,
+     * around the whole parallel section.
+     */
+    class CDeepracerInitProfiler {
+    public:
+
+        enum EPhase {
+            /** Finding free poses (SpawnMany() only) */
+            PHASE_PLACEMENT = 0,
+            /** Body, wheels, LIDAR fan, RAB and battery */
+            PHASE_COMPONENTS,
+            /** Controller creation, sensor and actuator Init() */
+            PHASE_CONTROLLER,
+            /** Chipmunk bodies, shapes and constraints */
+            PHASE_PHYSICS,
+            /** Insertion in the space and the physics engines (SpawnMany() only) */
+            PHASE_SPACE,
+            NUM_PHASES
+        };
+
+        /**
+         * Adds the time between its construction and destruction to a phase.
+         */
+        class CScope {
+        public:
+            CScope(EPhase e_phase,
+                   UInt32 un_robots = 1) :
+                m_ePhase(e_phase),
+                m_unRobots(un_robots),
+                m_tStart(std::chrono::steady_clock::now()) {}
+
+            ~CScope() {
+                Stop();
+            }
+
+            /**
+             * Adds the elapsed time now rather than at destruction.
+             */
+            void Stop() {
+                if (m_unRobots == 0) return;
+                Add(m_ePhase,
+                    std::chrono::duration<Real>(std::chrono::steady_clock::now() - m_tStart).count(),
+                    m_unRobots);
+                m_unRobots = 0;
+            }
+
+        private:
+            EPhase                                m_ePhase;
+            UInt32                                m_unRobots;
+            std::chrono::steady_clock::time_point m_tStart;
+        };
+
+    public:
+
+        /**
+         * Adds f_seconds and un_robots to a phase. Thread-safe.
+         */
+        static void Add(EPhase e_phase,
+                        Real f_seconds,
+                        UInt32 un_robots);
+
+        static Real GetSeconds(EPhase e_phase);
+
+        static UInt32 GetNumRobots(EPhase e_phase);
+
+        static void Reset();
+
+        /**
+         * Prints the time per phase, in total and per robot.
+         */
+        static void Print(std::ostream& c_stream);
+    };
+
+}
+
+#endif
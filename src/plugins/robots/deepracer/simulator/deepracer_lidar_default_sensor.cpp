@@ -3,17 +3,25 @@
 #include <argos3/core/simulator/entity/composable_entity.h>
 #include <argos3/core/simulator/entity/embodied_entity.h>
 #include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
 #include <argos3/plugins/simulator/entities/proximity_sensor_equipped_entity.h>
 
 #include "deepracer_measures.h"
+#include "deepracer_track_entity.h"
 
 namespace argos {
 
     /****************************************/
     /****************************************/
 
+    /* Fraction of the distance to the closest wall the engine rays stop short of */
+    static const Real TRACK_RAY_CLEARANCE = 1e-6;
+
+    /****************************************/
+    /****************************************/
+
     CDeepracerLIDARDefaultSensor::CDeepracerLIDARDefaultSensor() : m_pfReadings(NULL),
-                                                                   m_unNumReadings(600),
+                                                                   m_unNumReadings(DEEPRACER_LIDAR_DEFAULT_NUM_READINGS),
                                                                    m_pcEmbodiedEntity(NULL),
                                                                    m_bShowRays(false),
                                                                    m_bPowerStateOn(true),
@@ -44,31 +52,49 @@ namespace argos {
     /****************************************/
     /****************************************/
 
+    void CDeepracerLIDARDefaultSensor::AddFan(CProximitySensorEquippedEntity& c_entity,
+                                              UInt32 un_num_readings,
+                                              SAnchor& s_anchor) {
+        c_entity.AddSensorFan(
+            CVector3(DEEPRACER_LIDAR_POS_X_WRT_BASE, 0.0, DEEPRACER_LIDAR_POS_Z_WRT_BASE),
+            DEEPRACER_LIDAR_SENSORS_FAN_RADIUS + DEEPRACER_LIDAR_SENSORS_RING_RANGE.GetMin(),
+            DEEPRACER_LIDAR_ANGLE_START,
+            DEEPRACER_LIDAR_ANGLE_END,
+            DEEPRACER_LIDAR_SENSORS_FAN_RADIUS + DEEPRACER_LIDAR_SENSORS_RING_RANGE.GetMax(),
+            un_num_readings,
+            s_anchor);
+    }
+
+    /****************************************/
+    /****************************************/
+
     void CDeepracerLIDARDefaultSensor::Init(TConfigurationNode& t_tree) {
         try {
             CCI_DeepracerLIDARSensor::Init(t_tree);
             /* How many readings? */
             GetNodeAttributeOrDefault(t_tree, "num_readings", m_unNumReadings, m_unNumReadings);
-            m_pcProximityEntity->AddSensorFan(
-                CVector3(DEEPRACER_LIDAR_POS_X_WRT_BASE, 0.0, DEEPRACER_LIDAR_POS_Z_WRT_BASE),
-                DEEPRACER_LIDAR_SENSORS_FAN_RADIUS + DEEPRACER_LIDAR_SENSORS_RING_RANGE.GetMin(),
-                DEEPRACER_LIDAR_ANGLE_START,
-                DEEPRACER_LIDAR_ANGLE_END,
-                DEEPRACER_LIDAR_SENSORS_FAN_RADIUS + DEEPRACER_LIDAR_SENSORS_RING_RANGE.GetMax(),
-                m_unNumReadings,
-                m_pcEmbodiedEntity->GetOriginAnchor());
+            /* The fan may have been built with the entity already (see CDeepracerEntity::SpawnMany()) */
+            if (m_pcProximityEntity->GetNumSensors() == 0) {
+                AddFan(*m_pcProximityEntity, m_unNumReadings, m_pcEmbodiedEntity->GetOriginAnchor());
+            } else if (m_pcProximityEntity->GetNumSensors() != m_unNumReadings) {
+                THROW_ARGOSEXCEPTION("The LIDAR of the robot has " << m_pcProximityEntity->GetNumSensors() <<
+                                     " rays, but " << m_unNumReadings << " readings were requested");
+            }
+            /* Init() runs again when a checkpoint branch changes the parameters */
+            delete[] m_pfReadings;
             m_pfReadings = new Real[m_unNumReadings];
             /* Show rays? */
             GetNodeAttributeOrDefault(t_tree, "show_rays", m_bShowRays, m_bShowRays);
             /* Parse noise level */
             Real fNoiseLevel = 0.0f;
             GetNodeAttributeOrDefault(t_tree, "noise_level", fNoiseLevel, fNoiseLevel);
+            m_bAddNoise = false;
             if (fNoiseLevel < 0.0f) {
                 THROW_ARGOSEXCEPTION("Can't specify a negative value for the noise level of the proximity sensor");
             } else if (fNoiseLevel > 0.0f) {
                 m_bAddNoise = true;
                 m_cNoiseRange.Set(-fNoiseLevel, fNoiseLevel);
-                m_pcRNG = CRandom::CreateRNG("argos");
+                if (m_pcRNG == NULL) m_pcRNG = CRandom::CreateRNG("argos");
             }
         } catch (CARGoSException& ex) {
             THROW_ARGOSEXCEPTION_NESTED("Initialization error in default proximity sensor", ex);
@@ -87,6 +113,8 @@ namespace argos {
         CVector3 cRayStart, cRayEnd;
         /* Buffers to contain data about the intersection */
         SEmbodiedEntityIntersectionItem sIntersection;
+        /* Tracks are queried through their own BVH first */
+        UpdateTracks();
         /* Go through the sensors */
         for (UInt32 i = 0; i < m_unNumReadings; ++i) {
             /* Compute ray for sensor i */
@@ -99,18 +127,39 @@ namespace argos {
             cRayEnd += m_pcProximityEntity->GetSensor(i).Anchor.Position;
             cScanningRay.Set(cRayStart, cRayEnd);
             /* Compute reading */
+            /* Closest wall, if any: the engines then only need to look for closer objects */
+            Real fTrackT = 1.0;
+            bool bTrackHit = false;
+            for (size_t j = 0; j < m_vecTracks.size(); ++j) {
+                Real fT;
+                if (m_vecTracks[j]->IntersectRay(cScanningRay, fT) && fT < fTrackT) {
+                    fTrackT   = fT;
+                    bTrackHit = true;
+                }
+            }
+            Real fEngineT = bTrackHit ? fTrackT * (1.0 - TRACK_RAY_CLEARANCE) : 1.0;
             /* Get the closest intersection */
-            if (GetClosestEmbodiedEntityIntersectedByRay(sIntersection,
-                                                         cScanningRay,
-                                                         *m_pcEmbodiedEntity)) {
+            bool bHit = bTrackHit;
+            Real fHitT = fTrackT;
+            if (fEngineT > 0.0) {
+                CVector3 cEngineRayEnd;
+                cScanningRay.GetPoint(cEngineRayEnd, fEngineT);
+                if (GetClosestEmbodiedEntityIntersectedByRay(sIntersection,
+                                                             CRay3(cRayStart, cEngineRayEnd),
+                                                             *m_pcEmbodiedEntity)) {
+                    bHit  = true;
+                    fHitT = sIntersection.TOnRay * fEngineT;
+                }
+            }
+            if (bHit) {
                 /* There is an intersection */
                 if (m_bShowRays) {
                     m_pcControllableEntity->AddIntersectionPoint(cScanningRay,
-                                                                 sIntersection.TOnRay);
+                                                                 fHitT);
                     m_pcControllableEntity->AddCheckedRay(true, cScanningRay);
                 }
                 /* The actual reading is in cm */
-                m_pfReadings[i] = cScanningRay.GetDistance(sIntersection.TOnRay) * 100;
+                m_pfReadings[i] = cScanningRay.GetDistance(fHitT) * 100;
             } else {
                 /* No intersection */
                 m_pfReadings[i] = 0;
@@ -128,6 +177,21 @@ namespace argos {
     /****************************************/
     /****************************************/
 
+    void CDeepracerLIDARDefaultSensor::UpdateTracks() {
+        m_vecTracks.clear();
+        CSpace::TMapPerTypePerId& tEntities = m_cSpace.GetEntityMapPerTypePerId();
+        CSpace::TMapPerTypePerId::iterator itTracks = tEntities.find("deepracer_track");
+        if (itTracks == tEntities.end()) return;
+        for (CSpace::TMapPerType::iterator it = itTracks->second.begin();
+             it != itTracks->second.end();
+             ++it) {
+            m_vecTracks.push_back(any_cast<CDeepracerTrackEntity*>(it->second));
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
     void CDeepracerLIDARDefaultSensor::Reset() {
         memset(m_pfReadings, 0, m_unNumReadings * sizeof(long int));
     }
@@ -137,6 +201,7 @@ namespace argos {
 
     void CDeepracerLIDARDefaultSensor::Destroy() {
         delete[] m_pfReadings;
+        m_pfReadings = NULL;
     }
 
     /****************************************/
@@ -3,9 +3,11 @@
 
 #include <map>
 #include <string>
+#include <vector>
 
 namespace argos {
     class CDeepracerLIDARDefaultSensor;
+    class CDeepracerTrackEntity;
 }
 
 #include <argos3/plugins/robots/deepracer/control_interface/ci_deepracer_lidar_sensor.h>
@@ -39,6 +41,21 @@ namespace argos {
 
         virtual void PowerOff();
 
+        /**
+         * Adds the LIDAR rays to c_entity. The sensor does it in Init() when
+         * the entity has no rays yet; entities can also do it beforehand.
+         */
+        static void AddFan(CProximitySensorEquippedEntity& c_entity,
+                           UInt32 un_num_readings,
+                           SAnchor& s_anchor);
+
+    private:
+
+        /**
+         * Collects the tracks in the space.
+         */
+        void UpdateTracks();
+
     private:
 
         /** Readings of the LIDAR sensor */
@@ -73,6 +90,9 @@ namespace argos {
 
         /** Reference to the space */
         CSpace& m_cSpace;
+
+        /** Tracks in the space, intersected through their BVH */
+        std::vector<CDeepracerTrackEntity*> m_vecTracks;
     };
 
 }
@@ -23,6 +23,7 @@ namespace argos {
     const CVector2 DEEPRACER_BASE_FRONT_LEFT  = CVector2(DEEPRACER_BASE_LENGTH / 2, DEEPRACER_BASE_WIDTH / 2);
     const CVector2 DEEPRACER_BASE_FRONT_RIGHT = CVector2(DEEPRACER_BASE_LENGTH / 2, -DEEPRACER_BASE_WIDTH / 2);
     const CVector2 DEEPRACER_BASE_REAR_RIGHT  = CVector2(-DEEPRACER_BASE_LENGTH / 2, -DEEPRACER_BASE_WIDTH / 2);
+    const Real     DEEPRACER_BASE_RADIUS      = DEEPRACER_BASE_FRONT_LEFT.Length(); // circle around the base footprint, for placement
 
     const Real DEEPRACER_WHEEL_RADIUS       = 0.035;    // measured; 0.005 more than specified in the urdf file
     const Real DEEPRACER_WHEEL_DISTANCE     = 0.159202; // from deepracer_ros_control.xacro
@@ -43,6 +44,7 @@ namespace argos {
     const CRadians     DEEPRACER_LIDAR_ANGLE_START = (CRadians::TWO_PI - DEEPRACER_LIDAR_ANGLE_SPAN) * 0.5; // starting sweep angle
     const CRadians     DEEPRACER_LIDAR_ANGLE_END   = CRadians::TWO_PI - DEEPRACER_LIDAR_ANGLE_START;        // ending sweep angle
     const CRange<Real> DEEPRACER_LIDAR_SENSORS_RING_RANGE(0.15, 10.0);                                      // from deepracer.xacro
+    const UInt32       DEEPRACER_LIDAR_DEFAULT_NUM_READINGS = 600;
 }
 
 /****************************************/
@@ -19,6 +19,7 @@ namespace argos {
     extern const CVector2 DEEPRACER_BASE_FRONT_LEFT;
     extern const CVector2 DEEPRACER_BASE_FRONT_RIGHT;
     extern const CVector2 DEEPRACER_BASE_REAR_RIGHT;
+    extern const Real     DEEPRACER_BASE_RADIUS;
 
     extern const Real DEEPRACER_WHEEL_RADIUS;
     extern const Real DEEPRACER_WHEEL_DISTANCE;
@@ -39,6 +40,7 @@ namespace argos {
     extern const CRadians     DEEPRACER_LIDAR_ANGLE_START;
     extern const CRadians     DEEPRACER_LIDAR_ANGLE_END;
     extern const CRange<Real> DEEPRACER_LIDAR_SENSORS_RING_RANGE;
+    extern const UInt32       DEEPRACER_LIDAR_DEFAULT_NUM_READINGS;
 }
 
 #endif // DEEPRACER_MEASURES_H
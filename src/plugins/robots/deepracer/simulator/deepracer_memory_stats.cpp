@@ -0,0 +1,134 @@
+#include "deepracer_memory_stats.h"
+
+#include <argos3/core/control_interface/ci_controller.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/plugins/robots/deepracer/control_interface/ci_deepracer_lidar_sensor.h>
+#include <argos3/plugins/simulator/entities/battery_equipped_entity.h>
+#include <argos3/plugins/simulator/entities/proximity_sensor_equipped_entity.h>
+#include <argos3/plugins/simulator/entities/rab_equipped_entity.h>
+
+#include <argos3/core/utility/logging/argos_log.h>
+
+#include <iomanip>
+#include <sstream>
+
+#include "deepracer_entity.h"
+#include "deepracer_init_profiler.h"
+#include "dynamics2d_deepracer_model.h"
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerMemoryStats::Measure(CDeepracerEntity& c_robot,
+                                        TBytesPerComponent& t_bytes) {
+        t_bytes["entity"] += sizeof(CDeepracerEntity) +
+                             c_robot.GetContacts().capacity() * sizeof(CDeepracerEntity::SContact);
+        t_bytes["body"] += sizeof(CEmbodiedEntity);
+        t_bytes["controller"] += sizeof(CControllableEntity);
+        /* Positions, radii and velocities of the four wheels, plus the steering angle */
+        CAckermannWheeledEntity& cWheels = c_robot.GetWheeledEntity();
+        t_bytes["wheels"] += sizeof(CAckermannWheeledEntity) +
+                             cWheels.GetNumWheels() * (sizeof(CVector3) + 2 * sizeof(Real)) + sizeof(Real);
+        if (c_robot.HasLIDARSensorEquippedEntity()) {
+            CProximitySensorEquippedEntity& cLIDAR = c_robot.GetLIDARSensorEquippedEntity();
+            t_bytes["lidar"] += sizeof(CProximitySensorEquippedEntity) +
+                                cLIDAR.GetNumSensors() * (sizeof(CProximitySensorEquippedEntity::SSensor) +
+                                                          sizeof(CProximitySensorEquippedEntity::SSensor*));
+        }
+        if (c_robot.HasRABEquippedEntity()) {
+            t_bytes["rab"] += sizeof(CRABEquippedEntity) + c_robot.GetRABEquippedEntity().GetMsgSize();
+        }
+        if (c_robot.HasBatteryEquippedEntity()) {
+            t_bytes["battery"] += sizeof(CBatteryEquippedEntity);
+        }
+        /* Chipmunk objects, once per engine the robot is in */
+        CEmbodiedEntity& cBody = c_robot.GetEmbodiedEntity();
+        for (size_t i = 0; i < cBody.GetPhysicsModelsNum(); ++i) {
+            if (dynamic_cast<CDynamics2DDeepracerModel*>(&cBody.GetPhysicsModel(i)) != NULL) {
+                t_bytes["dynamics2d"] += sizeof(CDynamics2DDeepracerModel) + CDynamics2DDeepracerModel::GetChipmunkBytes();
+            }
+        }
+        /* Readings buffer of the LIDAR sensor */
+        CCI_Controller::TMapSensors& tSensors = c_robot.GetControllableEntity().GetController().GetAllSensors();
+        CCI_Controller::TMapSensors::iterator itLIDAR = tSensors.find("deepracer_lidar");
+        if (itLIDAR != tSensors.end()) {
+            CCI_DeepracerLIDARSensor* pcLIDAR = dynamic_cast<CCI_DeepracerLIDARSensor*>(itLIDAR->second);
+            if (pcLIDAR != NULL) {
+                t_bytes["lidar_readings"] += pcLIDAR->GetNumReadings() * sizeof(Real);
+            }
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerMemoryStats::Collect() {
+        m_tBytesPerComponent.clear();
+        m_mapBytesPerRobot.clear();
+        std::vector<CDeepracerEntity*> vecRobots = CDeepracerEntity::CollectDeepracers();
+        for (size_t i = 0; i < vecRobots.size(); ++i) {
+            CDeepracerEntity& cRobot = *vecRobots[i];
+            TBytesPerComponent tRobot;
+            Measure(cRobot, tRobot);
+            size_t unTotal = 0;
+            for (TBytesPerComponent::iterator itComp = tRobot.begin(); itComp != tRobot.end(); ++itComp) {
+                m_tBytesPerComponent[itComp->first] += itComp->second;
+                unTotal += itComp->second;
+            }
+            m_mapBytesPerRobot[cRobot.GetId()] = unTotal;
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    size_t CDeepracerMemoryStats::GetTotalBytes() const {
+        size_t unTotal = 0;
+        for (TBytesPerComponent::const_iterator it = m_tBytesPerComponent.begin(); it != m_tBytesPerComponent.end(); ++it) {
+            unTotal += it->second;
+        }
+        return unTotal;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerMemoryStats::Print(std::ostream& c_stream) const {
+        if (m_mapBytesPerRobot.empty()) return;
+        size_t unTotal = GetTotalBytes();
+        size_t unMin = m_mapBytesPerRobot.begin()->second, unMax = unMin;
+        for (std::map<std::string, size_t>::const_iterator it = m_mapBytesPerRobot.begin(); it != m_mapBytesPerRobot.end(); ++it) {
+            unMin = Min(unMin, it->second);
+            unMax = Max(unMax, it->second);
+        }
+        c_stream << "[INFO] DeepRacer memory: " << m_mapBytesPerRobot.size() << " robots, "
+                 << unTotal << " bytes (per robot: avg " << unTotal / m_mapBytesPerRobot.size()
+                 << ", min " << unMin << ", max " << unMax << ")" << std::endl;
+        for (TBytesPerComponent::const_iterator it = m_tBytesPerComponent.begin(); it != m_tBytesPerComponent.end(); ++it) {
+            c_stream << "[INFO]   " << std::setw(16) << std::left << it->first << std::right
+                     << std::setw(12) << it->second << " bytes  "
+                     << std::setw(5) << std::fixed << std::setprecision(1) << (100.0 * it->second / unTotal) << "%"
+                     << std::endl;
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerMemoryStats::LogExperimentSummary() {
+        std::ostringstream cSummary;
+        CDeepracerInitProfiler::Print(cSummary);
+        CDeepracerInitProfiler::Reset();
+        CDeepracerMemoryStats cStats;
+        cStats.Collect();
+        cStats.Print(cSummary);
+        LOG << cSummary.str();
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
@@ -0,0 +1,86 @@
+#ifndef DEEPRACER_MEMORY_STATS_H
+#define DEEPRACER_MEMORY_STATS_H
+
+namespace argos {
+    class CDeepracerEntity;
+    class CDeepracerMemoryStats;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace argos {
+
+    /**
+     * Memory accounting for DeepRacers.
+     *
+     * The bytes of each robot are estimated per component type from the sizes
+     * of the objects and of the arrays they allocate: the entity tree, the
+     * LIDAR fan, the RAB payload, the wheel arrays, the Chipmunk objects, the
+     * contact list and the controller-side LIDAR readings. Allocator overhead
+     * and the controller itself are not included.
+     */
+    class CDeepracerMemoryStats {
+    public:
+
+        typedef std::map<std::string, size_t> TBytesPerComponent;
+
+    public:
+
+        CDeepracerMemoryStats() {}
+
+        /**
+         * Adds the bytes of the given robot to t_bytes, per component type.
+         */
+        static void Measure(CDeepracerEntity& c_robot,
+                            TBytesPerComponent& t_bytes);
+
+        /**
+         * Measures all the DeepRacers in the space, replacing the previous data.
+         */
+        void Collect();
+
+        /**
+         * Returns the bytes per component type, summed over all the robots.
+         */
+        inline const TBytesPerComponent& GetBytesPerComponent() const {
+            return m_tBytesPerComponent;
+        }
+
+        /**
+         * Returns the total bytes of each robot, by id.
+         */
+        inline const std::map<std::string, size_t>& GetBytesPerRobot() const {
+            return m_mapBytesPerRobot;
+        }
+
+        size_t GetTotalBytes() const;
+
+        inline size_t GetNumRobots() const {
+            return m_mapBytesPerRobot.size();
+        }
+
+        /**
+         * Prints a summary: per component totals and average, min and max per robot.
+         */
+        void Print(std::ostream& c_stream) const;
+
+        /**
+         * Logs the initialization time and the memory of the DeepRacers in the
+         * space, then resets the initialization profile for the next
+         * experiment. The DeepRacer loop functions call it in PostExperiment().
+         */
+        static void LogExperimentSummary();
+
+    private:
+
+        TBytesPerComponent            m_tBytesPerComponent;
+        std::map<std::string, size_t> m_mapBytesPerRobot;
+    };
+
+}
+
+#endif
@@ -0,0 +1,281 @@
+#include "deepracer_raster_scene.h"
+
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/plugins/simulator/entities/box_entity.h>
+#include <argos3/plugins/simulator/entities/cylinder_entity.h>
+
+#include "deepracer_entity.h"
+#include "deepracer_measures.h"
+#include "deepracer_track_entity.h"
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    /* Direction towards the light, for flat shading */
+    static const CVector3 LIGHT_DIRECTION = CVector3(0.3, 0.2, 0.93).Normalize();
+
+    /* Fraction of the color lit regardless of orientation */
+    static const Real AMBIENT_LIGHT = 0.45;
+
+    /* Sides of the prisms approximating cylinders */
+    static const UInt32 CYLINDER_SIDES = 12;
+
+    /* Heights of the track surface and of its center line above the floor [m] */
+    static const Real TRACK_ROAD_ELEVATION = 0.001;
+    static const Real TRACK_LINE_ELEVATION = 0.002;
+    static const Real TRACK_LINE_WIDTH     = 0.02;
+
+    static const CColor FLOOR_COLOR     = CColor(110, 140, 90);
+    static const CColor ROAD_COLOR      = CColor(45, 45, 50);
+    static const CColor LINE_COLOR      = CColor(230, 200, 40);
+    static const CColor WALL_COLOR      = CColor(235, 235, 235);
+    static const CColor DEEPRACER_COLOR = CColor(30, 30, 35);
+    static const CColor OBSTACLE_COLOR  = CColor(160, 120, 80);
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerRasterScene::CDeepracerRasterScene(Real f_cell_size) :
+        m_fCellSize(f_cell_size),
+        m_fMaxHalfExtent(0.0) {}
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerRasterScene::Clear() {
+        m_vecTriangles.clear();
+        m_vecLarge.clear();
+        /* Keep the cells, so their storage is reused by the next build */
+        for (std::unordered_map<UInt64, std::vector<UInt32> >::iterator it = m_mapCells.begin();
+             it != m_mapCells.end();
+             ++it) {
+            it->second.clear();
+        }
+        m_fMaxHalfExtent = 0.0;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerRasterScene::AddTriangle(const CVector3& c_a,
+                                            const CVector3& c_b,
+                                            const CVector3& c_c,
+                                            const CColor& c_color,
+                                            const CEntity* pc_owner) {
+        STriangle sTriangle;
+        sTriangle.V[0] = c_a;
+        sTriangle.V[1] = c_b;
+        sTriangle.V[2] = c_c;
+        sTriangle.Owner = pc_owner;
+        /* Flat shading; both faces are lit alike */
+        CVector3 cNormal = CVector3(c_b - c_a).CrossProduct(c_c - c_a);
+        Real fLength = cNormal.Length();
+        if (fLength == 0.0) return;
+        Real fShade = AMBIENT_LIGHT + (1.0 - AMBIENT_LIGHT) * Abs(cNormal.DotProduct(LIGHT_DIRECTION)) / fLength;
+        sTriangle.Color[0] = static_cast<UInt8>(c_color.GetRed()   * fShade);
+        sTriangle.Color[1] = static_cast<UInt8>(c_color.GetGreen() * fShade);
+        sTriangle.Color[2] = static_cast<UInt8>(c_color.GetBlue()  * fShade);
+        UInt32 unIndex = m_vecTriangles.size();
+        m_vecTriangles.push_back(sTriangle);
+        /* Index by centroid, unless the triangle spans more than a cell */
+        CVector2 cCentroid((c_a.GetX() + c_b.GetX() + c_c.GetX()) / 3.0,
+                           (c_a.GetY() + c_b.GetY() + c_c.GetY()) / 3.0);
+        Real fHalfExtent = 0.0;
+        for (UInt32 i = 0; i < 3; ++i) {
+            fHalfExtent = Max(fHalfExtent,
+                              (CVector2(sTriangle.V[i].GetX(), sTriangle.V[i].GetY()) - cCentroid).Length());
+        }
+        if (fHalfExtent > m_fCellSize) {
+            m_vecLarge.push_back(unIndex);
+        } else {
+            m_fMaxHalfExtent = Max(m_fMaxHalfExtent, fHalfExtent);
+            m_mapCells[GetKey(GetCell(cCentroid.GetX()), GetCell(cCentroid.GetY()))].push_back(unIndex);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerRasterScene::AddQuad(const CVector3& c_a,
+                                        const CVector3& c_b,
+                                        const CVector3& c_c,
+                                        const CVector3& c_d,
+                                        const CColor& c_color,
+                                        const CEntity* pc_owner) {
+        AddTriangle(c_a, c_b, c_c, c_color, pc_owner);
+        AddTriangle(c_a, c_c, c_d, c_color, pc_owner);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerRasterScene::AddBox(const CVector3& c_position,
+                                       const CQuaternion& c_orientation,
+                                       const CVector3& c_size,
+                                       const CColor& c_color,
+                                       const CEntity* pc_owner) {
+        /* Corners: bit 0 selects X, bit 1 Y, bit 2 Z */
+        CVector3 pcCorners[8];
+        for (UInt32 i = 0; i < 8; ++i) {
+            pcCorners[i].Set(((i & 1) ? 0.5 : -0.5) * c_size.GetX(),
+                             ((i & 2) ? 0.5 : -0.5) * c_size.GetY(),
+                             ((i & 4) ? 1.0 :  0.0) * c_size.GetZ());
+            pcCorners[i].Rotate(c_orientation);
+            pcCorners[i] += c_position;
+        }
+        static const UInt32 FACES[6][4] = {
+            {0, 1, 3, 2}, {4, 5, 7, 6}, {0, 1, 5, 4},
+            {2, 3, 7, 6}, {0, 2, 6, 4}, {1, 3, 7, 5}
+        };
+        for (UInt32 i = 0; i < 6; ++i) {
+            AddQuad(pcCorners[FACES[i][0]], pcCorners[FACES[i][1]],
+                    pcCorners[FACES[i][2]], pcCorners[FACES[i][3]],
+                    c_color, pc_owner);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerRasterScene::AddCylinder(const CVector3& c_position,
+                                            const CQuaternion& c_orientation,
+                                            Real f_radius,
+                                            Real f_height,
+                                            const CColor& c_color,
+                                            const CEntity* pc_owner) {
+        CVector3 cTop = CVector3(0.0, 0.0, f_height).Rotate(c_orientation) + c_position;
+        CRadians cStep = CRadians::TWO_PI / CYLINDER_SIDES;
+        for (UInt32 i = 0; i < CYLINDER_SIDES; ++i) {
+            CVector3 cA = CVector3(f_radius, 0.0, 0.0).RotateZ(cStep * i).Rotate(c_orientation);
+            CVector3 cB = CVector3(f_radius, 0.0, 0.0).RotateZ(cStep * (i + 1)).Rotate(c_orientation);
+            AddQuad(c_position + cA, c_position + cB, cTop + cB, cTop + cA, c_color, pc_owner);
+            AddTriangle(cTop, cTop + cA, cTop + cB, c_color, pc_owner);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerRasterScene::BuildFromSpace() {
+        Clear();
+        CSpace& cSpace = CSimulator::GetInstance().GetSpace();
+        /* Floor */
+        const CVector3& cArenaCenter = cSpace.GetArenaCenter();
+        CVector3 cHalf = cSpace.GetArenaSize() * 0.5;
+        AddQuad(CVector3(cArenaCenter.GetX() - cHalf.GetX(), cArenaCenter.GetY() - cHalf.GetY(), 0.0),
+                CVector3(cArenaCenter.GetX() + cHalf.GetX(), cArenaCenter.GetY() - cHalf.GetY(), 0.0),
+                CVector3(cArenaCenter.GetX() + cHalf.GetX(), cArenaCenter.GetY() + cHalf.GetY(), 0.0),
+                CVector3(cArenaCenter.GetX() - cHalf.GetX(), cArenaCenter.GetY() + cHalf.GetY(), 0.0),
+                FLOOR_COLOR);
+        /* Entities */
+        CSpace::TMapPerType& tEntities = cSpace.GetEntityMapPerId();
+        for (CSpace::TMapPerType::iterator it = tEntities.begin(); it != tEntities.end(); ++it) {
+            CEntity* pcEntity = any_cast<CEntity*>(it->second);
+            if (pcEntity->HasParent()) continue;
+            if (CDeepracerTrackEntity* pcTrack = dynamic_cast<CDeepracerTrackEntity*>(pcEntity)) {
+                const SAnchor& sOrigin = pcTrack->GetEmbodiedEntity().GetOriginAnchor();
+                auto ToWorld = [&sOrigin](const CVector2& c_point, Real f_z) {
+                    return CVector3(c_point.GetX(), c_point.GetY(), f_z).Rotate(sOrigin.Orientation) + sOrigin.Position;
+                };
+                const CDeepracerTrack& cTrack = pcTrack->GetTrack();
+                const CDeepracerTrack::TWaypoints& tCenter = cTrack.GetCenterLine();
+                const CDeepracerTrack::TWaypoints& tInner  = cTrack.GetInnerBorder();
+                const CDeepracerTrack::TWaypoints& tOuter  = cTrack.GetOuterBorder();
+                size_t unSegments = cTrack.IsClosed() ? tCenter.size() : tCenter.size() - 1;
+                for (size_t i = 0; i < unSegments; ++i) {
+                    size_t j = (i + 1) % tCenter.size();
+                    /* Road */
+                    AddQuad(ToWorld(tInner[i], TRACK_ROAD_ELEVATION), ToWorld(tInner[j], TRACK_ROAD_ELEVATION),
+                            ToWorld(tOuter[j], TRACK_ROAD_ELEVATION), ToWorld(tOuter[i], TRACK_ROAD_ELEVATION),
+                            ROAD_COLOR);
+                    /* Center line */
+                    CVector2 cDir = tCenter[j] - tCenter[i];
+                    if (cDir.Length() == 0.0) continue;
+                    CVector2 cSide = CVector2(-cDir.GetY(), cDir.GetX()).Normalize() * (0.5 * TRACK_LINE_WIDTH);
+                    AddQuad(ToWorld(tCenter[i] + cSide, TRACK_LINE_ELEVATION), ToWorld(tCenter[j] + cSide, TRACK_LINE_ELEVATION),
+                            ToWorld(tCenter[j] - cSide, TRACK_LINE_ELEVATION), ToWorld(tCenter[i] - cSide, TRACK_LINE_ELEVATION),
+                            LINE_COLOR);
+                }
+                /* Walls, cut in pieces no longer than a cell */
+                const CDeepracerSegmentBVH::TSegments& tWalls = pcTrack->GetWalls().GetSegments();
+                for (size_t i = 0; i < tWalls.size(); ++i) {
+                    CVector2 cDelta = tWalls[i].End - tWalls[i].Start;
+                    UInt32 unPieces = static_cast<UInt32>(::ceil(cDelta.Length() / m_fCellSize));
+                    for (UInt32 k = 0; k < unPieces; ++k) {
+                        CVector2 cA = tWalls[i].Start + cDelta * (static_cast<Real>(k) / unPieces);
+                        CVector2 cB = tWalls[i].Start + cDelta * (static_cast<Real>(k + 1) / unPieces);
+                        AddQuad(ToWorld(cA, 0.0), ToWorld(cB, 0.0),
+                                ToWorld(cB, pcTrack->GetWallHeight()), ToWorld(cA, pcTrack->GetWallHeight()),
+                                WALL_COLOR);
+                    }
+                }
+            } else if (CDeepracerEntity* pcDeepracer = dynamic_cast<CDeepracerEntity*>(pcEntity)) {
+                const SAnchor& sOrigin = pcDeepracer->GetEmbodiedEntity().GetOriginAnchor();
+                AddBox(CVector3(0.0, 0.0, DEEPRACER_BASE_ELEVATION).Rotate(sOrigin.Orientation) + sOrigin.Position,
+                       sOrigin.Orientation,
+                       CVector3(DEEPRACER_BASE_LENGTH, DEEPRACER_BASE_WIDTH, DEEPRACER_BASE_HEIGHT),
+                       DEEPRACER_COLOR,
+                       pcDeepracer);
+            } else if (CBoxEntity* pcBox = dynamic_cast<CBoxEntity*>(pcEntity)) {
+                const SAnchor& sOrigin = pcBox->GetEmbodiedEntity().GetOriginAnchor();
+                AddBox(sOrigin.Position, sOrigin.Orientation, pcBox->GetSize(), OBSTACLE_COLOR, pcBox);
+            } else if (CCylinderEntity* pcCylinder = dynamic_cast<CCylinderEntity*>(pcEntity)) {
+                const SAnchor& sOrigin = pcCylinder->GetEmbodiedEntity().GetOriginAnchor();
+                AddCylinder(sOrigin.Position, sOrigin.Orientation,
+                            pcCylinder->GetRadius(), pcCylinder->GetHeight(),
+                            OBSTACLE_COLOR, pcCylinder);
+            } else if (CComposableEntity* pcComposable = dynamic_cast<CComposableEntity*>(pcEntity)) {
+                /* Any other body: its bounding box */
+                if (!pcComposable->HasComponent("body")) continue;
+                const SBoundingBox& sBox = pcComposable->GetComponent<CEmbodiedEntity>("body").GetBoundingBox();
+                CVector3 cSize = sBox.MaxCorner - sBox.MinCorner;
+                AddBox(CVector3((sBox.MinCorner.GetX() + sBox.MaxCorner.GetX()) * 0.5,
+                                (sBox.MinCorner.GetY() + sBox.MaxCorner.GetY()) * 0.5,
+                                sBox.MinCorner.GetZ()),
+                       CQuaternion(),
+                       cSize,
+                       OBSTACLE_COLOR,
+                       pcComposable);
+            }
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    static std::mutex s_cSharedMutex;
+    static bool       s_bSharedValid = false;
+    static UInt32     s_unSharedClock = 0;
+
+    /****************************************/
+    /****************************************/
+
+    const CDeepracerRasterScene& CDeepracerRasterScene::GetShared() {
+        static CDeepracerRasterScene cScene;
+        std::lock_guard<std::mutex> cLock(s_cSharedMutex);
+        UInt32 unClock = CSimulator::GetInstance().GetSpace().GetSimulationClock();
+        if (!s_bSharedValid || unClock != s_unSharedClock) {
+            cScene.BuildFromSpace();
+            s_bSharedValid  = true;
+            s_unSharedClock = unClock;
+        }
+        return cScene;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerRasterScene::InvalidateShared() {
+        std::lock_guard<std::mutex> cLock(s_cSharedMutex);
+        s_bSharedValid = false;
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
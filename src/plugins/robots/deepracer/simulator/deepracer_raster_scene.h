@@ -0,0 +1,151 @@
+#ifndef DEEPRACER_RASTER_SCENE_H
+#define DEEPRACER_RASTER_SCENE_H
+
+namespace argos {
+    class CEntity;
+    class CDeepracerRasterScene;
+}
+
+#include <argos3/core/utility/datatypes/color.h>
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/math/quaternion.h>
+#include <argos3/core/utility/math/vector2.h>
+#include <argos3/core/utility/math/vector3.h>
+
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace argos {
+
+    /**
+     * The arena as flat-shaded triangles, for the software rasterizer.
+     *
+     * Small triangles are indexed in a uniform XY grid by their centroid, so
+     * a camera only visits the cells its view reaches; large ones (the floor)
+     * are visited by every query. The shared scene is rebuilt from the space
+     * at most once per step: the floor, the tracks (road, center line and
+     * walls), the DeepRacers, boxes, cylinders and the bounding boxes of the
+     * other bodies.
+     */
+    class CDeepracerRasterScene {
+    public:
+
+        struct STriangle {
+            CVector3       V[3];
+            /** Shaded color */
+            UInt8          Color[3];
+            /** The root entity the triangle belongs to, NULL for the arena */
+            const CEntity* Owner;
+        };
+
+    public:
+
+        /**
+         * @param f_cell_size side of a grid cell [m].
+         */
+        CDeepracerRasterScene(Real f_cell_size = 1.0);
+
+        void Clear();
+
+        /**
+         * Adds a triangle, shaded after its orientation with respect to a fixed light.
+         */
+        void AddTriangle(const CVector3& c_a,
+                         const CVector3& c_b,
+                         const CVector3& c_c,
+                         const CColor& c_color,
+                         const CEntity* pc_owner = NULL);
+
+        void AddQuad(const CVector3& c_a,
+                     const CVector3& c_b,
+                     const CVector3& c_c,
+                     const CVector3& c_d,
+                     const CColor& c_color,
+                     const CEntity* pc_owner = NULL);
+
+        /**
+         * Adds an oriented box; c_position is the center of its bottom face.
+         */
+        void AddBox(const CVector3& c_position,
+                    const CQuaternion& c_orientation,
+                    const CVector3& c_size,
+                    const CColor& c_color,
+                    const CEntity* pc_owner = NULL);
+
+        /**
+         * Adds a vertical prism approximating a cylinder; c_position is the center of its base.
+         */
+        void AddCylinder(const CVector3& c_position,
+                         const CQuaternion& c_orientation,
+                         Real f_radius,
+                         Real f_height,
+                         const CColor& c_color,
+                         const CEntity* pc_owner = NULL);
+
+        /**
+         * Calls c_visitor(const STriangle&) for the triangles that may overlap the given XY box.
+         */
+        template <class VISITOR>
+        void ForTrianglesInBox(const CVector2& c_min,
+                               const CVector2& c_max,
+                               VISITOR& c_visitor) const {
+            for (size_t i = 0; i < m_vecLarge.size(); ++i) {
+                c_visitor(m_vecTriangles[m_vecLarge[i]]);
+            }
+            /* Centroids lie at most m_fMaxHalfExtent away from the parts of a triangle in the box */
+            SInt32 nMinX = GetCell(c_min.GetX() - m_fMaxHalfExtent), nMaxX = GetCell(c_max.GetX() + m_fMaxHalfExtent);
+            SInt32 nMinY = GetCell(c_min.GetY() - m_fMaxHalfExtent), nMaxY = GetCell(c_max.GetY() + m_fMaxHalfExtent);
+            for (SInt32 nX = nMinX; nX <= nMaxX; ++nX) {
+                for (SInt32 nY = nMinY; nY <= nMaxY; ++nY) {
+                    std::unordered_map<UInt64, std::vector<UInt32> >::const_iterator itCell = m_mapCells.find(GetKey(nX, nY));
+                    if (itCell == m_mapCells.end()) continue;
+                    for (size_t i = 0; i < itCell->second.size(); ++i) {
+                        c_visitor(m_vecTriangles[itCell->second[i]]);
+                    }
+                }
+            }
+        }
+
+        inline size_t GetNumTriangles() const {
+            return m_vecTriangles.size();
+        }
+
+        /**
+         * Returns the scene shared by the cameras, rebuilt from the space
+         * if the simulation clock changed since the last call. Thread-safe.
+         */
+        static const CDeepracerRasterScene& GetShared();
+
+        /**
+         * Forces the next GetShared() to rebuild the scene, e.g. after robots were moved.
+         */
+        static void InvalidateShared();
+
+    private:
+
+        inline SInt32 GetCell(Real f_coord) const {
+            return static_cast<SInt32>(::floor(f_coord / m_fCellSize));
+        }
+
+        inline static UInt64 GetKey(SInt32 n_x, SInt32 n_y) {
+            return (static_cast<UInt64>(static_cast<UInt32>(n_x)) << 32) | static_cast<UInt32>(n_y);
+        }
+
+        void BuildFromSpace();
+
+    private:
+
+        Real                                             m_fCellSize;
+        std::vector<STriangle>                           m_vecTriangles;
+        /** Triangles larger than a cell */
+        std::vector<UInt32>                              m_vecLarge;
+        std::unordered_map<UInt64, std::vector<UInt32> > m_mapCells;
+        /** Largest distance between a small triangle's centroid and its vertices, in XY */
+        Real                                             m_fMaxHalfExtent;
+    };
+
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef DEEPRACER_RECORDING_LOOP_FUNCTIONS_H
+#define DEEPRACER_RECORDING_LOOP_FUNCTIONS_H
+
+namespace argos {
+    template <class RECORDER> class CDeepracerRecordingLoopFunctions;
+}
+
+#include <argos3/core/simulator/loop_functions.h>
+#include <argos3/core/simulator/space/space.h>
+
+#include "deepracer_memory_stats.h"
+
+namespace argos {
+
+    /**
+     * Loop functions that record all the DeepRacers after each step.
+     *
+     * The recorder is opened in Init(), fed in PostStep() and closed in
+     * PostExperiment() or Destroy(). Reset() closes it and opens it again
+     * for a new run, so each run of the experiment has its own files.
+     * RECORDER needs IsOpen(), Record(UInt32 un_step) and Close().
+     */
+    template <class RECORDER>
+    class CDeepracerRecordingLoopFunctions : public CLoopFunctions {
+    public:
+
+        /**
+         * @param str_name the name of the recording in the error messages.
+         */
+        explicit CDeepracerRecordingLoopFunctions(const std::string& str_name) :
+            m_strName(str_name),
+            m_bEnabled(false),
+            m_unRun(0) {}
+
+        virtual ~CDeepracerRecordingLoopFunctions() {}
+
+        virtual void Init(TConfigurationNode& t_tree) {
+            try {
+                m_unRun = 0;
+                m_bEnabled = Configure(t_tree);
+                if (m_bEnabled) Open(m_unRun);
+            } catch (CARGoSException& ex) {
+                THROW_ARGOSEXCEPTION_NESTED("Error initializing the DeepRacer " << m_strName << " loop functions", ex);
+            }
+        }
+
+        virtual void Reset() {
+            m_cRecorder.Close();
+            if (m_bEnabled) Open(++m_unRun);
+        }
+
+        virtual void PostStep() {
+            if (m_cRecorder.IsOpen()) m_cRecorder.Record(GetSpace().GetSimulationClock());
+        }
+
+        virtual void PostExperiment() {
+            m_cRecorder.Close();
+            CDeepracerMemoryStats::LogExperimentSummary();
+        }
+
+        virtual void Destroy() {
+            m_cRecorder.Close();
+        }
+
+        inline RECORDER& GetRecorder() {
+            return m_cRecorder;
+        }
+
+    protected:
+
+        /**
+         * Reads the parameters of the recording.
+         * @return false if the configuration does not ask for a recording.
+         */
+        virtual bool Configure(TConfigurationNode& t_tree) = 0;
+
+        /**
+         * Opens the recorder.
+         * @param un_run 0 after Init(), increased by each Reset().
+         */
+        virtual void Open(UInt32 un_run) = 0;
+
+    protected:
+
+        RECORDER    m_cRecorder;
+
+    private:
+
+        std::string m_strName;
+        bool        m_bEnabled;
+        UInt32      m_unRun;
+    };
+
+}
+
+#endif
@@ -0,0 +1,213 @@
+#include "deepracer_segment_bvh.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    static const UInt32 MAX_SEGMENTS_PER_LEAF = 4;
+    static const UInt32 MAX_DEPTH             = 32;
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSegmentBVH::Build(const std::vector<SSegment>& vec_segments,
+                                     Real f_radius) {
+        std::vector<SSegment> vecSegments(vec_segments);
+        std::vector<SNode> vecNodes;
+        m_fRadius = f_radius;
+        if (!vecSegments.empty()) {
+            vecNodes.reserve(2 * vecSegments.size() / MAX_SEGMENTS_PER_LEAF + 1);
+            BuildNode(vecSegments, vecNodes, 0, vecSegments.size(), 0);
+        }
+        m_tSegments.Assign(vecSegments);
+        m_tNodes.Assign(vecNodes);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSegmentBVH::Save(CDeepracerAssetBuilder& c_builder,
+                                    const std::string& str_prefix) const {
+        c_builder.AddSection(str_prefix + ".segments", m_tSegments);
+        c_builder.AddSection(str_prefix + ".nodes", m_tNodes);
+        c_builder.AddValue(str_prefix + ".radius", m_fRadius);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    bool CDeepracerSegmentBVH::Load(const CDeepracerAsset& c_asset,
+                                    const std::string& str_prefix) {
+        TSegments tSegments;
+        TNodes tNodes;
+        Real fRadius;
+        if (!c_asset.GetSection(str_prefix + ".segments", tSegments) ||
+            !c_asset.GetSection(str_prefix + ".nodes", tNodes) ||
+            !c_asset.GetValue(str_prefix + ".radius", fRadius)) {
+            return false;
+        }
+        m_tSegments = tSegments;
+        m_tNodes    = tNodes;
+        m_fRadius   = fRadius;
+        return true;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    UInt32 CDeepracerSegmentBVH::BuildNode(std::vector<SSegment>& vec_segments,
+                                           std::vector<SNode>& vec_nodes,
+                                           UInt32 un_first,
+                                           UInt32 un_count,
+                                           UInt32 un_depth) const {
+        UInt32 unNode = vec_nodes.size();
+        vec_nodes.push_back(SNode());
+        /* Bounding box of the segments and of their centers */
+        CVector2 cMin(vec_segments[un_first].Start), cMax(cMin);
+        CVector2 cCMin((vec_segments[un_first].Start + vec_segments[un_first].End) * 0.5), cCMax(cCMin);
+        for (UInt32 i = un_first; i < un_first + un_count; ++i) {
+            const SSegment& sSeg = vec_segments[i];
+            cMin.Set(Min(cMin.GetX(), Min(sSeg.Start.GetX(), sSeg.End.GetX())),
+                     Min(cMin.GetY(), Min(sSeg.Start.GetY(), sSeg.End.GetY())));
+            cMax.Set(Max(cMax.GetX(), Max(sSeg.Start.GetX(), sSeg.End.GetX())),
+                     Max(cMax.GetY(), Max(sSeg.Start.GetY(), sSeg.End.GetY())));
+            CVector2 cCenter = (sSeg.Start + sSeg.End) * 0.5;
+            cCMin.Set(Min(cCMin.GetX(), cCenter.GetX()), Min(cCMin.GetY(), cCenter.GetY()));
+            cCMax.Set(Max(cCMax.GetX(), cCenter.GetX()), Max(cCMax.GetY(), cCenter.GetY()));
+        }
+        vec_nodes[unNode].Min = cMin - CVector2(m_fRadius, m_fRadius);
+        vec_nodes[unNode].Max = cMax + CVector2(m_fRadius, m_fRadius);
+        /* Leaf? */
+        if (un_count <= MAX_SEGMENTS_PER_LEAF || un_depth >= MAX_DEPTH) {
+            vec_nodes[unNode].Index = un_first;
+            vec_nodes[unNode].Count = un_count;
+            return unNode;
+        }
+        /* Median split of the centers along the longest axis */
+        bool bSplitX = (cCMax.GetX() - cCMin.GetX()) >= (cCMax.GetY() - cCMin.GetY());
+        UInt32 unHalf = un_count / 2;
+        std::nth_element(vec_segments.begin() + un_first,
+                         vec_segments.begin() + un_first + unHalf,
+                         vec_segments.begin() + un_first + un_count,
+                         [bSplitX](const SSegment& s_a, const SSegment& s_b) {
+                             return bSplitX ?
+                                 (s_a.Start.GetX() + s_a.End.GetX()) < (s_b.Start.GetX() + s_b.End.GetX()) :
+                                 (s_a.Start.GetY() + s_a.End.GetY()) < (s_b.Start.GetY() + s_b.End.GetY());
+                         });
+        /* The left child follows immediately, the right one is stored in the node */
+        BuildNode(vec_segments, vec_nodes, un_first, unHalf, un_depth + 1);
+        UInt32 unRight = BuildNode(vec_segments, vec_nodes, un_first + unHalf, un_count - unHalf, un_depth + 1);
+        vec_nodes[unNode].Index = unRight;
+        vec_nodes[unNode].Count = 0;
+        return unNode;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    bool CDeepracerSegmentBVH::IntersectRay(const CVector2& c_start,
+                                            const CVector2& c_end,
+                                            Real& f_t) const {
+        if (m_tNodes.empty()) return false;
+        CVector2 cDir = c_end - c_start;
+        /* Inverse direction for the slab tests, unused on axes the ray is parallel to */
+        Real fInvX = (cDir.GetX() != 0.0) ? 1.0 / cDir.GetX() : 0.0;
+        Real fInvY = (cDir.GetY() != 0.0) ? 1.0 / cDir.GetY() : 0.0;
+        Real fBest = 1.0;
+        bool bHit  = false;
+        UInt32 punStack[64];
+        UInt32 unStackSize = 0;
+        punStack[unStackSize++] = 0;
+        while (unStackSize > 0) {
+            const SNode& sNode = m_tNodes[punStack[--unStackSize]];
+            /* Slab test against the node box, clipped to the best hit so far */
+            Real fTMin = 0.0;
+            Real fTMax = fBest;
+            if (cDir.GetX() != 0.0) {
+                Real fT1 = (sNode.Min.GetX() - c_start.GetX()) * fInvX;
+                Real fT2 = (sNode.Max.GetX() - c_start.GetX()) * fInvX;
+                fTMin = Max(fTMin, Min(fT1, fT2));
+                fTMax = Min(fTMax, Max(fT1, fT2));
+            } else if (c_start.GetX() < sNode.Min.GetX() || c_start.GetX() > sNode.Max.GetX()) {
+                continue;
+            }
+            if (cDir.GetY() != 0.0) {
+                Real fT1 = (sNode.Min.GetY() - c_start.GetY()) * fInvY;
+                Real fT2 = (sNode.Max.GetY() - c_start.GetY()) * fInvY;
+                fTMin = Max(fTMin, Min(fT1, fT2));
+                fTMax = Min(fTMax, Max(fT1, fT2));
+            } else if (c_start.GetY() < sNode.Min.GetY() || c_start.GetY() > sNode.Max.GetY()) {
+                continue;
+            }
+            if (fTMin > fTMax) continue;
+            if (sNode.Count > 0) {
+                for (UInt32 i = sNode.Index; i < sNode.Index + sNode.Count; ++i) {
+                    Real fT = IntersectSegment(m_tSegments[i], c_start, cDir, fBest);
+                    if (fT >= 0.0) {
+                        fBest = fT;
+                        bHit  = true;
+                    }
+                }
+            } else {
+                punStack[unStackSize++] = sNode.Index;
+                punStack[unStackSize++] = static_cast<UInt32>(&sNode - &m_tNodes[0]) + 1;
+            }
+        }
+        if (bHit) f_t = fBest;
+        return bHit;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    Real CDeepracerSegmentBVH::IntersectSegment(const SSegment& s_segment,
+                                                const CVector2& c_start,
+                                                const CVector2& c_dir,
+                                                Real f_t_max) const {
+        Real fBest = -1.0;
+        CVector2 cSegDir = s_segment.End - s_segment.Start;
+        Real fSegLength = cSegDir.Length();
+        /* Sides of the capsule (the segment itself when the radius is zero) */
+        Real fDenom = c_dir.CrossProduct(cSegDir);
+        if (fDenom != 0.0 && fSegLength > 0.0) {
+            CVector2 cOffset(-cSegDir.GetY() * m_fRadius / fSegLength,
+                              cSegDir.GetX() * m_fRadius / fSegLength);
+            for (SInt32 nSide = (m_fRadius > 0.0 ? -1 : 1); nSide <= 1; nSide += 2) {
+                CVector2 cDiff = s_segment.Start + cOffset * nSide - c_start;
+                Real fT = cDiff.CrossProduct(cSegDir) / fDenom;
+                Real fU = cDiff.CrossProduct(c_dir) / fDenom;
+                if (fT >= 0.0 && fT <= f_t_max && fU >= 0.0 && fU <= 1.0) {
+                    f_t_max = fT;
+                    fBest   = fT;
+                }
+            }
+        }
+        if (m_fRadius > 0.0) {
+            /* Round caps */
+            const CVector2* pcEnds[2] = { &s_segment.Start, &s_segment.End };
+            Real fA = c_dir.SquareLength();
+            for (UInt32 i = 0; i < 2; ++i) {
+                CVector2 cDiff = c_start - *pcEnds[i];
+                Real fB = cDiff.DotProduct(c_dir);
+                Real fC = cDiff.SquareLength() - m_fRadius * m_fRadius;
+                if (fC <= 0.0) return 0.0; // starts inside
+                Real fDisc = fB * fB - fA * fC;
+                if (fDisc < 0.0 || fA == 0.0) continue;
+                Real fT = (-fB - ::sqrt(fDisc)) / fA;
+                if (fT >= 0.0 && fT <= f_t_max) {
+                    f_t_max = fT;
+                    fBest   = fT;
+                }
+            }
+        }
+        return fBest;
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
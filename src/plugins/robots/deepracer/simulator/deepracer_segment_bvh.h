@@ -0,0 +1,147 @@
+#ifndef DEEPRACER_SEGMENT_BVH_H
+#define DEEPRACER_SEGMENT_BVH_H
+
+namespace argos {
+    class CDeepracerSegmentBVH;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/math/vector2.h>
+
+#include <vector>
+
+#include "deepracer_asset_cache.h"
+
+namespace argos {
+
+    /**
+     * A static bounding-volume hierarchy over 2D line segments, optionally
+     * thickened by a radius (capsules, as Chipmunk's segment shapes).
+     *
+     * The tree is built once and stored as a flat array in depth-first order:
+     * the left child of an inner node immediately follows it, the index of the
+     * right child is stored in the node. Leaves refer to a contiguous range of
+     * the (reordered) segment array. Both arrays can be stored in an asset
+     * cache and mapped from it.
+     */
+    class CDeepracerSegmentBVH {
+    public:
+
+        struct SSegment {
+            CVector2 Start;
+            CVector2 End;
+        };
+
+        struct SNode {
+            CVector2 Min;
+            CVector2 Max;
+            /** First segment for leaves, index of the right child for inner nodes */
+            UInt32   Index;
+            /** Number of segments for leaves, 0 for inner nodes */
+            UInt32   Count;
+        };
+
+        typedef CDeepracerSharedArray<SSegment> TSegments;
+        typedef CDeepracerSharedArray<SNode>    TNodes;
+
+    public:
+
+        CDeepracerSegmentBVH() :
+            m_fRadius(0.0) {}
+
+        /**
+         * Builds the hierarchy. The segments are copied and reordered.
+         * @param f_radius half the thickness of the segments.
+         */
+        void Build(const std::vector<SSegment>& vec_segments,
+                   Real f_radius = 0.0);
+
+        /**
+         * Adds the hierarchy to an asset, in sections named after the prefix.
+         */
+        void Save(CDeepracerAssetBuilder& c_builder,
+                  const std::string& str_prefix) const;
+
+        /**
+         * Uses a hierarchy stored in an asset, without copying it.
+         * @return false if the asset doesn't contain it.
+         */
+        bool Load(const CDeepracerAsset& c_asset,
+                  const std::string& str_prefix);
+
+        /**
+         * Finds the closest intersection of the segment (c_start, c_end) with the stored segments.
+         * @param f_t on success, the intersection parameter in [0,1] along (c_start, c_end).
+         * @return true if an intersection was found.
+         */
+        bool IntersectRay(const CVector2& c_start,
+                          const CVector2& c_end,
+                          Real& f_t) const;
+
+        /**
+         * Calls c_visitor(const SSegment&) for each segment whose bounding box overlaps the given box.
+         */
+        template <class VISITOR>
+        void ForSegmentsInBox(const CVector2& c_min,
+                              const CVector2& c_max,
+                              VISITOR& c_visitor) const {
+            if (m_tNodes.empty()) return;
+            UInt32 punStack[64];
+            UInt32 unStackSize = 0;
+            punStack[unStackSize++] = 0;
+            while (unStackSize > 0) {
+                const SNode& sNode = m_tNodes[punStack[--unStackSize]];
+                if (sNode.Max.GetX() < c_min.GetX() || sNode.Min.GetX() > c_max.GetX() ||
+                    sNode.Max.GetY() < c_min.GetY() || sNode.Min.GetY() > c_max.GetY()) {
+                    continue;
+                }
+                if (sNode.Count > 0) {
+                    for (UInt32 i = sNode.Index; i < sNode.Index + sNode.Count; ++i) {
+                        c_visitor(m_tSegments[i]);
+                    }
+                } else {
+                    punStack[unStackSize++] = sNode.Index;
+                    punStack[unStackSize++] = static_cast<UInt32>(&sNode - &m_tNodes[0]) + 1;
+                }
+            }
+        }
+
+        inline const TSegments& GetSegments() const {
+            return m_tSegments;
+        }
+
+        inline const TNodes& GetNodes() const {
+            return m_tNodes;
+        }
+
+        inline Real GetRadius() const {
+            return m_fRadius;
+        }
+
+    private:
+
+        UInt32 BuildNode(std::vector<SSegment>& vec_segments,
+                         std::vector<SNode>& vec_nodes,
+                         UInt32 un_first,
+                         UInt32 un_count,
+                         UInt32 un_depth) const;
+
+        /**
+         * Intersects the ray c_start + t * c_dir with a segment, returns the
+         * smallest t in [0, f_t_max] or a negative value if there is none.
+         */
+        Real IntersectSegment(const SSegment& s_segment,
+                              const CVector2& c_start,
+                              const CVector2& c_dir,
+                              Real f_t_max) const;
+
+    private:
+
+        TSegments m_tSegments;
+        TNodes    m_tNodes;
+        Real      m_fRadius;
+    };
+
+}
+
+#endif
@@ -0,0 +1,204 @@
+#include "deepracer_snapshot.h"
+
+#include <argos3/core/control_interface/ci_controller.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/plugins/simulator/entities/battery_equipped_entity.h>
+
+#include <cstring>
+#include <type_traits>
+
+#include "deepracer_entity.h"
+#include "deepracer_imu_default_sensor.h"
+#include "deepracer_raster_scene.h"
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    static_assert(std::is_trivially_copyable<CDeepracerSnapshot::SRobotState>::value,
+                  "DeepRacer snapshot states must be copyable as plain bytes");
+
+    /****************************************/
+    /****************************************/
+
+    static void ToArray(const CVector3& c_vec, Real* pf_array) {
+        pf_array[0] = c_vec.GetX();
+        pf_array[1] = c_vec.GetY();
+        pf_array[2] = c_vec.GetZ();
+    }
+
+    static void ToArray(const CQuaternion& c_quat, Real* pf_array) {
+        pf_array[0] = c_quat.GetW();
+        pf_array[1] = c_quat.GetX();
+        pf_array[2] = c_quat.GetY();
+        pf_array[3] = c_quat.GetZ();
+    }
+
+    static CVector3 ToVector3(const Real* pf_array) {
+        return CVector3(pf_array[0], pf_array[1], pf_array[2]);
+    }
+
+    static CQuaternion ToQuaternion(const Real* pf_array) {
+        return CQuaternion(pf_array[0], pf_array[1], pf_array[2], pf_array[3]);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    static CDynamics2DDeepracerModel* GetDeepracerModel(CDeepracerEntity& c_robot) {
+        CEmbodiedEntity& cBody = c_robot.GetEmbodiedEntity();
+        for (size_t i = 0; i < cBody.GetPhysicsModelsNum(); ++i) {
+            CDynamics2DDeepracerModel* pcModel = dynamic_cast<CDynamics2DDeepracerModel*>(&cBody.GetPhysicsModel(i));
+            if (pcModel != NULL) return pcModel;
+        }
+        return NULL;
+    }
+
+    static CDeepracerIMUDefaultSensor* GetIMUSensor(CDeepracerEntity& c_robot) {
+        CCI_Controller::TMapSensors& tSensors = c_robot.GetControllableEntity().GetController().GetAllSensors();
+        CCI_Controller::TMapSensors::iterator itSensor = tSensors.find("deepracer_imu");
+        if (itSensor == tSensors.end()) return NULL;
+        return dynamic_cast<CDeepracerIMUDefaultSensor*>(itSensor->second);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerSnapshot::CDeepracerSnapshot() :
+        m_pcRNG(NULL) {
+        ::memset(&m_sHeader, 0, sizeof(m_sHeader));
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSnapshot::CollectRobots() {
+        m_vecRobots = CDeepracerEntity::CollectDeepracers();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSnapshot::Capture() {
+        CollectRobots();
+        m_sHeader.Clock     = CSimulator::GetInstance().GetSpace().GetSimulationClock();
+        if (m_pcRNG == NULL) m_pcRNG = CRandom::CreateRNG("argos");
+        m_sHeader.RNGSeed   = m_pcRNG->Uniform(CRange<UInt32>(0, 0xFFFFFFFF));
+        m_sHeader.NumRobots = m_vecRobots.size();
+        m_vecStates.resize(m_vecRobots.size());
+        m_vecRobotIds.resize(m_vecRobots.size());
+        for (size_t i = 0; i < m_vecRobots.size(); ++i) {
+            CDeepracerEntity& cRobot = *m_vecRobots[i];
+            SRobotState& sState = m_vecStates[i];
+            ::memset(&sState, 0, sizeof(sState));
+            m_vecRobotIds[i] = cRobot.GetId();
+            /* Pose */
+            ToArray(cRobot.GetEmbodiedEntity().GetOriginAnchor().Position, sState.Position);
+            ToArray(cRobot.GetEmbodiedEntity().GetOriginAnchor().Orientation, sState.Orientation);
+            /* Chipmunk body */
+            CDynamics2DDeepracerModel* pcModel = GetDeepracerModel(cRobot);
+            sState.HasBody = (pcModel != NULL);
+            if (sState.HasBody) pcModel->GetBodyState(sState.Body);
+            /* Actuated wheels */
+            sState.SteeringAngle = *cRobot.GetWheeledEntity().GetSteeringAngle();
+            ::memcpy(sState.WheelVelocities, cRobot.GetWheeledEntity().GetWheelVelocities(), sizeof(sState.WheelVelocities));
+            /* Sensors */
+            CDeepracerIMUDefaultSensor* pcIMU = GetIMUSensor(cRobot);
+            sState.HasIMU = (pcIMU != NULL);
+            if (sState.HasIMU) {
+                CDeepracerIMUDefaultSensor::SState sIMU;
+                pcIMU->GetState(sIMU);
+                ToArray(sIMU.Position, sState.IMUPosition);
+                ToArray(sIMU.Orientation, sState.IMUOrientation);
+                ToArray(sIMU.LinVel, sState.IMULinVel);
+                sState.IMUPreviousTime = sIMU.PreviousTime;
+            }
+            sState.HasBattery = cRobot.HasBatteryEquippedEntity();
+            if (sState.HasBattery) sState.BatteryCharge = cRobot.GetBatteryEquippedEntity().GetAvailableCharge();
+            sState.NumActiveContacts = cRobot.GetNumActiveContacts();
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSnapshot::Restore(bool b_restore_clock) {
+        /* Re-collect the robots, the space may have changed since the capture */
+        CollectRobots();
+        if (m_vecRobots.size() != m_vecStates.size()) {
+            THROW_ARGOSEXCEPTION("Can't restore a snapshot of " << m_vecStates.size() << " DeepRacers into a space with " << m_vecRobots.size());
+        }
+        for (size_t i = 0; i < m_vecRobots.size(); ++i) {
+            RestoreRobot(i);
+        }
+        if (b_restore_clock) {
+            CSimulator::GetInstance().GetSpace().SetSimulationClock(m_sHeader.Clock);
+        }
+        /* The robots moved: cameras must not reuse the scene of this step */
+        CDeepracerRasterScene::InvalidateShared();
+        /* Same snapshot, same random streams */
+        CRandom::GetCategory("argos").SetSeed(m_sHeader.RNGSeed);
+        CRandom::GetCategory("argos").ResetRNGs();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSnapshot::RestoreRobot(size_t un_index) {
+        if (un_index >= m_vecRobots.size() || un_index >= m_vecStates.size()) {
+            THROW_ARGOSEXCEPTION("DeepRacer " << un_index << " is not part of the snapshot");
+        }
+        CDeepracerEntity& cRobot = *m_vecRobots[un_index];
+        const SRobotState& sState = m_vecStates[un_index];
+        if (cRobot.GetId() != m_vecRobotIds[un_index]) {
+            THROW_ARGOSEXCEPTION("Can't restore the snapshot of DeepRacer \"" << m_vecRobotIds[un_index] << "\" into \"" << cRobot.GetId() << "\"");
+        }
+        /* Pose, ignoring collisions: the snapshot was a valid configuration */
+        cRobot.GetEmbodiedEntity().MoveTo(ToVector3(sState.Position), ToQuaternion(sState.Orientation), false, true);
+        /* Chipmunk body */
+        CDynamics2DDeepracerModel* pcModel = GetDeepracerModel(cRobot);
+        if (sState.HasBody && pcModel != NULL) pcModel->SetBodyState(sState.Body);
+        /* Actuated wheels (all of them turn at the same speed) */
+        cRobot.GetWheeledEntity().SetSteeringAndThrottle(sState.SteeringAngle, sState.WheelVelocities[0]);
+        /* Sensors */
+        CDeepracerIMUDefaultSensor* pcIMU = GetIMUSensor(cRobot);
+        if (sState.HasIMU && pcIMU != NULL) {
+            CDeepracerIMUDefaultSensor::SState sIMU;
+            sIMU.Position     = ToVector3(sState.IMUPosition);
+            sIMU.Orientation  = ToQuaternion(sState.IMUOrientation);
+            sIMU.LinVel       = ToVector3(sState.IMULinVel);
+            sIMU.PreviousTime = sState.IMUPreviousTime;
+            pcIMU->SetState(sIMU);
+        }
+        if (sState.HasBattery && cRobot.HasBatteryEquippedEntity()) {
+            cRobot.GetBatteryEquippedEntity().SetAvailableCharge(sState.BatteryCharge);
+        }
+        cRobot.GetContacts().clear();
+        cRobot.SetNumActiveContacts(sState.NumActiveContacts);
+        cRobot.UpdateComponents();
+        CDeepracerRasterScene::InvalidateShared();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSnapshot::Set(const SHeader& s_header,
+                                 const std::vector<std::string>& vec_robot_ids,
+                                 const SRobotState* ps_states) {
+        if (vec_robot_ids.size() != s_header.NumRobots) {
+            THROW_ARGOSEXCEPTION("The snapshot header lists " << s_header.NumRobots << " DeepRacers, but " << vec_robot_ids.size() << " ids were given");
+        }
+        m_sHeader     = s_header;
+        m_vecRobotIds = vec_robot_ids;
+        m_vecStates.resize(s_header.NumRobots);
+        ::memcpy(m_vecStates.data(), ps_states, s_header.NumRobots * sizeof(SRobotState));
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
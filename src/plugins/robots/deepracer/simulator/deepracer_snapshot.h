@@ -0,0 +1,146 @@
+#ifndef DEEPRACER_SNAPSHOT_H
+#define DEEPRACER_SNAPSHOT_H
+
+namespace argos {
+    class CDeepracerEntity;
+    class CDeepracerSnapshot;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/math/quaternion.h>
+#include <argos3/core/utility/math/rng.h>
+#include <argos3/core/utility/math/vector3.h>
+
+#include <string>
+#include <vector>
+
+#include "dynamics2d_deepracer_model.h"
+
+namespace argos {
+
+    /**
+     * A snapshot of the state of all the DeepRacers in the space.
+     *
+     * The state of each robot is a flat, trivially copyable record, and the
+     * records are stored contiguously, so a snapshot can be copied, stored or
+     * sent around as a plain byte buffer. Restoring writes the records back
+     * into the robots without going through the Reset() of the composable
+     * tree, so it works with any saved state, not only the initial one.
+     *
+     * Controllers are not part of the snapshot: their state is their own.
+     * The random number generators can't be saved, so Capture() draws a seed
+     * that Restore() applies to the "argos" category: the random streams after
+     * a restore are the same every time the same snapshot is restored.
+     */
+    class CDeepracerSnapshot {
+    public:
+
+        /**
+         * The state of a single robot.
+         */
+        struct SRobotState {
+            /** Position (X,Y,Z) */
+            Real                                       Position[3];
+            /** Orientation (W,X,Y,Z) */
+            Real                                       Orientation[4];
+            /** Body and control velocities, valid if HasBody is true */
+            CDynamics2DDeepracerModel::SMigrationState Body;
+            Real                                       SteeringAngle;
+            Real                                       WheelVelocities[4];
+            /** IMU differentiation state, valid if HasIMU is true */
+            Real                                       IMUPosition[3];
+            Real                                       IMUOrientation[4];
+            Real                                       IMULinVel[3];
+            Real                                       IMUPreviousTime;
+            /** Available battery charge, valid if HasBattery is true */
+            Real                                       BatteryCharge;
+            UInt32                                     NumActiveContacts;
+            bool                                       HasBody;
+            bool                                       HasIMU;
+            bool                                       HasBattery;
+        };
+
+        /**
+         * The header of a snapshot.
+         */
+        struct SHeader {
+            /** Simulation clock at capture time */
+            UInt32 Clock;
+            /** Seed for the random number generators after restoring */
+            UInt32 RNGSeed;
+            /** Number of robots */
+            UInt32 NumRobots;
+        };
+
+    public:
+
+        CDeepracerSnapshot();
+
+        /**
+         * Captures the state of all the DeepRacers in the space. The robots are
+         * stored in the order of their ids.
+         */
+        void Capture();
+
+        /**
+         * Restores the captured state. The same robots must be in the space.
+         * @param b_restore_clock whether the simulation clock is restored too.
+         * @throws CARGoSException if the robots don't match the snapshot.
+         */
+        void Restore(bool b_restore_clock = true);
+
+        /**
+         * Restores the captured state of a single robot, leaving the others,
+         * the clock and the random streams alone. The robots are those of the
+         * last Capture() or Restore().
+         * @param un_index the index of the robot, in the order of the states.
+         * @throws CARGoSException if the robot doesn't match the snapshot.
+         */
+        void RestoreRobot(size_t un_index);
+
+        inline const SHeader& GetHeader() const {
+            return m_sHeader;
+        }
+
+        inline const std::vector<SRobotState>& GetStates() const {
+            return m_vecStates;
+        }
+
+        inline std::vector<SRobotState>& GetStates() {
+            return m_vecStates;
+        }
+
+        /**
+         * Returns the robot ids, in the order of the states.
+         */
+        inline const std::vector<std::string>& GetRobotIds() const {
+            return m_vecRobotIds;
+        }
+
+        /**
+         * Sets the snapshot from externally stored data, e.g., a buffer filled
+         * by a previous Capture() in the same experiment.
+         */
+        void Set(const SHeader& s_header,
+                 const std::vector<std::string>& vec_robot_ids,
+                 const SRobotState* ps_states);
+
+    private:
+
+        /**
+         * Collects the DeepRacers in the space, sorted by id.
+         */
+        void CollectRobots();
+
+    private:
+
+        SHeader                        m_sHeader;
+        std::vector<SRobotState>       m_vecStates;
+        std::vector<std::string>       m_vecRobotIds;
+        std::vector<CDeepracerEntity*> m_vecRobots;
+        CRandom::CRNG*                 m_pcRNG;
+    };
+
+}
+
+#endif
@@ -0,0 +1,209 @@
+#include "deepracer_software_rasterizer.h"
+
+#include <cmath>
+
+#include "deepracer_thread_pool.h"
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    /* Closest rendered distance [m] */
+    static const Real NEAR_PLANE = 0.01;
+
+    /* Color of the pixels no triangle covers */
+    static const UInt8 BACKGROUND_COLOR[3] = {170, 200, 230};
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerSoftwareRasterizer::CDeepracerSoftwareRasterizer(UInt32 un_width,
+                                                               UInt32 un_height,
+                                                               Real f_focal_length,
+                                                               Real f_far,
+                                                               UInt32 un_tile_size) :
+        m_unWidth(un_width),
+        m_unHeight(un_height),
+        m_fFocalLength(f_focal_length),
+        m_fFar(f_far),
+        m_unTileSize(un_tile_size),
+        m_unTilesX((un_width + un_tile_size - 1) / un_tile_size),
+        m_unTilesY((un_height + un_tile_size - 1) / un_tile_size),
+        m_vecPixels(3 * un_width * un_height),
+        m_vecInvDepth(un_width * un_height),
+        m_vecBins(m_unTilesX * m_unTilesY) {}
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSoftwareRasterizer::Render(const CDeepracerRasterScene& c_scene,
+                                              const CVector3& c_position,
+                                              const CQuaternion& c_orientation,
+                                              const CEntity* pc_exclude,
+                                              CDeepracerThreadPool* pc_pool) {
+        m_cPosition       = c_position;
+        m_cInvOrientation = c_orientation.Inverse();
+        m_vecTriangles.clear();
+        for (size_t i = 0; i < m_vecBins.size(); ++i) {
+            m_vecBins[i].clear();
+        }
+        /* Footprint of the view: the camera and the corners of the far plane */
+        Real fHalfW = 0.5 * m_unWidth  / m_fFocalLength;
+        Real fHalfH = 0.5 * m_unHeight / m_fFocalLength;
+        CVector2 cMin(c_position.GetX(), c_position.GetY()), cMax(cMin);
+        for (UInt32 i = 0; i < 4; ++i) {
+            CVector3 cCorner(m_fFar,
+                             ((i & 1) ? fHalfW : -fHalfW) * m_fFar,
+                             ((i & 2) ? fHalfH : -fHalfH) * m_fFar);
+            cCorner.Rotate(c_orientation);
+            cCorner += c_position;
+            cMin.Set(Min(cMin.GetX(), cCorner.GetX()), Min(cMin.GetY(), cCorner.GetY()));
+            cMax.Set(Max(cMax.GetX(), cCorner.GetX()), Max(cMax.GetY(), cCorner.GetY()));
+        }
+        /* Transform, cull, clip, project and bin */
+        auto cVisit = [this, pc_exclude, fHalfW, fHalfH](const CDeepracerRasterScene::STriangle& s_triangle) {
+            if (pc_exclude != NULL && s_triangle.Owner == pc_exclude) return;
+            CVector3 pcLocal[3];
+            UInt32 unBehind = 0, unFar = 0, unLeft = 0, unRight = 0, unAbove = 0, unBelow = 0;
+            for (UInt32 i = 0; i < 3; ++i) {
+                pcLocal[i] = s_triangle.V[i] - m_cPosition;
+                pcLocal[i].Rotate(m_cInvOrientation);
+                Real fX = pcLocal[i].GetX();
+                unBehind += (fX < NEAR_PLANE);
+                unFar    += (fX > m_fFar);
+                unLeft   += (pcLocal[i].GetY() >  fHalfW * fX);
+                unRight  += (pcLocal[i].GetY() < -fHalfW * fX);
+                unAbove  += (pcLocal[i].GetZ() >  fHalfH * fX);
+                unBelow  += (pcLocal[i].GetZ() < -fHalfH * fX);
+            }
+            /* Entirely outside one of the planes of the frustum */
+            if (unBehind == 3 || unFar == 3 || unLeft == 3 || unRight == 3 || unAbove == 3 || unBelow == 3) return;
+            AddTriangle(pcLocal, s_triangle.Color);
+        };
+        c_scene.ForTrianglesInBox(cMin, cMax, cVisit);
+        /* Fill the tiles */
+        if (pc_pool != NULL) {
+            pc_pool->ParallelFor(m_vecBins.size(), [this](UInt32 un_tile) { FillTile(un_tile); });
+        } else {
+            for (UInt32 i = 0; i < m_vecBins.size(); ++i) {
+                FillTile(i);
+            }
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSoftwareRasterizer::AddTriangle(const CVector3* pc_vertices,
+                                                   const UInt8* pun_color) {
+        /* Clip against the near plane: a triangle becomes at most a quad */
+        CVector3 pcClipped[4];
+        UInt32 unClipped = 0;
+        for (UInt32 i = 0; i < 3; ++i) {
+            const CVector3& cCur  = pc_vertices[i];
+            const CVector3& cNext = pc_vertices[(i + 1) % 3];
+            bool bCurIn  = cCur.GetX()  >= NEAR_PLANE;
+            bool bNextIn = cNext.GetX() >= NEAR_PLANE;
+            if (bCurIn) pcClipped[unClipped++] = cCur;
+            if (bCurIn != bNextIn) {
+                Real fT = (NEAR_PLANE - cCur.GetX()) / (cNext.GetX() - cCur.GetX());
+                pcClipped[unClipped++] = cCur + (cNext - cCur) * fT;
+            }
+        }
+        for (UInt32 i = 2; i < unClipped; ++i) {
+            AddScreenTriangle(pcClipped[0], pcClipped[i - 1], pcClipped[i], pun_color);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSoftwareRasterizer::AddScreenTriangle(const CVector3& c_a,
+                                                         const CVector3& c_b,
+                                                         const CVector3& c_c,
+                                                         const UInt8* pun_color) {
+        SScreenTriangle sTriangle;
+        const CVector3* pcVertices[3] = { &c_a, &c_b, &c_c };
+        for (UInt32 i = 0; i < 3; ++i) {
+            Real fInvDepth = 1.0 / pcVertices[i]->GetX();
+            sTriangle.X[i] = 0.5 * m_unWidth  - m_fFocalLength * pcVertices[i]->GetY() * fInvDepth;
+            sTriangle.Y[i] = 0.5 * m_unHeight - m_fFocalLength * pcVertices[i]->GetZ() * fInvDepth;
+            sTriangle.InvDepth[i] = fInvDepth;
+        }
+        Real fArea = (sTriangle.X[1] - sTriangle.X[0]) * (sTriangle.Y[2] - sTriangle.Y[0]) -
+                     (sTriangle.Y[1] - sTriangle.Y[0]) * (sTriangle.X[2] - sTriangle.X[0]);
+        if (Abs(fArea) < 1e-9) return;
+        /* Pixel centers covered by the bounding box */
+        Real fMinX = Min(sTriangle.X[0], Min(sTriangle.X[1], sTriangle.X[2]));
+        Real fMaxX = Max(sTriangle.X[0], Max(sTriangle.X[1], sTriangle.X[2]));
+        Real fMinY = Min(sTriangle.Y[0], Min(sTriangle.Y[1], sTriangle.Y[2]));
+        Real fMaxY = Max(sTriangle.Y[0], Max(sTriangle.Y[1], sTriangle.Y[2]));
+        sTriangle.MinX = static_cast<SInt32>(Max<Real>(::ceil(fMinX - 0.5), 0.0));
+        sTriangle.MinY = static_cast<SInt32>(Max<Real>(::ceil(fMinY - 0.5), 0.0));
+        sTriangle.MaxX = static_cast<SInt32>(Min<Real>(::floor(fMaxX - 0.5), m_unWidth  - 1.0));
+        sTriangle.MaxY = static_cast<SInt32>(Min<Real>(::floor(fMaxY - 0.5), m_unHeight - 1.0));
+        if (sTriangle.MinX > sTriangle.MaxX || sTriangle.MinY > sTriangle.MaxY) return;
+        sTriangle.Color[0] = pun_color[0];
+        sTriangle.Color[1] = pun_color[1];
+        sTriangle.Color[2] = pun_color[2];
+        UInt32 unIndex = m_vecTriangles.size();
+        m_vecTriangles.push_back(sTriangle);
+        for (UInt32 nTY = sTriangle.MinY / m_unTileSize; nTY <= sTriangle.MaxY / m_unTileSize; ++nTY) {
+            for (UInt32 nTX = sTriangle.MinX / m_unTileSize; nTX <= sTriangle.MaxX / m_unTileSize; ++nTX) {
+                m_vecBins[nTY * m_unTilesX + nTX].push_back(unIndex);
+            }
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSoftwareRasterizer::FillTile(UInt32 un_tile) {
+        SInt32 nX0 = (un_tile % m_unTilesX) * m_unTileSize;
+        SInt32 nY0 = (un_tile / m_unTilesX) * m_unTileSize;
+        SInt32 nX1 = Min<SInt32>(nX0 + m_unTileSize, m_unWidth)  - 1;
+        SInt32 nY1 = Min<SInt32>(nY0 + m_unTileSize, m_unHeight) - 1;
+        /* Background */
+        for (SInt32 nY = nY0; nY <= nY1; ++nY) {
+            for (SInt32 nX = nX0; nX <= nX1; ++nX) {
+                UInt32 unPixel = nY * m_unWidth + nX;
+                m_vecInvDepth[unPixel] = 0.0f;
+                m_vecPixels[3 * unPixel]     = BACKGROUND_COLOR[0];
+                m_vecPixels[3 * unPixel + 1] = BACKGROUND_COLOR[1];
+                m_vecPixels[3 * unPixel + 2] = BACKGROUND_COLOR[2];
+            }
+        }
+        /* Triangles, with a depth test on the inverse depth (interpolated linearly in screen space) */
+        const std::vector<UInt32>& vecBin = m_vecBins[un_tile];
+        for (size_t t = 0; t < vecBin.size(); ++t) {
+            const SScreenTriangle& sTri = m_vecTriangles[vecBin[t]];
+            Real fInvArea = 1.0 / ((sTri.X[1] - sTri.X[0]) * (sTri.Y[2] - sTri.Y[0]) -
+                                   (sTri.Y[1] - sTri.Y[0]) * (sTri.X[2] - sTri.X[0]));
+            SInt32 nMinX = Max(sTri.MinX, nX0), nMaxX = Min(sTri.MaxX, nX1);
+            SInt32 nMinY = Max(sTri.MinY, nY0), nMaxY = Min(sTri.MaxY, nY1);
+            for (SInt32 nY = nMinY; nY <= nMaxY; ++nY) {
+                Real fPY = nY + 0.5;
+                for (SInt32 nX = nMinX; nX <= nMaxX; ++nX) {
+                    Real fPX = nX + 0.5;
+                    /* Barycentric coordinates; their sign does not depend on the winding */
+                    Real fW0 = ((sTri.X[2] - sTri.X[1]) * (fPY - sTri.Y[1]) - (sTri.Y[2] - sTri.Y[1]) * (fPX - sTri.X[1])) * fInvArea;
+                    Real fW1 = ((sTri.X[0] - sTri.X[2]) * (fPY - sTri.Y[2]) - (sTri.Y[0] - sTri.Y[2]) * (fPX - sTri.X[2])) * fInvArea;
+                    Real fW2 = 1.0 - fW0 - fW1;
+                    if (fW0 < 0.0 || fW1 < 0.0 || fW2 < 0.0) continue;
+                    float fInvDepth = static_cast<float>(fW0 * sTri.InvDepth[0] + fW1 * sTri.InvDepth[1] + fW2 * sTri.InvDepth[2]);
+                    UInt32 unPixel = nY * m_unWidth + nX;
+                    if (fInvDepth <= m_vecInvDepth[unPixel]) continue;
+                    m_vecInvDepth[unPixel] = fInvDepth;
+                    m_vecPixels[3 * unPixel]     = sTri.Color[0];
+                    m_vecPixels[3 * unPixel + 1] = sTri.Color[1];
+                    m_vecPixels[3 * unPixel + 2] = sTri.Color[2];
+                }
+            }
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
@@ -0,0 +1,120 @@
+#ifndef DEEPRACER_SOFTWARE_RASTERIZER_H
+#define DEEPRACER_SOFTWARE_RASTERIZER_H
+
+namespace argos {
+    class CDeepracerSoftwareRasterizer;
+    class CDeepracerThreadPool;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/math/quaternion.h>
+#include <argos3/core/utility/math/vector3.h>
+
+#include <vector>
+
+#include "deepracer_raster_scene.h"
+
+namespace argos {
+
+    /**
+     * Renders a CDeepracerRasterScene from a pinhole camera into an RGB
+     * image, on the CPU.
+     *
+     * The triangles around the camera are transformed into its frame,
+     * clipped against the near plane, projected and binned into square
+     * tiles; the tiles are then filled independently, with a depth test, so
+     * they can be spread over a thread pool. All buffers are kept between
+     * frames.
+     */
+    class CDeepracerSoftwareRasterizer {
+    public:
+
+        /**
+         * @param un_width image width [pixels].
+         * @param un_height image height [pixels].
+         * @param f_focal_length focal length [pixels].
+         * @param f_far farthest rendered distance [m].
+         * @param un_tile_size side of a tile [pixels].
+         */
+        CDeepracerSoftwareRasterizer(UInt32 un_width,
+                                     UInt32 un_height,
+                                     Real f_focal_length,
+                                     Real f_far,
+                                     UInt32 un_tile_size = 16);
+
+        /**
+         * Renders the scene seen from the given pose: X forward, Y left, Z up.
+         * @param pc_exclude triangles owned by this entity are not drawn (the robot itself).
+         * @param pc_pool the pool filling the tiles, or NULL to fill them in the calling thread.
+         */
+        void Render(const CDeepracerRasterScene& c_scene,
+                    const CVector3& c_position,
+                    const CQuaternion& c_orientation,
+                    const CEntity* pc_exclude = NULL,
+                    CDeepracerThreadPool* pc_pool = NULL);
+
+        /**
+         * Returns the image: rows from top to bottom, 3 bytes (RGB) per pixel.
+         */
+        inline const UInt8* GetPixels() const {
+            return m_vecPixels.data();
+        }
+
+        inline UInt32 GetWidth() const {
+            return m_unWidth;
+        }
+
+        inline UInt32 GetHeight() const {
+            return m_unHeight;
+        }
+
+    private:
+
+        struct SScreenTriangle {
+            /** Pixel coordinates and inverse depth of the vertices */
+            Real   X[3];
+            Real   Y[3];
+            Real   InvDepth[3];
+            /** Pixel bounding box, clamped to the image */
+            SInt32 MinX, MinY, MaxX, MaxY;
+            UInt8  Color[3];
+        };
+
+        /**
+         * Clips a triangle in the camera frame and adds the visible parts.
+         */
+        void AddTriangle(const CVector3* pc_vertices,
+                         const UInt8* pun_color);
+
+        void AddScreenTriangle(const CVector3& c_a,
+                               const CVector3& c_b,
+                               const CVector3& c_c,
+                               const UInt8* pun_color);
+
+        void FillTile(UInt32 un_tile);
+
+    private:
+
+        UInt32 m_unWidth;
+        UInt32 m_unHeight;
+        Real   m_fFocalLength;
+        Real   m_fFar;
+        UInt32 m_unTileSize;
+        UInt32 m_unTilesX;
+        UInt32 m_unTilesY;
+
+        /** Camera pose of the frame being rendered */
+        CVector3    m_cPosition;
+        CQuaternion m_cInvOrientation;
+
+        std::vector<UInt8>                m_vecPixels;
+        /** Inverse depth of the closest surface per pixel, 0 for the background */
+        std::vector<float>                m_vecInvDepth;
+        std::vector<SScreenTriangle>      m_vecTriangles;
+        /** Triangles overlapping each tile */
+        std::vector<std::vector<UInt32> > m_vecBins;
+    };
+
+}
+
+#endif
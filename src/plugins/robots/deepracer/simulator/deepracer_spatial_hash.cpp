@@ -0,0 +1,120 @@
+#include "deepracer_spatial_hash.h"
+
+#include <cmath>
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    static Real SegmentPointDistance(const CVector2& c_start,
+                                     const CVector2& c_end,
+                                     const CVector2& c_point) {
+        CVector2 cSeg = c_end - c_start;
+        Real fLength2 = cSeg.SquareLength();
+        if (fLength2 == 0.0) return (c_point - c_start).Length();
+        Real fT = Min(Max((c_point - c_start).DotProduct(cSeg) / fLength2, 0.0), 1.0);
+        return (c_point - (c_start + cSeg * fT)).Length();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerSpatialHash::CDeepracerSpatialHash(Real f_cell_size) :
+        m_fCellSize(f_cell_size) {}
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSpatialHash::AddCircle(const CVector2& c_center,
+                                          Real f_radius) {
+        SObstacle sObstacle = { SHAPE_CIRCLE, c_center, c_center, f_radius };
+        m_vecObstacles.push_back(sObstacle);
+        AddToCells(m_vecObstacles.size() - 1,
+                   c_center - CVector2(f_radius, f_radius),
+                   c_center + CVector2(f_radius, f_radius));
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSpatialHash::AddBox(const CVector2& c_min,
+                                       const CVector2& c_max) {
+        SObstacle sObstacle = { SHAPE_BOX, c_min, c_max, 0.0 };
+        m_vecObstacles.push_back(sObstacle);
+        AddToCells(m_vecObstacles.size() - 1, c_min, c_max);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSpatialHash::AddSegment(const CVector2& c_start,
+                                           const CVector2& c_end,
+                                           Real f_radius) {
+        SObstacle sObstacle = { SHAPE_SEGMENT, c_start, c_end, f_radius };
+        m_vecObstacles.push_back(sObstacle);
+        UInt32 unIdx = m_vecObstacles.size() - 1;
+        /* Only the cells the segment passes close to, not its whole bounding box */
+        Real fReach = f_radius + m_fCellSize * 0.7072; // half diagonal of a cell
+        for (SInt32 nX = GetCell(Min(c_start.GetX(), c_end.GetX()) - f_radius);
+             nX <= GetCell(Max(c_start.GetX(), c_end.GetX()) + f_radius);
+             ++nX) {
+            for (SInt32 nY = GetCell(Min(c_start.GetY(), c_end.GetY()) - f_radius);
+                 nY <= GetCell(Max(c_start.GetY(), c_end.GetY()) + f_radius);
+                 ++nY) {
+                CVector2 cCellCenter((nX + 0.5) * m_fCellSize, (nY + 0.5) * m_fCellSize);
+                if (SegmentPointDistance(c_start, c_end, cCellCenter) <= fReach) {
+                    m_mapCells[GetKey(nX, nY)].push_back(unIdx);
+                }
+            }
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSpatialHash::AddToCells(UInt32 un_obstacle,
+                                           const CVector2& c_min,
+                                           const CVector2& c_max) {
+        for (SInt32 nX = GetCell(c_min.GetX()); nX <= GetCell(c_max.GetX()); ++nX) {
+            for (SInt32 nY = GetCell(c_min.GetY()); nY <= GetCell(c_max.GetY()); ++nY) {
+                m_mapCells[GetKey(nX, nY)].push_back(un_obstacle);
+            }
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    bool CDeepracerSpatialHash::IsFree(const CVector2& c_center,
+                                       Real f_radius) const {
+        for (SInt32 nX = GetCell(c_center.GetX() - f_radius); nX <= GetCell(c_center.GetX() + f_radius); ++nX) {
+            for (SInt32 nY = GetCell(c_center.GetY() - f_radius); nY <= GetCell(c_center.GetY() + f_radius); ++nY) {
+                std::unordered_map<UInt64, std::vector<UInt32> >::const_iterator itCell = m_mapCells.find(GetKey(nX, nY));
+                if (itCell == m_mapCells.end()) continue;
+                for (size_t i = 0; i < itCell->second.size(); ++i) {
+                    const SObstacle& sObs = m_vecObstacles[itCell->second[i]];
+                    switch (sObs.Shape) {
+                        case SHAPE_CIRCLE:
+                            if ((c_center - sObs.A).Length() < f_radius + sObs.Radius) return false;
+                            break;
+                        case SHAPE_BOX: {
+                            CVector2 cClosest(Min(Max(c_center.GetX(), sObs.A.GetX()), sObs.B.GetX()),
+                                              Min(Max(c_center.GetY(), sObs.A.GetY()), sObs.B.GetY()));
+                            if ((c_center - cClosest).Length() < f_radius) return false;
+                            break;
+                        }
+                        case SHAPE_SEGMENT:
+                            if (SegmentPointDistance(sObs.A, sObs.B, c_center) < f_radius + sObs.Radius) return false;
+                            break;
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
@@ -0,0 +1,85 @@
+#ifndef DEEPRACER_SPATIAL_HASH_H
+#define DEEPRACER_SPATIAL_HASH_H
+
+namespace argos {
+    class CDeepracerSpatialHash;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/math/vector2.h>
+
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+namespace argos {
+
+    /**
+     * A uniform grid hashed on the cell coordinates, used to place many robots
+     * without overlaps. Obstacles are circles, axis-aligned boxes and thick
+     * segments; each is stored in all the cells it overlaps, so a query only
+     * looks at the cells around the tested circle.
+     */
+    class CDeepracerSpatialHash {
+    public:
+
+        /**
+         * @param f_cell_size side of a cell; best set to the diameter of the placed circles.
+         */
+        CDeepracerSpatialHash(Real f_cell_size);
+
+        void AddCircle(const CVector2& c_center,
+                       Real f_radius);
+
+        void AddBox(const CVector2& c_min,
+                    const CVector2& c_max);
+
+        void AddSegment(const CVector2& c_start,
+                        const CVector2& c_end,
+                        Real f_radius);
+
+        /**
+         * Returns true if the given circle does not overlap any stored obstacle.
+         */
+        bool IsFree(const CVector2& c_center,
+                    Real f_radius) const;
+
+    private:
+
+        enum EShape {
+            SHAPE_CIRCLE = 0,
+            SHAPE_BOX,
+            SHAPE_SEGMENT
+        };
+
+        struct SObstacle {
+            EShape   Shape;
+            /** Circle center, box min corner or segment start */
+            CVector2 A;
+            /** Box max corner or segment end */
+            CVector2 B;
+            Real     Radius;
+        };
+
+        inline SInt32 GetCell(Real f_coord) const {
+            return static_cast<SInt32>(::floor(f_coord / m_fCellSize));
+        }
+
+        inline static UInt64 GetKey(SInt32 n_x, SInt32 n_y) {
+            return (static_cast<UInt64>(static_cast<UInt32>(n_x)) << 32) | static_cast<UInt32>(n_y);
+        }
+
+        void AddToCells(UInt32 un_obstacle,
+                        const CVector2& c_min,
+                        const CVector2& c_max);
+
+    private:
+
+        Real                                          m_fCellSize;
+        std::vector<SObstacle>                        m_vecObstacles;
+        std::unordered_map<UInt64, std::vector<UInt32> > m_mapCells;
+    };
+
+}
+
+#endif
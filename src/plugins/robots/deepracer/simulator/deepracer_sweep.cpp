@@ -0,0 +1,386 @@
+#include "deepracer_sweep.h"
+
+#include <argos3/core/simulator/loop_functions.h>
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/core/utility/plugins/dynamic_loading.h>
+#include <argos3/core/utility/string_utilities.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "deepracer_sweep_metrics.h"
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerSweep::CDeepracerSweep(const std::string& str_experiment_file) :
+        m_strExperimentFile(str_experiment_file) {
+        try {
+            CDynamicLoading::LoadAllLibraries();
+            m_tDocument.LoadFile(str_experiment_file);
+            m_tRoot = *m_tDocument.FirstChildElement();
+            /* The runs have no visualization */
+            if (NodeExists(m_tRoot, "visualization")) {
+                m_tRoot.RemoveChild(&GetNode(m_tRoot, "visualization"));
+            }
+        } catch (CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("Error loading the base experiment \"" << str_experiment_file << "\"", ex);
+        } catch (ticpp::Exception& ex) {
+            THROW_ARGOSEXCEPTION("Error parsing the base experiment \"" << str_experiment_file << "\": " << ex.what());
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSweep::AddParameter(const std::string& str_name,
+                                       const std::vector<std::string>& vec_values) {
+        size_t unAt = str_name.find('@');
+        if (unAt == std::string::npos || unAt + 1 == str_name.size()) {
+            THROW_ARGOSEXCEPTION("Parameter \"" << str_name << "\" is not of the form \"path@attribute\"");
+        }
+        if (vec_values.empty()) {
+            THROW_ARGOSEXCEPTION("Parameter \"" << str_name << "\" has no values");
+        }
+        SParameter sParameter;
+        sParameter.Path      = str_name.substr(0, unAt);
+        sParameter.Attribute = str_name.substr(unAt + 1);
+        sParameter.Values    = vec_values;
+        std::vector<std::string> vecPath;
+        Tokenize(sParameter.Path, vecPath, "/");
+        if (SetAttribute(m_tRoot, vecPath, 0, sParameter.Attribute, NULL) == 0) {
+            THROW_ARGOSEXCEPTION("Parameter \"" << str_name << "\" matches no element of the experiment");
+        }
+        m_vecParameters.push_back(sParameter);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSweep::LoadGrid(const std::string& str_file_name) {
+        std::ifstream cFile(str_file_name.c_str());
+        if (!cFile) {
+            THROW_ARGOSEXCEPTION("Can't open the parameter grid \"" << str_file_name << "\"");
+        }
+        std::string strLine;
+        UInt32 unLine = 0;
+        while (std::getline(cFile, strLine)) {
+            ++unLine;
+            /* Strip comments */
+            strLine = strLine.substr(0, strLine.find('#'));
+            if (strLine.find_first_not_of(" \t\r") == std::string::npos) continue;
+            size_t unEquals = strLine.find('=');
+            std::vector<std::string> vecName;
+            if (unEquals != std::string::npos) {
+                Tokenize(strLine.substr(0, unEquals), vecName, " \t");
+            }
+            if (vecName.size() != 1) {
+                THROW_ARGOSEXCEPTION("Line " << unLine << " of \"" << str_file_name << "\": expected \"path@attribute = value, value, ...\"");
+            }
+            std::vector<std::string> vecValues;
+            Tokenize(strLine.substr(unEquals + 1), vecValues, ", \t\r");
+            try {
+                AddParameter(vecName[0], vecValues);
+            } catch (CARGoSException& ex) {
+                THROW_ARGOSEXCEPTION_NESTED("Line " << unLine << " of \"" << str_file_name << "\"", ex);
+            }
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    UInt32 CDeepracerSweep::GetNumRuns() const {
+        UInt32 unRuns = 1;
+        for (size_t i = 0; i < m_vecParameters.size(); ++i) {
+            unRuns *= m_vecParameters[i].Values.size();
+        }
+        return unRuns;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSweep::Run(UInt32 un_jobs,
+                              const std::string& str_results_file,
+                              const std::string& str_log_directory) {
+        if (un_jobs == 0) un_jobs = 1;
+        if (!str_log_directory.empty() &&
+            ::mkdir(str_log_directory.c_str(), 0755) != 0 && errno != EEXIST) {
+            THROW_ARGOSEXCEPTION("Can't create the log directory \"" << str_log_directory << "\": " << ::strerror(errno));
+        }
+        UInt32 unRuns = GetNumRuns();
+        std::vector<SResult> vecResults(unRuns);
+        /* Running children: pid -> (run, read end of the result pipe) */
+        std::map<pid_t, std::pair<UInt32, int> > mapRunning;
+        UInt32 unNext = 0;
+        UInt32 unDone = 0;
+        LOG << "[INFO] Sweeping " << unRuns << " runs of \"" << m_strExperimentFile
+            << "\", " << un_jobs << " at a time" << std::endl;
+        LOG.Flush();
+        while (unDone < unRuns) {
+            /* Start runs while there are free slots */
+            if (unNext < unRuns && mapRunning.size() < un_jobs) {
+                int pnPipe[2];
+                if (::pipe(pnPipe) != 0) {
+                    THROW_ARGOSEXCEPTION("Can't create a pipe for run " << unNext << ": " << ::strerror(errno));
+                }
+                /* Don't let the children inherit buffered output */
+                LOG.Flush();
+                LOGERR.Flush();
+                pid_t tPid = ::fork();
+                if (tPid < 0) {
+                    THROW_ARGOSEXCEPTION("Can't fork run " << unNext << ": " << ::strerror(errno));
+                }
+                if (tPid == 0) {
+                    ::close(pnPipe[0]);
+                    for (std::map<pid_t, std::pair<UInt32, int> >::iterator it = mapRunning.begin();
+                         it != mapRunning.end();
+                         ++it) {
+                        ::close(it->second.second);
+                    }
+                    RunChild(unNext, pnPipe[1], str_log_directory);
+                }
+                ::close(pnPipe[1]);
+                mapRunning[tPid] = std::make_pair(unNext, pnPipe[0]);
+                ++unNext;
+                continue;
+            }
+            /* Collect a finished run. A result line fits in the pipe buffer,
+               so the children never block writing it. */
+            int nStatus;
+            pid_t tPid = ::waitpid(-1, &nStatus, 0);
+            if (tPid < 0) {
+                if (errno == EINTR) continue;
+                THROW_ARGOSEXCEPTION("Error waiting for the runs: " << ::strerror(errno));
+            }
+            std::map<pid_t, std::pair<UInt32, int> >::iterator itRun = mapRunning.find(tPid);
+            if (itRun == mapRunning.end()) continue;
+            UInt32 unRun = itRun->second.first;
+            std::string strLine;
+            char pchBuffer[4096];
+            ssize_t nRead;
+            while ((nRead = ::read(itRun->second.second, pchBuffer, sizeof(pchBuffer))) > 0) {
+                strLine.append(pchBuffer, nRead);
+            }
+            ::close(itRun->second.second);
+            mapRunning.erase(itRun);
+            SResult& sResult = vecResults[unRun];
+            sResult.WallSeconds = 0.0;
+            sResult.Steps = 0;
+            if (WIFSIGNALED(nStatus)) {
+                sResult.Status = "signal " + ToString(WTERMSIG(nStatus));
+            } else if (strLine.empty()) {
+                sResult.Status = "error";
+            } else {
+                ParseResult(strLine, sResult);
+            }
+            ++unDone;
+            LOG << "[INFO] Run " << unRun << " done (" << unDone << "/" << unRuns << "): "
+                << sResult.Status << std::endl;
+            LOG.Flush();
+        }
+        WriteResults(str_results_file, vecResults);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSweep::GetCombination(UInt32 un_run,
+                                         std::vector<const std::string*>& vec_values) const {
+        vec_values.resize(m_vecParameters.size());
+        for (size_t i = m_vecParameters.size(); i-- > 0;) {
+            const std::vector<std::string>& vecValues = m_vecParameters[i].Values;
+            vec_values[i] = &vecValues[un_run % vecValues.size()];
+            un_run /= vecValues.size();
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSweep::RunChild(UInt32 un_run,
+                                   int n_result_fd,
+                                   const std::string& str_log_directory) {
+        /* Output of the run */
+        std::string strLog = "/dev/null";
+        if (!str_log_directory.empty()) {
+            std::ostringstream cName;
+            cName << str_log_directory << "/run_" << std::setw(6) << std::setfill('0') << un_run << ".log";
+            strLog = cName.str();
+        }
+        int nLog = ::open(strLog.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (nLog >= 0) {
+            ::dup2(nLog, STDOUT_FILENO);
+            ::dup2(nLog, STDERR_FILENO);
+            ::close(nLog);
+        }
+        std::ostringstream cResult;
+        cResult << std::setprecision(10);
+        int nExitCode = 0;
+        std::chrono::steady_clock::time_point tStart = std::chrono::steady_clock::now();
+        try {
+            /* Set the parameters in this copy of the configuration */
+            std::vector<const std::string*> vecValues;
+            GetCombination(un_run, vecValues);
+            for (size_t i = 0; i < m_vecParameters.size(); ++i) {
+                std::vector<std::string> vecPath;
+                Tokenize(m_vecParameters[i].Path, vecPath, "/");
+                SetAttribute(m_tRoot, vecPath, 0, m_vecParameters[i].Attribute, vecValues[i]);
+                LOG << "[INFO] " << m_vecParameters[i].Path << "@" << m_vecParameters[i].Attribute
+                    << " = " << *vecValues[i] << std::endl;
+            }
+            /* Run the experiment from the parsed configuration */
+            CSimulator& cSimulator = CSimulator::GetInstance();
+            cSimulator.SetExperimentFileName(m_strExperimentFile);
+            cSimulator.GetConfigurationRoot() = m_tRoot;
+            cSimulator.Init();
+            cSimulator.Execute();
+            CDeepracerSweepMetrics::TMetrics tMetrics;
+            CDeepracerSweepMetrics* pcMetrics = dynamic_cast<CDeepracerSweepMetrics*>(&cSimulator.GetLoopFunctions());
+            if (pcMetrics != NULL) {
+                pcMetrics->GetSweepMetrics(tMetrics);
+            }
+            UInt32 unSteps = cSimulator.GetSpace().GetSimulationClock();
+            cSimulator.Destroy();
+            cResult << "ok\t"
+                    << std::chrono::duration<Real>(std::chrono::steady_clock::now() - tStart).count() << '\t'
+                    << unSteps;
+            for (size_t i = 0; i < tMetrics.size(); ++i) {
+                cResult << '\t' << tMetrics[i].first << '=' << tMetrics[i].second;
+            }
+        } catch (CARGoSException& ex) {
+            LOGERR << "[FATAL] " << ex.what() << std::endl;
+            cResult.str("");
+            cResult << "error\t"
+                    << std::chrono::duration<Real>(std::chrono::steady_clock::now() - tStart).count() << "\t0";
+            nExitCode = 1;
+        }
+        LOG.Flush();
+        LOGERR.Flush();
+        cResult << '\n';
+        std::string strResult = cResult.str();
+        if (::write(n_result_fd, strResult.data(), strResult.size()) != static_cast<ssize_t>(strResult.size())) {
+            nExitCode = 1;
+        }
+        ::close(n_result_fd);
+        /* Skip the destructors of the state shared with the parent */
+        ::_exit(nExitCode);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    UInt32 CDeepracerSweep::SetAttribute(TConfigurationNode& t_node,
+                                         const std::vector<std::string>& vec_path,
+                                         size_t un_level,
+                                         const std::string& str_attribute,
+                                         const std::string* pstr_value) {
+        if (un_level == vec_path.size()) {
+            if (pstr_value != NULL) {
+                SetNodeAttribute(t_node, str_attribute, *pstr_value);
+            }
+            return 1;
+        }
+        UInt32 unCount = 0;
+        TConfigurationNodeIterator itChild;
+        for (itChild = itChild.begin(&t_node);
+             itChild != itChild.end();
+             ++itChild) {
+            if (vec_path[un_level] == "*" || itChild->Value() == vec_path[un_level]) {
+                unCount += SetAttribute(*itChild, vec_path, un_level + 1, str_attribute, pstr_value);
+            }
+        }
+        return unCount;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSweep::ParseResult(const std::string& str_line,
+                                      SResult& s_result) {
+        std::vector<std::string> vecFields;
+        Tokenize(str_line, vecFields, "\t\n");
+        if (vecFields.size() < 3) {
+            s_result.Status = "error";
+            return;
+        }
+        s_result.Status      = vecFields[0];
+        s_result.WallSeconds = ::strtod(vecFields[1].c_str(), NULL);
+        s_result.Steps       = ::strtoul(vecFields[2].c_str(), NULL, 10);
+        for (size_t i = 3; i < vecFields.size(); ++i) {
+            size_t unEquals = vecFields[i].find('=');
+            if (unEquals == std::string::npos) continue;
+            std::string strName = vecFields[i].substr(0, unEquals);
+            size_t unMetric = std::find(m_vecMetricNames.begin(), m_vecMetricNames.end(), strName) - m_vecMetricNames.begin();
+            if (unMetric == m_vecMetricNames.size()) {
+                m_vecMetricNames.push_back(strName);
+            }
+            if (s_result.Metrics.size() <= unMetric) {
+                s_result.Metrics.resize(unMetric + 1, NAN);
+            }
+            /* strtod also reads "nan" and "inf" */
+            s_result.Metrics[unMetric] = ::strtod(vecFields[i].c_str() + unEquals + 1, NULL);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerSweep::WriteResults(const std::string& str_file_name,
+                                       const std::vector<SResult>& vec_results) const {
+        std::ofstream cFile(str_file_name.c_str());
+        if (!cFile) {
+            THROW_ARGOSEXCEPTION("Can't write the sweep results to \"" << str_file_name << "\"");
+        }
+        cFile << std::setprecision(10) << "run";
+        for (size_t i = 0; i < m_vecParameters.size(); ++i) {
+            cFile << ',' << m_vecParameters[i].Path << '@' << m_vecParameters[i].Attribute;
+        }
+        cFile << ",status,wall_seconds,steps";
+        for (size_t i = 0; i < m_vecMetricNames.size(); ++i) {
+            cFile << ',' << m_vecMetricNames[i];
+        }
+        cFile << '\n';
+        std::vector<const std::string*> vecValues;
+        for (UInt32 r = 0; r < vec_results.size(); ++r) {
+            const SResult& sResult = vec_results[r];
+            GetCombination(r, vecValues);
+            cFile << r;
+            for (size_t i = 0; i < vecValues.size(); ++i) {
+                cFile << ',' << *vecValues[i];
+            }
+            cFile << ',' << sResult.Status << ',' << sResult.WallSeconds << ',' << sResult.Steps;
+            for (size_t i = 0; i < m_vecMetricNames.size(); ++i) {
+                cFile << ',';
+                /* Runs that failed have no metrics */
+                if (i < sResult.Metrics.size()) cFile << sResult.Metrics[i];
+            }
+            cFile << '\n';
+        }
+        if (!cFile) {
+            THROW_ARGOSEXCEPTION("Error writing the sweep results to \"" << str_file_name << "\"");
+        }
+        LOG << "[INFO] Sweep results written to \"" << str_file_name << "\"" << std::endl;
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
@@ -0,0 +1,134 @@
+#ifndef DEEPRACER_SWEEP_H
+#define DEEPRACER_SWEEP_H
+
+namespace argos {
+    class CDeepracerSweep;
+}
+
+#include <argos3/core/utility/configuration/argos_configuration.h>
+
+#include <string>
+#include <vector>
+
+namespace argos {
+
+    /**
+     * Runs an experiment for every combination of a grid of parameters,
+     * several runs at a time.
+     *
+     * The plugin libraries are loaded and the base experiment is parsed once,
+     * in this process. Each run is a child forked from it, which inherits the
+     * loaded libraries and the parsed configuration, sets the attributes of
+     * its combination in its copy of the configuration and runs the
+     * experiment without visualization. ARGoS can't run a second experiment
+     * in a process once the first is destroyed, so the warm state is kept in
+     * this process and every run gets a fresh copy of it.
+     *
+     * A parameter is an attribute of the configuration, written as a path of
+     * element names from the root followed by '@' and the attribute, as in
+     * "framework/experiment@random_seed". An element name of '*' matches any
+     * element, and the attribute is set in all the matching elements.
+     */
+    class CDeepracerSweep {
+    public:
+
+        struct SParameter {
+            std::string              Path;
+            std::string              Attribute;
+            std::vector<std::string> Values;
+        };
+
+    public:
+
+        /**
+         * Loads the plugin libraries and parses the base experiment.
+         * @throws CARGoSException if the experiment can't be parsed.
+         */
+        explicit CDeepracerSweep(const std::string& str_experiment_file);
+
+        /**
+         * Adds a parameter to the grid.
+         * @param str_name the path and attribute, as "path@attribute".
+         * @throws CARGoSException if the name is malformed or matches no element.
+         */
+        void AddParameter(const std::string& str_name,
+                          const std::vector<std::string>& vec_values);
+
+        /**
+         * Adds the parameters listed in a file, one per line as
+         * "path@attribute = value, value, ...", with '#' for comments.
+         * @throws CARGoSException if the file can't be read or parsed.
+         */
+        void LoadGrid(const std::string& str_file_name);
+
+        /**
+         * Returns the number of runs of the grid.
+         */
+        UInt32 GetNumRuns() const;
+
+        /**
+         * Runs the whole grid and writes one row per run to a CSV file.
+         * @param un_jobs the number of runs at a time.
+         * @param str_log_directory if not empty, the output of each run goes
+         * to run_<index>.log in it, otherwise it is discarded.
+         * @throws CARGoSException if the results can't be written.
+         */
+        void Run(UInt32 un_jobs,
+                 const std::string& str_results_file,
+                 const std::string& str_log_directory = "");
+
+    private:
+
+        struct SResult {
+            std::string         Status;
+            Real                WallSeconds;
+            UInt32              Steps;
+            std::vector<Real>   Metrics;
+        };
+
+        /**
+         * Returns the values of the parameters for a run; the last parameter
+         * changes fastest.
+         */
+        void GetCombination(UInt32 un_run,
+                            std::vector<const std::string*>& vec_values) const;
+
+        /**
+         * Runs one combination in a forked child and exits.
+         */
+        void RunChild(UInt32 un_run,
+                      int n_result_fd,
+                      const std::string& str_log_directory);
+
+        /**
+         * Sets an attribute in the elements matching a path, from the given
+         * level; with a NULL value, only counts them.
+         */
+        static UInt32 SetAttribute(TConfigurationNode& t_node,
+                                   const std::vector<std::string>& vec_path,
+                                   size_t un_level,
+                                   const std::string& str_attribute,
+                                   const std::string* pstr_value);
+
+        /**
+         * Parses the line written by a child.
+         */
+        void ParseResult(const std::string& str_line,
+                         SResult& s_result);
+
+        void WriteResults(const std::string& str_file_name,
+                          const std::vector<SResult>& vec_results) const;
+
+    private:
+
+        std::string              m_strExperimentFile;
+        ticpp::Document          m_tDocument;
+        TConfigurationNode       m_tRoot;
+        std::vector<SParameter>  m_vecParameters;
+        /** Names of the metrics reported by the runs, in order of appearance */
+        std::vector<std::string> m_vecMetricNames;
+    };
+
+}
+
+#endif
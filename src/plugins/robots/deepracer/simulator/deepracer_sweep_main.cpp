@@ -0,0 +1,62 @@
+#include <argos3/core/utility/configuration/command_line_arg_parser.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/plugins/robots/deepracer/simulator/deepracer_sweep.h>
+
+#include <thread>
+
+using namespace argos;
+
+int main(int argc, char* argv[]) {
+    /*
+     * Parse the command line
+     */
+    std::string strARGoSFName;
+    std::string strGridFName;
+    std::string strResultsFName = "sweep.csv";
+    std::string strLogDirectory;
+    UInt32 unJobs = std::thread::hardware_concurrency();
+    CCommandLineArgParser cCLAP;
+    cCLAP.AddArgument<std::string>(
+            'c',
+            "--config-file",
+            "the base experiment XML configuration file",
+            strARGoSFName);
+    cCLAP.AddArgument<std::string>(
+            'g',
+            "--grid",
+            "the parameter grid, one \"path@attribute = value, value, ...\" per line",
+            strGridFName);
+    cCLAP.AddArgument<std::string>(
+            'o',
+            "--output",
+            "the CSV file of the results [sweep.csv]",
+            strResultsFName);
+    cCLAP.AddArgument<UInt32>(
+            'j',
+            "--jobs",
+            "the number of runs at a time [number of cores]",
+            unJobs);
+    cCLAP.AddArgument<std::string>(
+            'l',
+            "--log-dir",
+            "the directory for the output of each run [discarded]",
+            strLogDirectory);
+    try {
+        cCLAP.Parse(argc, argv);
+        if (strARGoSFName.empty()) {
+            THROW_ARGOSEXCEPTION("Missing base experiment, use -c");
+        }
+        CDeepracerSweep cSweep(strARGoSFName);
+        if (!strGridFName.empty()) {
+            cSweep.LoadGrid(strGridFName);
+        }
+        cSweep.Run(unJobs, strResultsFName, strLogDirectory);
+    }
+    catch(CARGoSException& ex) {
+        LOGERR << ex.what() << std::endl;
+        LOGERR.Flush();
+        return 1;
+    }
+    LOG.Flush();
+    return 0;
+}
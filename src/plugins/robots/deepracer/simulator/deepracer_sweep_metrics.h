@@ -0,0 +1,39 @@
+#ifndef DEEPRACER_SWEEP_METRICS_H
+#define DEEPRACER_SWEEP_METRICS_H
+
+namespace argos {
+    class CDeepracerSweepMetrics;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace argos {
+
+    /**
+     * Interface for loop functions that report metrics to the parameter
+     * sweep runner. At the end of each run, the runner asks the loop
+     * functions of the experiment for their metrics, if they implement it,
+     * and adds one column per metric to the results.
+     */
+    class CDeepracerSweepMetrics {
+    public:
+
+        typedef std::vector<std::pair<std::string, Real> > TMetrics;
+
+    public:
+
+        virtual ~CDeepracerSweepMetrics() {}
+
+        /**
+         * Appends the metrics of the run that just ended.
+         */
+        virtual void GetSweepMetrics(TMetrics& t_metrics) = 0;
+    };
+
+}
+
+#endif
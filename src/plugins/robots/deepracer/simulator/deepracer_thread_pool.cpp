@@ -0,0 +1,106 @@
+#include "deepracer_thread_pool.h"
+
+#include <map>
+#include <memory>
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerThreadPool::CDeepracerThreadPool(UInt32 un_threads) :
+        m_pcTask(NULL),
+        m_unCount(0),
+        m_unNext(0),
+        m_unBusyWorkers(0),
+        m_unGeneration(0),
+        m_bStop(false) {
+        for (UInt32 i = 1; i < un_threads; ++i) {
+            m_vecWorkers.push_back(std::thread(&CDeepracerThreadPool::Work, this));
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerThreadPool::~CDeepracerThreadPool() {
+        {
+            std::lock_guard<std::mutex> cLock(m_cMutex);
+            m_bStop = true;
+        }
+        m_cWakeUp.notify_all();
+        for (size_t i = 0; i < m_vecWorkers.size(); ++i) {
+            m_vecWorkers[i].join();
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerThreadPool::ParallelFor(UInt32 un_count,
+                                           const TTask& c_task) {
+        if (m_vecWorkers.empty() || un_count <= 1) {
+            for (UInt32 i = 0; i < un_count; ++i) c_task(i);
+            return;
+        }
+        std::lock_guard<std::mutex> cCallLock(m_cCallMutex);
+        {
+            std::lock_guard<std::mutex> cLock(m_cMutex);
+            m_pcTask        = &c_task;
+            m_unCount       = un_count;
+            m_unNext        = 0;
+            m_unBusyWorkers = m_vecWorkers.size();
+            ++m_unGeneration;
+        }
+        m_cWakeUp.notify_all();
+        RunTasks();
+        std::unique_lock<std::mutex> cLock(m_cMutex);
+        m_cDone.wait(cLock, [this] { return m_unBusyWorkers == 0; });
+        m_pcTask = NULL;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerThreadPool::Work() {
+        UInt64 unSeenGeneration = 0;
+        std::unique_lock<std::mutex> cLock(m_cMutex);
+        while (true) {
+            m_cWakeUp.wait(cLock, [this, unSeenGeneration] {
+                return m_bStop || m_unGeneration != unSeenGeneration;
+            });
+            if (m_bStop) return;
+            unSeenGeneration = m_unGeneration;
+            cLock.unlock();
+            RunTasks();
+            cLock.lock();
+            if (--m_unBusyWorkers == 0) m_cDone.notify_one();
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerThreadPool::RunTasks() {
+        for (UInt32 i = m_unNext++; i < m_unCount; i = m_unNext++) {
+            (*m_pcTask)(i);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerThreadPool& CDeepracerThreadPool::GetShared(UInt32 un_threads) {
+        /* One pool per size, so each configuration gets the threads it asks for */
+        static std::mutex cMutex;
+        static std::map<UInt32, std::unique_ptr<CDeepracerThreadPool> > mapPools;
+        std::lock_guard<std::mutex> cLock(cMutex);
+        std::unique_ptr<CDeepracerThreadPool>& pcPool = mapPools[un_threads];
+        if (!pcPool) pcPool.reset(new CDeepracerThreadPool(un_threads));
+        return *pcPool;
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
@@ -0,0 +1,82 @@
+#ifndef DEEPRACER_THREAD_POOL_H
+#define DEEPRACER_THREAD_POOL_H
+
+namespace argos {
+    class CDeepracerThreadPool;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace argos {
+
+    /**
+     * A fixed set of worker threads running parallel loops.
+     *
+     * ParallelFor() hands out the indices one at a time, so uneven tasks
+     * balance themselves; the calling thread works as well. Calls from
+     * different threads are serialized.
+     */
+    class CDeepracerThreadPool {
+    public:
+
+        typedef std::function<void(UInt32)> TTask;
+
+    public:
+
+        /**
+         * @param un_threads total threads working on a loop, the caller included.
+         */
+        explicit CDeepracerThreadPool(UInt32 un_threads);
+
+        ~CDeepracerThreadPool();
+
+        /**
+         * Calls c_task(i) for each i in [0, un_count) and returns when all are done.
+         * The tasks must not throw.
+         */
+        void ParallelFor(UInt32 un_count,
+                         const TTask& c_task);
+
+        inline UInt32 GetNumThreads() const {
+            return m_vecWorkers.size() + 1;
+        }
+
+        /**
+         * Returns the pool of un_threads threads shared by the plugin, created on
+         * first use. Users asking for the same number of threads share a pool,
+         * and their loops are serialized.
+         */
+        static CDeepracerThreadPool& GetShared(UInt32 un_threads);
+
+    private:
+
+        void Work();
+
+        void RunTasks();
+
+    private:
+
+        std::vector<std::thread> m_vecWorkers;
+        /** Serializes ParallelFor() calls */
+        std::mutex               m_cCallMutex;
+        std::mutex               m_cMutex;
+        std::condition_variable  m_cWakeUp;
+        std::condition_variable  m_cDone;
+        const TTask*             m_pcTask;
+        UInt32                   m_unCount;
+        std::atomic<UInt32>      m_unNext;
+        UInt32                   m_unBusyWorkers;
+        UInt64                   m_unGeneration;
+        bool                     m_bStop;
+    };
+
+}
+
+#endif
@@ -0,0 +1,226 @@
+#include "deepracer_track.h"
+
+#include <argos3/core/utility/configuration/argos_exception.h>
+#include <argos3/core/utility/string_utilities.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    /* Values per waypoint: center, inner and outer (x,y) */
+    static const size_t WAYPOINT_SIZE = 6;
+
+    /* Distance under which the last waypoint is considered a repetition of the first one */
+    static const Real CLOSED_LOOP_TOLERANCE = 1e-6;
+
+    /****************************************/
+    /****************************************/
+
+    static Real SegmentPointDistance(const CVector2& c_start,
+                                     const CVector2& c_end,
+                                     const CVector2& c_point) {
+        CVector2 cSeg = c_end - c_start;
+        Real fLength2 = cSeg.SquareLength();
+        if (fLength2 == 0.0) return (c_point - c_start).Length();
+        Real fT = (c_point - c_start).DotProduct(cSeg) / fLength2;
+        fT = Min(Max(fT, 0.0), 1.0);
+        return (c_point - (c_start + cSeg * fT)).Length();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerTrack::CDeepracerTrack() :
+        m_bClosed(false) {}
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrack::Load(const std::string& str_file_name,
+                               Real f_scale) {
+        try {
+            std::vector<Real> vecValues;
+            std::string strExt = str_file_name.substr(str_file_name.find_last_of('.') + 1);
+            if (strExt == "npy") {
+                LoadNPY(str_file_name, vecValues);
+            } else {
+                LoadText(str_file_name, vecValues);
+            }
+            if (vecValues.size() < 2 * WAYPOINT_SIZE) {
+                THROW_ARGOSEXCEPTION("A track needs at least two waypoints");
+            }
+            m_tCenterLine.clear();
+            m_tInnerBorder.clear();
+            m_tOuterBorder.clear();
+            for (size_t i = 0; i < vecValues.size(); i += WAYPOINT_SIZE) {
+                m_tCenterLine.push_back(CVector2(vecValues[i],     vecValues[i + 1]) * f_scale);
+                m_tInnerBorder.push_back(CVector2(vecValues[i + 2], vecValues[i + 3]) * f_scale);
+                m_tOuterBorder.push_back(CVector2(vecValues[i + 4], vecValues[i + 5]) * f_scale);
+            }
+            /* AWS tracks repeat the first waypoint at the end when they are loops */
+            m_bClosed = (m_tCenterLine.front() - m_tCenterLine.back()).Length() < CLOSED_LOOP_TOLERANCE * f_scale;
+            if (m_bClosed) {
+                m_tCenterLine.pop_back();
+                m_tInnerBorder.pop_back();
+                m_tOuterBorder.pop_back();
+            }
+        } catch (CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("Error loading DeepRacer track \"" << str_file_name << "\"", ex);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrack::LoadNPY(const std::string& str_file_name,
+                                  std::vector<Real>& vec_values) {
+        std::ifstream cFile(str_file_name.c_str(), std::ios::binary);
+        if (!cFile) {
+            THROW_ARGOSEXCEPTION("Can't open file");
+        }
+        /* Magic string and version */
+        char pchMagic[8];
+        cFile.read(pchMagic, 8);
+        if (!cFile || ::memcmp(pchMagic, "\x93NUMPY", 6) != 0) {
+            THROW_ARGOSEXCEPTION("Not a NumPy array file");
+        }
+        UInt32 unHeaderLength = 0;
+        UInt8 punLength[4] = {0, 0, 0, 0};
+        cFile.read(reinterpret_cast<char*>(punLength), pchMagic[6] == 1 ? 2 : 4);
+        unHeaderLength = punLength[0] | (punLength[1] << 8) | (punLength[2] << 16) | (punLength[3] << 24);
+        std::string strHeader(unHeaderLength, ' ');
+        cFile.read(&strHeader[0], unHeaderLength);
+        if (!cFile) {
+            THROW_ARGOSEXCEPTION("Truncated NumPy header");
+        }
+        /* Data type: little-endian doubles or floats */
+        size_t unPos = strHeader.find("'descr'");
+        if (unPos == std::string::npos) {
+            THROW_ARGOSEXCEPTION("Missing data type in NumPy header");
+        }
+        unPos = strHeader.find('\'', unPos + 7);
+        std::string strDescr = strHeader.substr(unPos + 1, strHeader.find('\'', unPos + 1) - unPos - 1);
+        size_t unItemSize;
+        if (strDescr == "<f8") {
+            unItemSize = 8;
+        } else if (strDescr == "<f4") {
+            unItemSize = 4;
+        } else {
+            THROW_ARGOSEXCEPTION("Unsupported NumPy data type \"" << strDescr << "\", expected \"<f8\" or \"<f4\"");
+        }
+        bool bFortranOrder = strHeader.find("'fortran_order': True") != std::string::npos;
+        /* Shape: (N, 6) */
+        unPos = strHeader.find("'shape'");
+        if (unPos == std::string::npos) {
+            THROW_ARGOSEXCEPTION("Missing shape in NumPy header");
+        }
+        size_t unOpen  = strHeader.find('(', unPos);
+        size_t unClose = strHeader.find(')', unPos);
+        std::vector<std::string> vecDims;
+        Tokenize(strHeader.substr(unOpen + 1, unClose - unOpen - 1), vecDims, ", ");
+        if (vecDims.size() != 2 || ::atol(vecDims[1].c_str()) != static_cast<long>(WAYPOINT_SIZE)) {
+            THROW_ARGOSEXCEPTION("Expected an array of shape (N," << WAYPOINT_SIZE << ")");
+        }
+        size_t unRows = ::atol(vecDims[0].c_str());
+        /* Data */
+        std::vector<char> vecRaw(unRows * WAYPOINT_SIZE * unItemSize);
+        cFile.read(vecRaw.data(), vecRaw.size());
+        if (!cFile) {
+            THROW_ARGOSEXCEPTION("Truncated NumPy data");
+        }
+        vec_values.resize(unRows * WAYPOINT_SIZE);
+        for (size_t r = 0; r < unRows; ++r) {
+            for (size_t c = 0; c < WAYPOINT_SIZE; ++c) {
+                size_t unSrc = bFortranOrder ? (c * unRows + r) : (r * WAYPOINT_SIZE + c);
+                if (unItemSize == 8) {
+                    double fValue;
+                    ::memcpy(&fValue, &vecRaw[unSrc * 8], 8);
+                    vec_values[r * WAYPOINT_SIZE + c] = fValue;
+                } else {
+                    float fValue;
+                    ::memcpy(&fValue, &vecRaw[unSrc * 4], 4);
+                    vec_values[r * WAYPOINT_SIZE + c] = fValue;
+                }
+            }
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrack::LoadText(const std::string& str_file_name,
+                                   std::vector<Real>& vec_values) {
+        std::ifstream cFile(str_file_name.c_str());
+        if (!cFile) {
+            THROW_ARGOSEXCEPTION("Can't open file");
+        }
+        std::string strLine;
+        UInt32 unLine = 0;
+        while (std::getline(cFile, strLine)) {
+            ++unLine;
+            /* Strip comments */
+            strLine = strLine.substr(0, strLine.find('#'));
+            std::vector<std::string> vecTokens;
+            Tokenize(strLine, vecTokens, ", \t\r");
+            if (vecTokens.empty()) continue;
+            if (vecTokens.size() != WAYPOINT_SIZE) {
+                THROW_ARGOSEXCEPTION("Line " << unLine << ": expected " << WAYPOINT_SIZE << " values, found " << vecTokens.size());
+            }
+            for (size_t i = 0; i < WAYPOINT_SIZE; ++i) {
+                vec_values.push_back(FromString<Real>(vecTokens[i]));
+            }
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrack::BuildWalls(std::vector<CDeepracerSegmentBVH::SSegment>& vec_segments,
+                                     Real f_merge_tolerance) const {
+        vec_segments.clear();
+        AddBorderWalls(m_tInnerBorder, vec_segments, f_merge_tolerance);
+        AddBorderWalls(m_tOuterBorder, vec_segments, f_merge_tolerance);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrack::AddBorderWalls(const TWaypoints& t_border,
+                                         std::vector<CDeepracerSegmentBVH::SSegment>& vec_segments,
+                                         Real f_merge_tolerance) const {
+        /* Loops go back to the first point */
+        size_t unLast = m_bClosed ? t_border.size() : t_border.size() - 1;
+        auto BorderPoint = [&t_border](size_t un_idx) -> const CVector2& {
+            return t_border[un_idx % t_border.size()];
+        };
+        size_t i = 0;
+        while (i < unLast) {
+            /* Extend the segment as long as the skipped points stay close to it */
+            size_t j = i + 1;
+            while (j < unLast) {
+                bool bMergeable = true;
+                for (size_t k = i + 1; k <= j && bMergeable; ++k) {
+                    bMergeable = SegmentPointDistance(BorderPoint(i), BorderPoint(j + 1), BorderPoint(k)) <= f_merge_tolerance;
+                }
+                if (!bMergeable) break;
+                ++j;
+            }
+            if (!(BorderPoint(i) == BorderPoint(j))) {
+                CDeepracerSegmentBVH::SSegment sSegment;
+                sSegment.Start = BorderPoint(i);
+                sSegment.End   = BorderPoint(j);
+                vec_segments.push_back(sSegment);
+            }
+            i = j;
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
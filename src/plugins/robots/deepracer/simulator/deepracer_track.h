@@ -0,0 +1,94 @@
+#ifndef DEEPRACER_TRACK_H
+#define DEEPRACER_TRACK_H
+
+namespace argos {
+    class CDeepracerTrack;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/math/vector2.h>
+
+#include <string>
+#include <vector>
+
+#include "deepracer_segment_bvh.h"
+
+namespace argos {
+
+    /**
+     * A track in the AWS DeepRacer waypoint format.
+     *
+     * Each waypoint is a row of six values: the center line, the inner
+     * border and the outer border, each as an (x,y) pair in meters. Tracks
+     * are distributed as NumPy arrays of shape (N,6); a text file with six
+     * values per line (comma or space separated, '#' for comments) is also
+     * accepted. When the last waypoint repeats the first one, the track is
+     * a closed loop and the duplicate is dropped.
+     */
+    class CDeepracerTrack {
+    public:
+
+        typedef std::vector<CVector2> TWaypoints;
+
+    public:
+
+        CDeepracerTrack();
+
+        /**
+         * Loads the waypoints from the given file, scaling them by f_scale.
+         * @throws CARGoSException if the file can't be read or parsed.
+         */
+        void Load(const std::string& str_file_name,
+                  Real f_scale = 1.0);
+
+        /**
+         * Generates the walls along the inner and outer borders.
+         * Consecutive border points are merged into a single segment as long
+         * as none of them lies farther than f_merge_tolerance from it.
+         */
+        void BuildWalls(std::vector<CDeepracerSegmentBVH::SSegment>& vec_segments,
+                        Real f_merge_tolerance) const;
+
+        inline const TWaypoints& GetCenterLine() const {
+            return m_tCenterLine;
+        }
+
+        inline const TWaypoints& GetInnerBorder() const {
+            return m_tInnerBorder;
+        }
+
+        inline const TWaypoints& GetOuterBorder() const {
+            return m_tOuterBorder;
+        }
+
+        inline size_t GetNumWaypoints() const {
+            return m_tCenterLine.size();
+        }
+
+        inline bool IsClosed() const {
+            return m_bClosed;
+        }
+
+    private:
+
+        void LoadNPY(const std::string& str_file_name,
+                     std::vector<Real>& vec_values);
+
+        void LoadText(const std::string& str_file_name,
+                      std::vector<Real>& vec_values);
+
+        void AddBorderWalls(const TWaypoints& t_border,
+                            std::vector<CDeepracerSegmentBVH::SSegment>& vec_segments,
+                            Real f_merge_tolerance) const;
+
+    private:
+
+        TWaypoints m_tCenterLine;
+        TWaypoints m_tInnerBorder;
+        TWaypoints m_tOuterBorder;
+        bool       m_bClosed;
+    };
+
+}
+
+#endif
@@ -0,0 +1,154 @@
+#include "deepracer_track_default_sensor.h"
+
+#include <argos3/core/simulator/entity/embodied_entity.h>
+
+#include "deepracer_entity.h"
+#include "deepracer_track_entity.h"
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerTrackDefaultSensor::CDeepracerTrackDefaultSensor() :
+        m_pcDeepracerEntity(NULL),
+        m_pcTrack(NULL),
+        m_unSegment(CDeepracerCenterlineIndex::NO_HINT) {}
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackDefaultSensor::SetRobot(CComposableEntity& c_entity) {
+        m_pcDeepracerEntity = dynamic_cast<CDeepracerEntity*>(&c_entity);
+        if (m_pcDeepracerEntity == NULL) {
+            THROW_ARGOSEXCEPTION("The DeepRacer track sensor can be associated only to a DeepRacer, not to entity \"" << c_entity.GetId() << "\"");
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackDefaultSensor::Init(TConfigurationNode& t_tree) {
+        try {
+            CCI_DeepracerTrackSensor::Init(t_tree);
+            GetNodeAttributeOrDefault(t_tree, "track", m_strTrackId, m_strTrackId);
+            UInt32 unLookahead = 5;
+            GetNodeAttributeOrDefault(t_tree, "lookahead_samples", unLookahead, unLookahead);
+            m_fLookaheadSpacing = 0.5;
+            GetNodeAttributeOrDefault(t_tree, "lookahead_spacing", m_fLookaheadSpacing, m_fLookaheadSpacing);
+            if (m_fLookaheadSpacing <= 0.0) {
+                THROW_ARGOSEXCEPTION("The lookahead spacing must be positive");
+            }
+            m_sReading.Curvatures.assign(unLookahead, 0.0);
+        } catch (CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("Initialization error in default DeepRacer track sensor", ex);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackDefaultSensor::Update() {
+        if (m_pcTrack == NULL) {
+            m_pcTrack = &CDeepracerTrackEntity::Find(m_strTrackId);
+        }
+        const CDeepracerCenterlineIndex& cCenterline = m_pcTrack->GetCenterline();
+        /* Pose in the frame of the track */
+        const SAnchor& sTrack = m_pcTrack->GetEmbodiedEntity().GetOriginAnchor();
+        const SAnchor& sOrigin = m_pcDeepracerEntity->GetEmbodiedEntity().GetOriginAnchor();
+        CQuaternion cInvTrack = sTrack.Orientation.Inverse();
+        CVector3 cPosition(sOrigin.Position - sTrack.Position);
+        cPosition.Rotate(cInvTrack);
+        CRadians cZAngle, cYAngle, cXAngle;
+        (cInvTrack * sOrigin.Orientation).ToEulerAngles(cZAngle, cYAngle, cXAngle);
+        /* Closest point on the center line, starting from the last one */
+        CDeepracerCenterlineIndex::SProjection sProjection;
+        cCenterline.Project(CVector2(cPosition.GetX(), cPosition.GetY()), m_unSegment, sProjection);
+        m_unSegment = sProjection.Segment;
+        const CVector2& cDirection = cCenterline.GetSegments()[sProjection.Segment].Direction;
+        m_sReading.LateralOffset = sProjection.IsLeft ? sProjection.Distance : -sProjection.Distance;
+        m_sReading.HeadingError  = (cZAngle - ATan2(cDirection.GetY(), cDirection.GetX())).SignedNormalize();
+        m_sReading.ArcLength     = sProjection.ArcLength;
+        m_sReading.TrackWidth    = sProjection.TrackWidth;
+        for (size_t i = 0; i < m_sReading.Curvatures.size(); ++i) {
+            m_sReading.Curvatures[i] = cCenterline.GetCurvature(sProjection.ArcLength + (i + 1) * m_fLookaheadSpacing);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackDefaultSensor::Reset() {
+        m_unSegment = CDeepracerCenterlineIndex::NO_HINT;
+        m_sReading.LateralOffset = 0.0;
+        m_sReading.HeadingError  = CRadians::ZERO;
+        m_sReading.ArcLength     = 0.0;
+        m_sReading.TrackWidth    = 0.0;
+        m_sReading.Curvatures.assign(m_sReading.Curvatures.size(), 0.0);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    REGISTER_SENSOR(CDeepracerTrackDefaultSensor,
+                    "deepracer_track", "default",
+                    "Khai Yi Chin [khaiyichin@gmail.com]",
+                    "1.0",
+                    "The position of the AWS DeepRacer relative to the track.",
+
+                    "This sensor returns the position of the robot relative to the center line\n"
+                    "of a deepracer_track: the signed lateral offset (positive on the left), the\n"
+                    "heading error with respect to the direction of the center line, the arc\n"
+                    "length from the first waypoint and the track width at the robot. It also\n"
+                    "returns the curvature of the center line at regular distances ahead of the\n"
+                    "robot. The center line and its curvature are indexed once by the track, so\n"
+                    "the readings cost a few distance computations, against hundreds of rays for\n"
+                    "the LIDAR: simple policies can drive with this sensor alone. The real robot\n"
+                    "has no such sensor. In controllers, you must include the\n"
+                    "ci_deepracer_track_sensor.h header.\n\n"
+
+                    "REQUIRED XML CONFIGURATION\n\n"
+                    "  <controllers>\n"
+                    "    ...\n"
+                    "    <my_controller ...>\n"
+                    "      ...\n"
+                    "      <sensors>\n"
+                    "        ...\n"
+                    "        <deepracer_track implementation=\"default\" />\n"
+                    "        ...\n"
+                    "      </sensors>\n"
+                    "      ...\n"
+                    "    </my_controller>\n"
+                    "    ...\n"
+                    "  </controllers>\n\n"
+
+                    "The arena must contain exactly one deepracer_track, unless the 'track'\n"
+                    "attribute below is set.\n\n"
+
+                    "OPTIONAL XML CONFIGURATION\n\n"
+
+                    "  <controllers>\n"
+                    "    ...\n"
+                    "    <my_controller ...>\n"
+                    "      ...\n"
+                    "      <sensors>\n"
+                    "        ...\n"
+                    "        <deepracer_track implementation=\"default\"\n"
+                    "                         track=\"reinvent\"\n"
+                    "                         lookahead_samples=\"5\"\n"
+                    "                         lookahead_spacing=\"0.5\" />\n"
+                    "        ...\n"
+                    "      </sensors>\n"
+                    "      ...\n"
+                    "    </my_controller>\n"
+                    "    ...\n"
+                    "  </controllers>\n\n"
+
+                    "The 'track' attribute is the id of the track to follow.\n"
+                    "The 'lookahead_samples' attribute is the number of curvature samples\n"
+                    "(default 5); sample i is taken (i+1) times 'lookahead_spacing' meters ahead\n"
+                    "along the center line (default 0.5).\n",
+
+                    "Usable");
+
+}
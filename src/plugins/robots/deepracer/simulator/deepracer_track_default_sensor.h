@@ -0,0 +1,46 @@
+#ifndef DEEPRACER_TRACK_DEFAULT_SENSOR_H
+#define DEEPRACER_TRACK_DEFAULT_SENSOR_H
+
+#include <string>
+
+namespace argos {
+    class CDeepracerTrackDefaultSensor;
+    class CDeepracerEntity;
+    class CDeepracerTrackEntity;
+}
+
+#include <argos3/core/simulator/sensor.h>
+#include <argos3/plugins/robots/deepracer/control_interface/ci_deepracer_track_sensor.h>
+
+namespace argos {
+
+    class CDeepracerTrackDefaultSensor : public CSimulatedSensor,
+                                         public CCI_DeepracerTrackSensor {
+    public:
+
+        CDeepracerTrackDefaultSensor();
+
+        virtual ~CDeepracerTrackDefaultSensor() {}
+
+        virtual void SetRobot(CComposableEntity& c_entity);
+
+        virtual void Init(TConfigurationNode& t_tree);
+
+        virtual void Update();
+
+        virtual void Reset();
+
+    protected:
+
+        /** Reference to the DeepRacer entity associated to this sensor */
+        CDeepracerEntity*      m_pcDeepracerEntity;
+        /** The track, found at the first update since it may come after the robot in the arena */
+        CDeepracerTrackEntity* m_pcTrack;
+        std::string            m_strTrackId;
+        /** Center line segment of the last update, the start of the next lookup */
+        UInt32                 m_unSegment;
+    };
+
+}
+
+#endif
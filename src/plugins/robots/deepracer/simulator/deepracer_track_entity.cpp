@@ -0,0 +1,242 @@
+#include "deepracer_track_entity.h"
+
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/core/utility/string_utilities.h>
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    /* Version of the cached walls and center line, to change when the way they are built changes */
+    static const UInt32 TRACK_ASSET_VERSION = 1;
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerTrackEntity::CDeepracerTrackEntity()
+        : CComposableEntity(NULL),
+          m_pcEmbodiedEntity(NULL),
+          m_fWallHeight(0.1),
+          m_fWallThickness(0.02) {
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackEntity::Init(TConfigurationNode& t_tree) {
+        try {
+            /*
+             * Init parent
+             */
+            CComposableEntity::Init(t_tree);
+            /*
+             * Parse the track
+             */
+            std::string strFile;
+            GetNodeAttribute(t_tree, "file", strFile);
+            ExpandEnvVariables(strFile);
+            Real fScale = 1.0;
+            GetNodeAttributeOrDefault(t_tree, "scale", fScale, fScale);
+            GetNodeAttributeOrDefault(t_tree, "wall_height", m_fWallHeight, m_fWallHeight);
+            GetNodeAttributeOrDefault(t_tree, "wall_thickness", m_fWallThickness, m_fWallThickness);
+            Real fMergeTolerance = 0.005;
+            GetNodeAttributeOrDefault(t_tree, "merge_tolerance", fMergeTolerance, fMergeTolerance);
+            std::string strCache = CDeepracerAssetCache::GetDefaultDirectory();
+            GetNodeAttributeOrDefault(t_tree, "cache", strCache, strCache);
+            ExpandEnvVariables(strCache);
+            if (fScale <= 0.0 || m_fWallHeight <= 0.0 || m_fWallThickness < 0.0 || fMergeTolerance < 0.0) {
+                THROW_ARGOSEXCEPTION("The scale and the wall height must be positive, the wall thickness and the merge tolerance non-negative");
+            }
+            m_cTrack.Load(strFile, fScale);
+            BuildStructures(fMergeTolerance, strCache);
+            LOG << "[INFO] Track \"" << GetId() << "\": "
+                << m_cTrack.GetNumWaypoints() << " waypoints, "
+                << (m_cTrack.IsClosed() ? "closed" : "open") << ", "
+                << m_cWalls.GetSegments().size() << " wall segments, "
+                << m_cCenterline.GetLength() << " m long"
+                << std::endl;
+            /*
+             * Create and init components
+             */
+            /* Embodied entity: the track never moves */
+            m_pcEmbodiedEntity = new CEmbodiedEntity(this);
+            AddComponent(*m_pcEmbodiedEntity);
+            m_pcEmbodiedEntity->Init(GetNode(t_tree, "body"));
+            m_pcEmbodiedEntity->SetMovable(false);
+            /* Update components */
+            UpdateComponents();
+        } catch (CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("Failed to initialize entity \"" << GetId() << "\".", ex);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackEntity::BuildStructures(Real f_merge_tolerance,
+                                                const std::string& str_cache) {
+        /* The key covers everything the structures are derived from */
+        CDeepracerAssetKey cKey("track");
+        cKey.AddValue(TRACK_ASSET_VERSION);
+        const CDeepracerTrack::TWaypoints* ptBorders[3] = {
+            &m_cTrack.GetCenterLine(), &m_cTrack.GetInnerBorder(), &m_cTrack.GetOuterBorder()
+        };
+        for (UInt32 i = 0; i < 3; ++i) {
+            cKey.AddValue<UInt64>(ptBorders[i]->size());
+            cKey.Add(ptBorders[i]->data(), ptBorders[i]->size() * sizeof(CVector2));
+        }
+        cKey.AddValue<UInt32>(m_cTrack.IsClosed());
+        cKey.AddValue(f_merge_tolerance);
+        cKey.AddValue(m_fWallThickness);
+        /* Structures built by another process */
+        CDeepracerAssetCache cCache(str_cache);
+        std::shared_ptr<const CDeepracerAsset> pcAsset = cCache.Find(cKey);
+        if (pcAsset &&
+            m_cWalls.Load(*pcAsset, "walls") &&
+            m_cCenterline.Load(*pcAsset, "centerline")) {
+            LOG << "[INFO] Track \"" << GetId() << "\": mapped from the asset cache" << std::endl;
+            return;
+        }
+        /* Compile the walls */
+        std::vector<CDeepracerSegmentBVH::SSegment> vecSegments;
+        m_cTrack.BuildWalls(vecSegments, f_merge_tolerance);
+        m_cWalls.Build(vecSegments, m_fWallThickness * 0.5);
+        m_cCenterline.Build(m_cTrack);
+        if (cCache.IsEnabled()) {
+            CDeepracerAssetBuilder cBuilder;
+            m_cWalls.Save(cBuilder, "walls");
+            m_cCenterline.Save(cBuilder, "centerline");
+            /* Switch to the stored copy, whose pages are shared with the other processes */
+            pcAsset = cCache.Store(cKey, cBuilder);
+            if (pcAsset) {
+                m_cWalls.Load(*pcAsset, "walls");
+                m_cCenterline.Load(*pcAsset, "centerline");
+            }
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackEntity::Reset() {
+        CComposableEntity::Reset();
+        UpdateComponents();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    bool CDeepracerTrackEntity::IntersectRay(const CRay3& c_ray,
+                                             Real& f_t) const {
+        /* Bring the ray in the frame of the body */
+        const SAnchor& sOrigin = m_pcEmbodiedEntity->GetOriginAnchor();
+        CQuaternion cInvOrient = sOrigin.Orientation.Inverse();
+        CVector3 cStart = c_ray.GetStart() - sOrigin.Position;
+        cStart.Rotate(cInvOrient);
+        CVector3 cEnd = c_ray.GetEnd() - sOrigin.Position;
+        cEnd.Rotate(cInvOrient);
+        /* Closest hit on the plane, discarded if the ray passes above or below the walls there */
+        Real fT;
+        if (!m_cWalls.IntersectRay(CVector2(cStart.GetX(), cStart.GetY()),
+                                   CVector2(cEnd.GetX(), cEnd.GetY()),
+                                   fT)) {
+            return false;
+        }
+        Real fZ = cStart.GetZ() + fT * (cEnd.GetZ() - cStart.GetZ());
+        if (fZ < 0.0 || fZ > m_fWallHeight) {
+            return false;
+        }
+        f_t = fT;
+        return true;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerTrackEntity& CDeepracerTrackEntity::Find(const std::string& str_id) {
+        CSpace::TMapPerTypePerId& tEntities = CSimulator::GetInstance().GetSpace().GetEntityMapPerTypePerId();
+        CSpace::TMapPerTypePerId::iterator itTracks = tEntities.find("deepracer_track");
+        size_t unTracks = (itTracks != tEntities.end()) ? itTracks->second.size() : 0;
+        if (str_id.empty()) {
+            if (unTracks != 1) {
+                THROW_ARGOSEXCEPTION("The arena has " << unTracks << " DeepRacer tracks, the id of the track to use is needed");
+            }
+            return *any_cast<CDeepracerTrackEntity*>(itTracks->second.begin()->second);
+        }
+        CSpace::TMapPerType::iterator itTrack;
+        if (unTracks == 0 || (itTrack = itTracks->second.find(str_id)) == itTracks->second.end()) {
+            THROW_ARGOSEXCEPTION("No DeepRacer track with id \"" << str_id << "\"");
+        }
+        return *any_cast<CDeepracerTrackEntity*>(itTrack->second);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    REGISTER_ENTITY(CDeepracerTrackEntity,
+                    "deepracer_track",
+                    "Khai Yi Chin [khaiyichin@gmail.com]",
+                    "1.0",
+                    "A race track built from an AWS DeepRacer waypoint file.",
+                    "The track is a single static entity whose walls follow the inner and outer\n"
+                    "borders of an AWS DeepRacer track. Building the walls out of a waypoint file\n"
+                    "is much faster to load and to query than placing one box per wall piece:\n"
+                    "consecutive border points that are nearly aligned are merged into a single\n"
+                    "segment, and the segments are indexed by a static bounding-volume hierarchy\n"
+                    "that serves both the dynamics2d collision shapes and the LIDAR rays.\n\n"
+                    "REQUIRED XML CONFIGURATION\n\n"
+                    "  <arena ...>\n"
+                    "    ...\n"
+                    "    <deepracer_track id=\"track\" file=\"reinvent_base.npy\">\n"
+                    "      <body position=\"0,0,0\" orientation=\"0,0,0\" />\n"
+                    "    </deepracer_track>\n"
+                    "    ...\n"
+                    "  </arena>\n\n"
+                    "The 'id' attribute is necessary and must be unique among the entities. If two\n"
+                    "entities share the same id, initialization aborts.\n"
+                    "The 'file' attribute is the path to the waypoint file. The file is either a\n"
+                    "NumPy array of shape (N,6), as distributed with the AWS DeepRacer tracks, or a\n"
+                    "text file with six values per line, separated by commas or spaces ('#' starts\n"
+                    "a comment). Each waypoint lists the center line, the inner border and the\n"
+                    "outer border as X,Y pairs in meters. When the last waypoint repeats the first\n"
+                    "one, the track is a closed loop.\n"
+                    "The 'body/position' and 'body/orientation' attributes place the origin of the\n"
+                    "waypoint coordinates in the arena.\n\n"
+                    "OPTIONAL XML CONFIGURATION\n\n"
+                    "  <arena ...>\n"
+                    "    ...\n"
+                    "    <deepracer_track id=\"track\" file=\"reinvent_base.npy\"\n"
+                    "                     scale=\"1\"\n"
+                    "                     wall_height=\"0.1\"\n"
+                    "                     wall_thickness=\"0.02\"\n"
+                    "                     merge_tolerance=\"0.005\"\n"
+                    "                     cache=\"/tmp/argos_deepracer_cache\">\n"
+                    "      <body position=\"0,0,0\" orientation=\"0,0,0\" />\n"
+                    "    </deepracer_track>\n"
+                    "    ...\n"
+                    "  </arena>\n\n"
+                    "The 'scale' attribute multiplies the waypoint coordinates. The 'wall_height'\n"
+                    "and 'wall_thickness' attributes set the size of the walls in meters. The\n"
+                    "'merge_tolerance' attribute is the largest distance, in meters, between a\n"
+                    "border point and the wall segment that replaces it; set it to 0 to keep one\n"
+                    "segment per waypoint.\n"
+                    "The 'cache' attribute is a directory where the walls and the center line index\n"
+                    "are stored once built, in files named after a hash of the waypoints and of the\n"
+                    "parameters. Other ARGoS processes using the same track map these files instead\n"
+                    "of building the structures again, and share their memory. It defaults to the\n"
+                    "ARGOS_DEEPRACER_CACHE environment variable; without either, nothing is cached.\n",
+                    "Under development");
+
+    /****************************************/
+    /****************************************/
+
+    REGISTER_STANDARD_SPACE_OPERATIONS_ON_COMPOSABLE(CDeepracerTrackEntity);
+
+    /****************************************/
+    /****************************************/
+
+}
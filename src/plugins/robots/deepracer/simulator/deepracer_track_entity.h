@@ -0,0 +1,114 @@
+#ifndef DEEPRACER_TRACK_ENTITY_H
+#define DEEPRACER_TRACK_ENTITY_H
+
+namespace argos {
+    class CEmbodiedEntity;
+    class CDeepracerTrackEntity;
+}
+
+#include <argos3/core/simulator/entity/composable_entity.h>
+#include <argos3/core/utility/math/ray3.h>
+
+#include "deepracer_centerline_index.h"
+#include "deepracer_segment_bvh.h"
+#include "deepracer_track.h"
+
+namespace argos {
+
+    /**
+     * A DeepRacer track: the walls along the borders of a waypoint file,
+     * compiled into merged segments and indexed by a static BVH.
+     *
+     * The segments are expressed in the frame of the body, so the track can
+     * be placed anywhere in the arena with the usual position and orientation.
+     */
+    class CDeepracerTrackEntity : public CComposableEntity {
+    public:
+
+        ENABLE_VTABLE();
+
+    public:
+
+        CDeepracerTrackEntity();
+
+        virtual void Init(TConfigurationNode& t_tree);
+
+        virtual void Reset();
+
+        inline CEmbodiedEntity& GetEmbodiedEntity() {
+            return *m_pcEmbodiedEntity;
+        }
+
+        inline const CEmbodiedEntity& GetEmbodiedEntity() const {
+            return *m_pcEmbodiedEntity;
+        }
+
+        inline const CDeepracerTrack& GetTrack() const {
+            return m_cTrack;
+        }
+
+        /**
+         * Returns the walls, in the frame of the body.
+         */
+        inline const CDeepracerSegmentBVH& GetWalls() const {
+            return m_cWalls;
+        }
+
+        /**
+         * Returns the indexed center line, in the frame of the body.
+         */
+        inline const CDeepracerCenterlineIndex& GetCenterline() const {
+            return m_cCenterline;
+        }
+
+        inline Real GetWallHeight() const {
+            return m_fWallHeight;
+        }
+
+        inline Real GetWallThickness() const {
+            return m_fWallThickness;
+        }
+
+        /**
+         * Intersects a ray with the walls.
+         * @param c_ray the ray, in the global frame.
+         * @param f_t on success, the intersection parameter along c_ray.
+         * @return true if the ray hits a wall.
+         */
+        bool IntersectRay(const CRay3& c_ray,
+                          Real& f_t) const;
+
+        virtual std::string GetTypeDescription() const {
+            return "deepracer_track";
+        }
+
+        /**
+         * Finds a track in the space.
+         * @param str_id the id of the track, or empty for the only track of the arena.
+         * @throws CARGoSException if there is no such track, or str_id is empty
+         * and the arena has more than one.
+         */
+        static CDeepracerTrackEntity& Find(const std::string& str_id = "");
+
+    private:
+
+        /**
+         * Builds the walls and the center line index, or maps them from the
+         * asset cache in str_cache, if not empty.
+         */
+        void BuildStructures(Real f_merge_tolerance,
+                             const std::string& str_cache);
+
+    private:
+
+        CEmbodiedEntity*          m_pcEmbodiedEntity;
+        CDeepracerTrack           m_cTrack;
+        CDeepracerSegmentBVH      m_cWalls;
+        CDeepracerCenterlineIndex m_cCenterline;
+        Real                      m_fWallHeight;
+        Real                      m_fWallThickness;
+    };
+
+}
+
+#endif
@@ -0,0 +1,78 @@
+#include "deepracer_track_loop_functions.h"
+
+#include "deepracer_memory_stats.h"
+#include "deepracer_track_entity.h"
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackLoopFunctions::Init(TConfigurationNode& t_tree) {
+        try {
+            std::string strTrack;
+            UInt32 unThreads = 1;
+            if (NodeExists(t_tree, "track")) {
+                TConfigurationNode& tTrack = GetNode(t_tree, "track");
+                GetNodeAttributeOrDefault(tTrack, "id", strTrack, strTrack);
+                GetNodeAttributeOrDefault(tTrack, "threads", unThreads, unThreads);
+            }
+            /* The given track, or the only one */
+            m_cProgress.Init(CDeepracerTrackEntity::Find(strTrack), unThreads);
+        } catch (CARGoSException& ex) {
+            THROW_ARGOSEXCEPTION_NESTED("Error initializing the DeepRacer track loop functions", ex);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackLoopFunctions::Reset() {
+        m_cProgress.Reset();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackLoopFunctions::PostStep() {
+        m_cProgress.Update();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackLoopFunctions::PostExperiment() {
+        CDeepracerMemoryStats::LogExperimentSummary();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackLoopFunctions::GetSweepMetrics(TMetrics& t_metrics) {
+        const std::vector<CDeepracerTrackProgress::SParams>& vecParams = m_cProgress.GetParams();
+        if (vecParams.empty()) return;
+        Real fProgressSum = 0.0;
+        Real fProgressMin = vecParams[0].Progress;
+        UInt32 unOffTrack = 0;
+        UInt32 unCrashed = 0;
+        for (size_t i = 0; i < vecParams.size(); ++i) {
+            fProgressSum += vecParams[i].Progress;
+            fProgressMin = Min(fProgressMin, vecParams[i].Progress);
+            if (vecParams[i].IsOffTrack) ++unOffTrack;
+            if (vecParams[i].IsCrashed) ++unCrashed;
+        }
+        t_metrics.push_back(std::make_pair("progress_mean", fProgressSum / vecParams.size()));
+        t_metrics.push_back(std::make_pair("progress_min", fProgressMin));
+        t_metrics.push_back(std::make_pair("off_track", static_cast<Real>(unOffTrack)));
+        t_metrics.push_back(std::make_pair("crashed", static_cast<Real>(unCrashed)));
+    }
+
+    /****************************************/
+    /****************************************/
+
+    REGISTER_LOOP_FUNCTIONS(CDeepracerTrackLoopFunctions, "deepracer_track_loop_functions");
+
+    /****************************************/
+    /****************************************/
+
+}
@@ -0,0 +1,53 @@
+#ifndef DEEPRACER_TRACK_LOOP_FUNCTIONS_H
+#define DEEPRACER_TRACK_LOOP_FUNCTIONS_H
+
+namespace argos {
+    class CDeepracerTrackLoopFunctions;
+}
+
+#include <argos3/core/simulator/loop_functions.h>
+
+#include "deepracer_sweep_metrics.h"
+#include "deepracer_track_progress.h"
+
+namespace argos {
+
+    /**
+     * Loop functions that compute the reward function parameters of all the
+     * DeepRacers after each step. Experiment-specific loop functions can
+     * derive from this class and read GetTrackProgress() in their PostStep(),
+     * after calling the one of this class.
+     *
+     * In a parameter sweep, the runs report the progress of the robots at
+     * the end of the experiment.
+     */
+    class CDeepracerTrackLoopFunctions : public CLoopFunctions,
+                                         public CDeepracerSweepMetrics {
+    public:
+
+        CDeepracerTrackLoopFunctions() {}
+
+        virtual ~CDeepracerTrackLoopFunctions() {}
+
+        virtual void Init(TConfigurationNode& t_tree);
+
+        virtual void Reset();
+
+        virtual void PostStep();
+
+        virtual void PostExperiment();
+
+        virtual void GetSweepMetrics(TMetrics& t_metrics);
+
+        inline CDeepracerTrackProgress& GetTrackProgress() {
+            return m_cProgress;
+        }
+
+    private:
+
+        CDeepracerTrackProgress m_cProgress;
+    };
+
+}
+
+#endif
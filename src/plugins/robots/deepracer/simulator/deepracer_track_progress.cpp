@@ -0,0 +1,174 @@
+#include "deepracer_track_progress.h"
+
+#include <argos3/core/simulator/entity/embodied_entity.h>
+
+#include <algorithm>
+
+#include "deepracer_entity.h"
+#include "deepracer_measures.h"
+#include "deepracer_thread_pool.h"
+#include "deepracer_track_entity.h"
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerTrackProgress::CDeepracerTrackProgress() :
+        m_pcTrack(NULL),
+        m_unThreads(1) {}
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackProgress::Init(const CDeepracerTrackEntity& c_track,
+                                       UInt32 un_threads) {
+        m_pcTrack   = &c_track;
+        m_unThreads = Max<UInt32>(un_threads, 1);
+        m_vecRobots.clear();
+        m_vecRobotIds.clear();
+        m_vecStates.clear();
+        m_vecParams.clear();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackProgress::Update() {
+        CollectRobots();
+        const SAnchor& sTrack = m_pcTrack->GetEmbodiedEntity().GetOriginAnchor();
+        m_cTrackPosition       = sTrack.Position;
+        m_cTrackInvOrientation = sTrack.Orientation.Inverse();
+        if (m_unThreads > 1) {
+            CDeepracerThreadPool::GetShared(m_unThreads).ParallelFor(
+                m_vecRobots.size(),
+                [this](UInt32 un_index) { UpdateRobot(un_index); });
+        } else {
+            for (UInt32 i = 0; i < m_vecRobots.size(); ++i) {
+                UpdateRobot(i);
+            }
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackProgress::Reset() {
+        for (size_t i = 0; i < m_vecStates.size(); ++i) {
+            m_vecStates[i].Started = false;
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackProgress::ResetRobot(const std::string& str_id) {
+        m_vecStates[FindRobot(str_id)].Started = false;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    const CDeepracerTrackProgress::SParams& CDeepracerTrackProgress::GetParams(const std::string& str_id) const {
+        return m_vecParams[FindRobot(str_id)];
+    }
+
+    /****************************************/
+    /****************************************/
+
+    size_t CDeepracerTrackProgress::FindRobot(const std::string& str_id) const {
+        std::vector<std::string>::const_iterator it =
+            std::lower_bound(m_vecRobotIds.begin(), m_vecRobotIds.end(), str_id);
+        if (it == m_vecRobotIds.end() || *it != str_id) {
+            THROW_ARGOSEXCEPTION("DeepRacer \"" << str_id << "\" is not followed along the track");
+        }
+        return it - m_vecRobotIds.begin();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackProgress::CollectRobots() {
+        std::vector<CDeepracerEntity*> vecRobots = CDeepracerEntity::CollectDeepracers();
+        if (vecRobots == m_vecRobots) return;
+        /* Robots were added or removed: keep the episodes of the others */
+        std::vector<std::string> vecIds(vecRobots.size());
+        std::vector<SState> vecStates(vecRobots.size());
+        for (size_t i = 0; i < vecRobots.size(); ++i) {
+            vecIds[i] = vecRobots[i]->GetId();
+            std::vector<std::string>::const_iterator it =
+                std::lower_bound(m_vecRobotIds.begin(), m_vecRobotIds.end(), vecIds[i]);
+            if (it != m_vecRobotIds.end() && *it == vecIds[i]) {
+                vecStates[i] = m_vecStates[it - m_vecRobotIds.begin()];
+            } else {
+                vecStates[i].Segment = CDeepracerCenterlineIndex::NO_HINT;
+                vecStates[i].Started = false;
+            }
+        }
+        m_vecRobots.swap(vecRobots);
+        m_vecRobotIds.swap(vecIds);
+        m_vecStates.swap(vecStates);
+        m_vecParams.resize(m_vecRobots.size());
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrackProgress::UpdateRobot(UInt32 un_index) {
+        CDeepracerEntity& cRobot = *m_vecRobots[un_index];
+        SState& sState = m_vecStates[un_index];
+        SParams& sParams = m_vecParams[un_index];
+        const CDeepracerCenterlineIndex& cCenterline = m_pcTrack->GetCenterline();
+        /* Pose in the frame of the track */
+        const SAnchor& sOrigin = cRobot.GetEmbodiedEntity().GetOriginAnchor();
+        CVector3 cPosition(sOrigin.Position - m_cTrackPosition);
+        cPosition.Rotate(m_cTrackInvOrientation);
+        CRadians cZAngle, cYAngle, cXAngle;
+        (m_cTrackInvOrientation * sOrigin.Orientation).ToEulerAngles(cZAngle, cYAngle, cXAngle);
+        sParams.Position.Set(cPosition.GetX(), cPosition.GetY());
+        sParams.Heading = ToDegrees(cZAngle).GetValue();
+        /* Closest point on the center line, starting from the last one */
+        CDeepracerCenterlineIndex::SProjection sProjection;
+        cCenterline.Project(sParams.Position, sState.Segment, sProjection);
+        sState.Segment = sProjection.Segment;
+        const CDeepracerCenterlineIndex::SSegment& sSegment = cCenterline.GetSegments()[sProjection.Segment];
+        CRadians cDifference = cZAngle - ATan2(sSegment.Direction.GetY(), sSegment.Direction.GetX());
+        cDifference.SignedNormalize();
+        sParams.HeadingDifference  = ToDegrees(cDifference).GetValue();
+        sParams.DistanceFromCenter = sProjection.Distance;
+        sParams.IsLeftOfCenter     = sProjection.IsLeft;
+        sParams.TrackWidth         = sProjection.TrackWidth;
+        sParams.TrackLength        = cCenterline.GetLength();
+        sParams.ClosestWaypoints[0] = sSegment.Waypoint;
+        sParams.ClosestWaypoints[1] = (sSegment.Waypoint + 1) % cCenterline.GetNumWaypoints();
+        /* Center line covered, unwrapping the arc length when crossing the start of a loop */
+        if (!sState.Started) {
+            sState.Started = true;
+            sState.Covered = 0.0;
+            sState.Steps   = 0;
+        } else {
+            Real fDelta = sProjection.ArcLength - sState.ArcLength;
+            if (cCenterline.IsClosed()) {
+                if (fDelta > 0.5 * cCenterline.GetLength()) fDelta -= cCenterline.GetLength();
+                else if (fDelta < -0.5 * cCenterline.GetLength()) fDelta += cCenterline.GetLength();
+            }
+            sState.Covered += fDelta;
+            ++sState.Steps;
+        }
+        sState.ArcLength = sProjection.ArcLength;
+        sParams.Progress = 100.0 * sState.Covered / cCenterline.GetLength();
+        sParams.Steps    = sState.Steps;
+        /* Driving state */
+        sParams.Speed         = cRobot.GetWheeledEntity().GetWheelVelocities()[0];
+        sParams.SteeringAngle = ToDegrees(CRadians(*cRobot.GetWheeledEntity().GetSteeringAngle())).GetValue();
+        Real fHalfWidth = 0.5 * DEEPRACER_BASE_WIDTH;
+        sParams.AllWheelsOnTrack = sProjection.Distance + fHalfWidth <= 0.5 * sProjection.TrackWidth;
+        sParams.IsOffTrack       = sProjection.Distance - fHalfWidth > 0.5 * sProjection.TrackWidth;
+        sParams.IsReversed       = Abs(sParams.HeadingDifference) > 90.0;
+        sParams.IsCrashed        = cRobot.GetNumActiveContacts() > 0;
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
@@ -0,0 +1,144 @@
+#ifndef DEEPRACER_TRACK_PROGRESS_H
+#define DEEPRACER_TRACK_PROGRESS_H
+
+namespace argos {
+    class CDeepracerEntity;
+    class CDeepracerTrackEntity;
+    class CDeepracerTrackProgress;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+#include <argos3/core/utility/math/quaternion.h>
+#include <argos3/core/utility/math/vector2.h>
+#include <argos3/core/utility/math/vector3.h>
+
+#include <string>
+#include <vector>
+
+namespace argos {
+
+    /**
+     * Follows all the DeepRacers along a track and computes, once per step,
+     * the parameters AWS DeepRacer passes to reward functions.
+     *
+     * Each robot keeps the center line segment found at the previous step
+     * as a hint, so the lookups cost O(1) while the robots stay on the track.
+     * An episode starts at the first Update() after the robot appears or is
+     * reset, and the progress counts the center line covered since then,
+     * across laps.
+     */
+    class CDeepracerTrackProgress {
+    public:
+
+        /**
+         * The reward function parameters of a robot, named as in AWS.
+         */
+        struct SParams {
+            /** Position in the frame of the track */
+            CVector2 Position;
+            /** Yaw in the frame of the track, in degrees */
+            Real     Heading;
+            /** Heading minus the direction of the center line, in degrees in [-180,180] */
+            Real     HeadingDifference;
+            Real     DistanceFromCenter;
+            bool     IsLeftOfCenter;
+            Real     TrackWidth;
+            Real     TrackLength;
+            /** Center line covered since the start of the episode, in percent */
+            Real     Progress;
+            /** Steps since the start of the episode */
+            UInt32   Steps;
+            /** Waypoints before and after the robot */
+            UInt32   ClosestWaypoints[2];
+            /** Throttle speed, in m/s */
+            Real     Speed;
+            /** Steering angle, in degrees */
+            Real     SteeringAngle;
+            bool     AllWheelsOnTrack;
+            bool     IsOffTrack;
+            /** Whether the robot drives against the center line direction */
+            bool     IsReversed;
+            /** Whether the robot is in contact with something */
+            bool     IsCrashed;
+        };
+
+    public:
+
+        CDeepracerTrackProgress();
+
+        /**
+         * Sets the track to follow.
+         * @param un_threads threads sharing the robots in Update().
+         */
+        void Init(const CDeepracerTrackEntity& c_track,
+                  UInt32 un_threads = 1);
+
+        /**
+         * Computes the parameters of all the DeepRacers in the space.
+         */
+        void Update();
+
+        /**
+         * Restarts the episodes of all the robots.
+         */
+        void Reset();
+
+        /**
+         * Restarts the episode of a robot at the next Update().
+         * @throws CARGoSException if there is no such robot.
+         */
+        void ResetRobot(const std::string& str_id);
+
+        /**
+         * Returns the robot ids, sorted, in the order of the parameters.
+         */
+        inline const std::vector<std::string>& GetRobotIds() const {
+            return m_vecRobotIds;
+        }
+
+        inline const std::vector<SParams>& GetParams() const {
+            return m_vecParams;
+        }
+
+        /**
+         * Returns the parameters of a robot.
+         * @throws CARGoSException if there is no such robot.
+         */
+        const SParams& GetParams(const std::string& str_id) const;
+
+    private:
+
+        struct SState {
+            /** Segment of the previous step, or CDeepracerCenterlineIndex::NO_HINT */
+            UInt32 Segment;
+            Real   ArcLength;
+            Real   Covered;
+            UInt32 Steps;
+            bool   Started;
+        };
+
+        /**
+         * Collects the robots when they have changed, keeping the state of those still there.
+         */
+        void CollectRobots();
+
+        void UpdateRobot(UInt32 un_index);
+
+        size_t FindRobot(const std::string& str_id) const;
+
+    private:
+
+        const CDeepracerTrackEntity*   m_pcTrack;
+        UInt32                         m_unThreads;
+        /** Pose of the track, cached at each update */
+        CVector3                       m_cTrackPosition;
+        CQuaternion                    m_cTrackInvOrientation;
+        std::vector<CDeepracerEntity*> m_vecRobots;
+        std::vector<std::string>       m_vecRobotIds;
+        std::vector<SState>            m_vecStates;
+        std::vector<SParams>           m_vecParams;
+    };
+
+}
+
+#endif
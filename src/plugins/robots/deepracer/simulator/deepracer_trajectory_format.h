@@ -0,0 +1,77 @@
+#ifndef DEEPRACER_TRAJECTORY_FORMAT_H
+#define DEEPRACER_TRAJECTORY_FORMAT_H
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+namespace argos {
+
+    /**
+     * The layout of DeepRacer trajectory logs, shared by the writer and the
+     * reader. All values are little-endian.
+     *
+     * A log starts with an SFileHeader, followed by the robot ids as
+     * NUL-terminated strings (IdsSize bytes, padded to 8). Then come the
+     * chunks: an SChunkHeader followed by one column per field, each with the
+     * float32 values of all the robots, robot after robot, NumTicks values
+     * per robot. A complete log ends with the directory of the chunks (one
+     * SChunkEntry each) and an STrailer; a log without them, e.g. after a
+     * crash, can still be read by walking the chunk headers.
+     */
+    namespace DeepracerTrajectory {
+
+        /** The fields recorded at each tick, in the order of the columns */
+        enum EField {
+            FIELD_X = 0,       // position [m]
+            FIELD_Y,
+            FIELD_YAW,         // orientation [rad]
+            FIELD_VX,          // linear velocity [m/s]
+            FIELD_VY,
+            FIELD_YAW_RATE,    // angular velocity [rad/s]
+            FIELD_STEERING,    // commanded steering angle [rad], NaN without actuator
+            FIELD_THROTTLE,    // commanded throttle speed [m/s], NaN without actuator
+            NUM_FIELDS
+        };
+
+        static const char   FILE_MAGIC[8] = { 'D', 'R', 'T', 'R', 'A', 'J', '\0', '\1' };
+        static const UInt32 VERSION       = 1;
+        static const UInt32 CHUNK_MAGIC   = 0x48435244; // "DRCH"
+        static const UInt32 TRAILER_MAGIC = 0x4E455244; // "DREN"
+
+        struct SFileHeader {
+            char   Magic[8];
+            UInt32 Version;
+            UInt32 NumFields;
+            UInt32 NumRobots;
+            /** Bytes of robot ids after the header, padding included */
+            UInt32 IdsSize;
+            /** Length of a tick [s] */
+            double TickLength;
+        };
+
+        struct SChunkHeader {
+            UInt32 Magic;
+            UInt32 FirstTick;
+            UInt32 NumTicks;
+            UInt32 NumRobots;
+            /** Bytes of columns after the header */
+            UInt64 Size;
+        };
+
+        struct SChunkEntry {
+            /** Offset of the chunk header in the file */
+            UInt64 Offset;
+            UInt32 FirstTick;
+            UInt32 NumTicks;
+        };
+
+        struct STrailer {
+            UInt64 DirectoryOffset;
+            UInt32 NumChunks;
+            UInt32 Magic;
+        };
+
+    }
+
+}
+
+#endif
@@ -0,0 +1,226 @@
+#include "deepracer_trajectory_log.h"
+
+#include <argos3/core/control_interface/ci_controller.h>
+#include <argos3/core/simulator/entity/controllable_entity.h>
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/core/simulator/physics_engine/physics_engine.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/plugins/robots/deepracer/control_interface/ci_ackermann_steering_actuator.h>
+
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include "deepracer_entity.h"
+#include "dynamics2d_deepracer_model.h"
+
+namespace argos {
+
+    using namespace DeepracerTrajectory;
+
+    /****************************************/
+    /****************************************/
+
+    /* stdio buffer of the log file */
+    static const size_t FILE_BUFFER_SIZE = 1 << 20;
+
+    /****************************************/
+    /****************************************/
+
+    static CDynamics2DDeepracerModel* GetDeepracerModel(CDeepracerEntity& c_robot) {
+        CEmbodiedEntity& cBody = c_robot.GetEmbodiedEntity();
+        for (size_t i = 0; i < cBody.GetPhysicsModelsNum(); ++i) {
+            CDynamics2DDeepracerModel* pcModel = dynamic_cast<CDynamics2DDeepracerModel*>(&cBody.GetPhysicsModel(i));
+            if (pcModel != NULL) return pcModel;
+        }
+        return NULL;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerTrajectoryLog::CDeepracerTrajectoryLog() :
+        m_unChunkTicks(0),
+        m_pcFile(NULL),
+        m_unOffset(0),
+        m_bFailed(false),
+        m_psCurrent(NULL) {}
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerTrajectoryLog::~CDeepracerTrajectoryLog() {
+        Close();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrajectoryLog::Open(const std::string& str_file_name,
+                                       UInt32 un_chunk_ticks,
+                                       UInt32 un_buffers) {
+        if (IsOpen()) {
+            THROW_ARGOSEXCEPTION("The DeepRacer trajectory log is already open");
+        }
+        if (un_chunk_ticks == 0 || un_buffers < 2) {
+            THROW_ARGOSEXCEPTION("A DeepRacer trajectory log needs at least one tick per chunk and two chunk buffers");
+        }
+        m_strFileName  = str_file_name;
+        m_unChunkTicks = un_chunk_ticks;
+        /* The robots, sorted by id */
+        m_vecRobots.clear();
+        std::string strIds;
+        std::vector<CDeepracerEntity*> vecRobots = CDeepracerEntity::CollectDeepracers();
+        for (size_t i = 0; i < vecRobots.size(); ++i) {
+            CDeepracerEntity& cRobot = *vecRobots[i];
+            SRobot sRobot;
+            sRobot.Entity   = &cRobot;
+            sRobot.Model    = GetDeepracerModel(cRobot);
+            sRobot.Steering = NULL;
+            CCI_Controller::TMapActuators& tActuators = cRobot.GetControllableEntity().GetController().GetAllActuators();
+            CCI_Controller::TMapActuators::iterator itSteering = tActuators.find("ackermann_steering");
+            if (itSteering != tActuators.end()) {
+                sRobot.Steering = dynamic_cast<CCI_AckermannSteeringActuator*>(itSteering->second);
+            }
+            m_vecRobots.push_back(sRobot);
+            strIds += cRobot.GetId();
+            strIds.push_back('\0');
+        }
+        strIds.append((8 - strIds.size() % 8) % 8, '\0');
+        /* File header and robot ids */
+        m_pcFile = std::fopen(m_strFileName.c_str(), "wb");
+        if (m_pcFile == NULL) {
+            THROW_ARGOSEXCEPTION("Can't open \"" << m_strFileName << "\": " << ::strerror(errno));
+        }
+        std::setvbuf(m_pcFile, NULL, _IOFBF, FILE_BUFFER_SIZE);
+        SFileHeader sHeader;
+        ::memset(&sHeader, 0, sizeof(sHeader));
+        ::memcpy(sHeader.Magic, FILE_MAGIC, sizeof(sHeader.Magic));
+        sHeader.Version    = VERSION;
+        sHeader.NumFields  = NUM_FIELDS;
+        sHeader.NumRobots  = m_vecRobots.size();
+        sHeader.IdsSize    = strIds.size();
+        sHeader.TickLength = CPhysicsEngine::GetSimulationClockTick();
+        std::fwrite(&sHeader, sizeof(sHeader), 1, m_pcFile);
+        std::fwrite(strIds.data(), 1, strIds.size(), m_pcFile);
+        m_unOffset = sizeof(sHeader) + strIds.size();
+        m_vecDirectory.clear();
+        m_bFailed = false;
+        /* Chunk buffers, written by one thread to keep the file in order */
+        size_t unValues = NUM_FIELDS * m_vecRobots.size() * m_unChunkTicks;
+        m_cChunks.Start(un_buffers, 1,
+                        [this](SChunk& s_chunk) { WriteChunk(s_chunk); },
+                        [unValues](SChunk& s_chunk) { s_chunk.Values.resize(unValues); });
+        m_psCurrent = m_cChunks.Acquire();
+        m_psCurrent->NumTicks = 0;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrajectoryLog::Record(UInt32 un_tick) {
+        if (m_psCurrent == NULL) return;
+        /* A chunk holds consecutive ticks: start a new one after a reset */
+        if (m_psCurrent->NumTicks > 0 && un_tick != m_psCurrent->FirstTick + m_psCurrent->NumTicks) {
+            Submit();
+        }
+        if (m_psCurrent->NumTicks == 0) m_psCurrent->FirstTick = un_tick;
+        UInt32 unTick = m_psCurrent->NumTicks;
+        for (UInt32 i = 0; i < m_vecRobots.size(); ++i) {
+            const SRobot& sRobot = m_vecRobots[i];
+            const SAnchor& sOrigin = sRobot.Entity->GetEmbodiedEntity().GetOriginAnchor();
+            CRadians cZAngle, cYAngle, cXAngle;
+            sOrigin.Orientation.ToEulerAngles(cZAngle, cYAngle, cXAngle);
+            Value(*m_psCurrent, FIELD_X, i, unTick)   = sOrigin.Position.GetX();
+            Value(*m_psCurrent, FIELD_Y, i, unTick)   = sOrigin.Position.GetY();
+            Value(*m_psCurrent, FIELD_YAW, i, unTick) = cZAngle.GetValue();
+            CDynamics2DDeepracerModel::SMigrationState sBody;
+            ::memset(&sBody, 0, sizeof(sBody));
+            if (sRobot.Model != NULL) sRobot.Model->GetBodyState(sBody);
+            Value(*m_psCurrent, FIELD_VX, i, unTick)       = sBody.BodyLinVel.x;
+            Value(*m_psCurrent, FIELD_VY, i, unTick)       = sBody.BodyLinVel.y;
+            Value(*m_psCurrent, FIELD_YAW_RATE, i, unTick) = sBody.BodyAngVel;
+            Value(*m_psCurrent, FIELD_STEERING, i, unTick) =
+                sRobot.Steering != NULL ? sRobot.Steering->GetSteeringAngle() : std::numeric_limits<float>::quiet_NaN();
+            Value(*m_psCurrent, FIELD_THROTTLE, i, unTick) =
+                sRobot.Steering != NULL ? sRobot.Steering->GetThrottleSpeed() : std::numeric_limits<float>::quiet_NaN();
+        }
+        if (++m_psCurrent->NumTicks == m_unChunkTicks) Submit();
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrajectoryLog::Close() {
+        if (!IsOpen()) return;
+        /* The last chunk is partial */
+        if (m_psCurrent->NumTicks > 0) {
+            m_cChunks.Queue(m_psCurrent);
+        } else {
+            m_cChunks.Release(m_psCurrent);
+        }
+        m_psCurrent = NULL;
+        m_cChunks.Stop();
+        /* Chunk directory and trailer */
+        STrailer sTrailer;
+        sTrailer.DirectoryOffset = m_unOffset;
+        sTrailer.NumChunks       = m_vecDirectory.size();
+        sTrailer.Magic           = TRAILER_MAGIC;
+        std::fwrite(m_vecDirectory.data(), sizeof(SChunkEntry), m_vecDirectory.size(), m_pcFile);
+        std::fwrite(&sTrailer, sizeof(sTrailer), 1, m_pcFile);
+        m_bFailed |= (std::fclose(m_pcFile) != 0);
+        m_pcFile = NULL;
+        if (m_bFailed) {
+            LOGERR << "[WARNING] Error writing the DeepRacer trajectory log \"" << m_strFileName << "\"" << std::endl;
+        } else {
+            LOG << "[INFO] DeepRacer trajectory log \"" << m_strFileName << "\": "
+                << m_vecRobots.size() << " robots, " << m_vecDirectory.size() << " chunks" << std::endl;
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrajectoryLog::Submit() {
+        m_cChunks.Queue(m_psCurrent);
+        /* Waits only if all the buffers are queued */
+        m_psCurrent = m_cChunks.Acquire();
+        m_psCurrent->NumTicks = 0;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrajectoryLog::WriteChunk(const SChunk& s_chunk) {
+        /* After an error the offsets are unknown, later chunks would be unreadable */
+        if (m_bFailed) return;
+        SChunkHeader sHeader;
+        sHeader.Magic     = CHUNK_MAGIC;
+        sHeader.FirstTick = s_chunk.FirstTick;
+        sHeader.NumTicks  = s_chunk.NumTicks;
+        sHeader.NumRobots = m_vecRobots.size();
+        sHeader.Size      = static_cast<UInt64>(NUM_FIELDS) * m_vecRobots.size() * s_chunk.NumTicks * sizeof(float);
+        SChunkEntry sEntry;
+        sEntry.Offset    = m_unOffset;
+        sEntry.FirstTick = s_chunk.FirstTick;
+        sEntry.NumTicks  = s_chunk.NumTicks;
+        bool bOk = std::fwrite(&sHeader, sizeof(sHeader), 1, m_pcFile) == 1;
+        /* The buffer has room for a full chunk: write the used part of each column */
+        for (UInt32 i = 0; i < NUM_FIELDS * m_vecRobots.size(); ++i) {
+            bOk &= std::fwrite(&s_chunk.Values[i * m_unChunkTicks], sizeof(float), s_chunk.NumTicks, m_pcFile) == s_chunk.NumTicks;
+        }
+        /* Readers of a log still being written see whole chunks */
+        bOk &= std::fflush(m_pcFile) == 0;
+        if (!bOk) {
+            m_bFailed = true;
+            return;
+        }
+        m_unOffset += sizeof(sHeader) + sHeader.Size;
+        m_vecDirectory.push_back(sEntry);
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
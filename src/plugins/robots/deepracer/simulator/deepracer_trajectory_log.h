@@ -0,0 +1,111 @@
+#ifndef DEEPRACER_TRAJECTORY_LOG_H
+#define DEEPRACER_TRAJECTORY_LOG_H
+
+namespace argos {
+    class CCI_AckermannSteeringActuator;
+    class CDeepracerEntity;
+    class CDeepracerTrajectoryLog;
+    class CDynamics2DDeepracerModel;
+}
+
+#include <argos3/core/utility/datatypes/datatypes.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "deepracer_buffer_queue.h"
+#include "deepracer_trajectory_format.h"
+
+namespace argos {
+
+    /**
+     * Writes the ground-truth pose, velocity and command of the DeepRacers at
+     * every tick into a columnar log (see deepracer_trajectory_format.h).
+     *
+     * The ticks are gathered in preallocated chunk buffers, laid out as in the
+     * file, and a background thread appends the full chunks; recording only
+     * waits when all the buffers are queued for writing. The log covers the
+     * robots present when it is opened. Read it with CDeepracerTrajectoryReader.
+     */
+    class CDeepracerTrajectoryLog {
+    public:
+
+        CDeepracerTrajectoryLog();
+
+        ~CDeepracerTrajectoryLog();
+
+        /**
+         * Starts a log of the DeepRacers in the space.
+         * @param un_chunk_ticks ticks per chunk.
+         * @param un_buffers chunk buffers, the one being filled included.
+         * @throws CARGoSException if the file can't be written.
+         */
+        void Open(const std::string& str_file_name,
+                  UInt32 un_chunk_ticks,
+                  UInt32 un_buffers = 3);
+
+        /**
+         * Appends the current state of all the robots.
+         */
+        void Record(UInt32 un_tick);
+
+        /**
+         * Writes the last, partial chunk and the chunk directory, and closes the file.
+         */
+        void Close();
+
+        inline bool IsOpen() const {
+            return m_cChunks.IsRunning();
+        }
+
+    private:
+
+        struct SRobot {
+            CDeepracerEntity*              Entity;
+            CDynamics2DDeepracerModel*     Model;
+            CCI_AckermannSteeringActuator* Steering;
+        };
+
+        struct SChunk {
+            /** Values per field and robot, with room for a full chunk of ticks */
+            std::vector<float> Values;
+            UInt32             FirstTick;
+            UInt32             NumTicks;
+        };
+
+    private:
+
+        /**
+         * Hands the chunk being filled to the writer and takes a free one.
+         */
+        void Submit();
+
+        void WriteChunk(const SChunk& s_chunk);
+
+        inline float& Value(SChunk& s_chunk,
+                            UInt32 un_field,
+                            UInt32 un_robot,
+                            UInt32 un_tick) {
+            return s_chunk.Values[(un_field * m_vecRobots.size() + un_robot) * m_unChunkTicks + un_tick];
+        }
+
+    private:
+
+        std::string                                    m_strFileName;
+        UInt32                                         m_unChunkTicks;
+        std::vector<SRobot>                            m_vecRobots;
+        std::FILE*                                     m_pcFile;
+        UInt64                                         m_unOffset;
+        std::vector<DeepracerTrajectory::SChunkEntry>  m_vecDirectory;
+
+        bool                                           m_bFailed;
+
+        /** Chunk buffers and the one being filled */
+        CDeepracerBufferQueue<SChunk>                  m_cChunks;
+        SChunk*                                        m_psCurrent;
+    };
+
+}
+
+#endif
@@ -0,0 +1,49 @@
+#include "deepracer_trajectory_loop_functions.h"
+
+#include <argos3/core/utility/string_utilities.h>
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    bool CDeepracerTrajectoryLoopFunctions::Configure(TConfigurationNode& t_tree) {
+        if (!NodeExists(t_tree, "trajectory")) return false;
+        TConfigurationNode& tTrajectory = GetNode(t_tree, "trajectory");
+        m_strFile = "trajectory.drtraj";
+        m_unChunkTicks = 1000;
+        m_unBuffers = 3;
+        GetNodeAttributeOrDefault(tTrajectory, "file", m_strFile, m_strFile);
+        GetNodeAttributeOrDefault(tTrajectory, "chunk_ticks", m_unChunkTicks, m_unChunkTicks);
+        GetNodeAttributeOrDefault(tTrajectory, "buffers", m_unBuffers, m_unBuffers);
+        ExpandEnvVariables(m_strFile);
+        return true;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrajectoryLoopFunctions::Open(UInt32 un_run) {
+        std::string strFile = m_strFile;
+        if (un_run > 0) {
+            /* Keep the extension, if the name has one */
+            size_t unSlash = strFile.find_last_of('/');
+            size_t unDot = strFile.find_last_of('.');
+            if (unDot == std::string::npos ||
+                (unSlash != std::string::npos && unDot < unSlash)) {
+                unDot = strFile.size();
+            }
+            strFile.insert(unDot, "_run" + ToString(un_run));
+        }
+        m_cRecorder.Open(strFile, m_unChunkTicks, m_unBuffers);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    REGISTER_LOOP_FUNCTIONS(CDeepracerTrajectoryLoopFunctions, "deepracer_trajectory_loop_functions");
+
+    /****************************************/
+    /****************************************/
+
+}
@@ -0,0 +1,48 @@
+#ifndef DEEPRACER_TRAJECTORY_LOOP_FUNCTIONS_H
+#define DEEPRACER_TRAJECTORY_LOOP_FUNCTIONS_H
+
+namespace argos {
+    class CDeepracerTrajectoryLoopFunctions;
+}
+
+#include "deepracer_recording_loop_functions.h"
+#include "deepracer_trajectory_log.h"
+
+namespace argos {
+
+    /**
+     * Loop functions that record the state and commands of all the
+     * DeepRacers after each step into a trajectory log. The runs after a
+     * reset are written to the file name followed by "_run<N>", before the
+     * extension.
+     */
+    class CDeepracerTrajectoryLoopFunctions : public CDeepracerRecordingLoopFunctions<CDeepracerTrajectoryLog> {
+    public:
+
+        CDeepracerTrajectoryLoopFunctions() :
+            CDeepracerRecordingLoopFunctions<CDeepracerTrajectoryLog>("trajectory"),
+            m_unChunkTicks(1000),
+            m_unBuffers(3) {}
+
+        virtual ~CDeepracerTrajectoryLoopFunctions() {}
+
+        inline CDeepracerTrajectoryLog& GetLog() {
+            return m_cRecorder;
+        }
+
+    protected:
+
+        virtual bool Configure(TConfigurationNode& t_tree);
+
+        virtual void Open(UInt32 un_run);
+
+    private:
+
+        std::string m_strFile;
+        UInt32      m_unChunkTicks;
+        UInt32      m_unBuffers;
+    };
+
+}
+
+#endif
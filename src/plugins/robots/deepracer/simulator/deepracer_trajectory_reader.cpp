@@ -0,0 +1,143 @@
+#include "deepracer_trajectory_reader.h"
+
+#include <argos3/core/utility/configuration/argos_exception.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace argos {
+
+    using namespace DeepracerTrajectory;
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerTrajectoryReader::CDeepracerTrajectoryReader(const std::string& str_file_name) :
+        m_pchData(NULL),
+        m_unSize(0),
+        m_fTickLength(0.0),
+        m_bComplete(false) {
+        int nFile = ::open(str_file_name.c_str(), O_RDONLY);
+        if (nFile < 0) {
+            THROW_ARGOSEXCEPTION("Can't open \"" << str_file_name << "\": " << ::strerror(errno));
+        }
+        struct stat sStat;
+        if (::fstat(nFile, &sStat) != 0 || sStat.st_size < static_cast<off_t>(sizeof(SFileHeader))) {
+            ::close(nFile);
+            THROW_ARGOSEXCEPTION("\"" << str_file_name << "\" is too short to be a DeepRacer trajectory log");
+        }
+        m_unSize = sStat.st_size;
+        void* pMap = ::mmap(NULL, m_unSize, PROT_READ, MAP_SHARED, nFile, 0);
+        /* The mapping stays valid without the descriptor */
+        ::close(nFile);
+        if (pMap == MAP_FAILED) {
+            THROW_ARGOSEXCEPTION("Can't map \"" << str_file_name << "\": " << ::strerror(errno));
+        }
+        m_pchData = static_cast<const char*>(pMap);
+        /* Header */
+        SFileHeader sHeader;
+        ::memcpy(&sHeader, m_pchData, sizeof(sHeader));
+        if (::memcmp(sHeader.Magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 ||
+            sHeader.Version != VERSION ||
+            sHeader.NumFields != NUM_FIELDS ||
+            sizeof(sHeader) + sHeader.IdsSize > m_unSize) {
+            ::munmap(const_cast<char*>(m_pchData), m_unSize);
+            THROW_ARGOSEXCEPTION("\"" << str_file_name << "\" is not a version " << VERSION << " DeepRacer trajectory log");
+        }
+        m_fTickLength = sHeader.TickLength;
+        /* Robot ids, each terminated within the id block */
+        const char* pchId = m_pchData + sizeof(sHeader);
+        const char* pchIdsEnd = pchId + sHeader.IdsSize;
+        for (UInt32 i = 0; i < sHeader.NumRobots; ++i) {
+            size_t unLength = ::strnlen(pchId, pchIdsEnd - pchId);
+            if (pchId + unLength >= pchIdsEnd) {
+                ::munmap(const_cast<char*>(m_pchData), m_unSize);
+                THROW_ARGOSEXCEPTION("\"" << str_file_name << "\" has a corrupt robot id table");
+            }
+            m_vecRobotIds.push_back(std::string(pchId, unLength));
+            pchId += unLength + 1;
+        }
+        /* Chunks */
+        size_t unDataStart = sizeof(sHeader) + sHeader.IdsSize;
+        m_bComplete = ReadDirectory(unDataStart);
+        if (!m_bComplete) ScanChunks(unDataStart);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    CDeepracerTrajectoryReader::~CDeepracerTrajectoryReader() {
+        ::munmap(const_cast<char*>(m_pchData), m_unSize);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    UInt32 CDeepracerTrajectoryReader::FindRobot(const std::string& str_id) const {
+        for (UInt32 i = 0; i < m_vecRobotIds.size(); ++i) {
+            if (m_vecRobotIds[i] == str_id) return i;
+        }
+        THROW_ARGOSEXCEPTION("DeepRacer \"" << str_id << "\" is not in the trajectory log");
+    }
+
+    /****************************************/
+    /****************************************/
+
+    bool CDeepracerTrajectoryReader::ReadDirectory(size_t un_data_start) {
+        if (m_unSize < un_data_start + sizeof(STrailer)) return false;
+        STrailer sTrailer;
+        ::memcpy(&sTrailer, m_pchData + m_unSize - sizeof(STrailer), sizeof(sTrailer));
+        if (sTrailer.Magic != TRAILER_MAGIC ||
+            sTrailer.DirectoryOffset + static_cast<UInt64>(sTrailer.NumChunks) * sizeof(SChunkEntry) + sizeof(STrailer) != m_unSize) {
+            return false;
+        }
+        for (UInt32 i = 0; i < sTrailer.NumChunks; ++i) {
+            SChunkEntry sEntry;
+            ::memcpy(&sEntry, m_pchData + sTrailer.DirectoryOffset + i * sizeof(SChunkEntry), sizeof(sEntry));
+            if (!AddChunk(sEntry.Offset)) {
+                m_vecChunks.clear();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDeepracerTrajectoryReader::ScanChunks(size_t un_data_start) {
+        size_t unOffset = un_data_start;
+        while (AddChunk(unOffset)) {
+            unOffset += sizeof(SChunkHeader) + m_vecChunks.back().NumTicks * m_vecRobotIds.size() * NUM_FIELDS * sizeof(float);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    bool CDeepracerTrajectoryReader::AddChunk(size_t un_offset) {
+        if (un_offset + sizeof(SChunkHeader) > m_unSize) return false;
+        SChunkHeader sHeader;
+        ::memcpy(&sHeader, m_pchData + un_offset, sizeof(sHeader));
+        if (sHeader.Magic != CHUNK_MAGIC ||
+            sHeader.NumRobots != m_vecRobotIds.size() ||
+            sHeader.Size != static_cast<UInt64>(sHeader.NumTicks) * sHeader.NumRobots * NUM_FIELDS * sizeof(float) ||
+            un_offset + sizeof(SChunkHeader) + sHeader.Size > m_unSize) {
+            return false;
+        }
+        SChunk sChunk;
+        sChunk.FirstTick = sHeader.FirstTick;
+        sChunk.NumTicks  = sHeader.NumTicks;
+        sChunk.Columns   = reinterpret_cast<const float*>(m_pchData + un_offset + sizeof(SChunkHeader));
+        m_vecChunks.push_back(sChunk);
+        return true;
+    }
+
+    /****************************************/
+    /****************************************/
+
+}
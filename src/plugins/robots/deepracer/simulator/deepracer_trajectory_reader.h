@@ -0,0 +1,175 @@
+#ifndef DEEPRACER_TRAJECTORY_READER_H
+#define DEEPRACER_TRAJECTORY_READER_H
+
+namespace argos {
+    class CDeepracerTrajectoryReader;
+}
+
+#include <argos3/core/utility/math/general.h>
+
+#include <string>
+#include <vector>
+
+#include "deepracer_trajectory_format.h"
+
+namespace argos {
+
+    /**
+     * Reads a DeepRacer trajectory log by mapping it in memory.
+     *
+     * Opening a log only reads its header and the chunk directory (or walks
+     * the chunk headers of a log that was not closed); the columns are read
+     * by the system as they are accessed, so iterating one robot or a range
+     * of ticks touches only the pages holding those values. The reader does
+     * not depend on the simulator: it is also built as the standalone
+     * argos3deepracer_trajectory_reader library.
+     */
+    class CDeepracerTrajectoryReader {
+    public:
+
+        /** Robot index meaning all the robots */
+        static const UInt32 ALL_ROBOTS = 0xFFFFFFFF;
+
+        struct SChunk {
+            UInt32       FirstTick;
+            UInt32       NumTicks;
+            /** The columns, as described in deepracer_trajectory_format.h */
+            const float* Columns;
+        };
+
+        struct SSample {
+            UInt32 Robot;
+            UInt32 Tick;
+            float  Values[DeepracerTrajectory::NUM_FIELDS];
+        };
+
+    public:
+
+        /**
+         * Maps a log in memory.
+         * @throws CARGoSException if the file can't be mapped or is not a trajectory log.
+         */
+        explicit CDeepracerTrajectoryReader(const std::string& str_file_name);
+
+        ~CDeepracerTrajectoryReader();
+
+        inline UInt32 GetNumRobots() const {
+            return m_vecRobotIds.size();
+        }
+
+        inline const std::vector<std::string>& GetRobotIds() const {
+            return m_vecRobotIds;
+        }
+
+        /**
+         * Returns the index of a robot.
+         * @throws CARGoSException if the robot is not in the log.
+         */
+        UInt32 FindRobot(const std::string& str_id) const;
+
+        /**
+         * Returns the length of a tick in seconds.
+         */
+        inline Real GetTickLength() const {
+            return m_fTickLength;
+        }
+
+        /**
+         * Returns the chunks in file order. Ticks increase within a run, but
+         * start over after a reset of the experiment.
+         */
+        inline const std::vector<SChunk>& GetChunks() const {
+            return m_vecChunks;
+        }
+
+        /**
+         * Returns whether the log was closed properly; if not, the chunks are
+         * those fully written before the writer stopped.
+         */
+        inline bool IsComplete() const {
+            return m_bComplete;
+        }
+
+        /**
+         * Returns the NumTicks values of a field for a robot in a chunk.
+         */
+        inline const float* GetColumn(UInt32 un_chunk,
+                                      DeepracerTrajectory::EField e_field,
+                                      UInt32 un_robot) const {
+            const SChunk& sChunk = m_vecChunks[un_chunk];
+            return sChunk.Columns + (static_cast<size_t>(e_field) * m_vecRobotIds.size() + un_robot) * sChunk.NumTicks;
+        }
+
+        /**
+         * Calls c_visitor(const SSample&) for the samples of a robot (or of
+         * all, with ALL_ROBOTS) whose tick is in [un_first_tick, un_last_tick],
+         * in file order. Chunks outside the range are skipped without reading
+         * their columns.
+         */
+        template <class VISITOR>
+        void ForSamples(UInt32 un_robot,
+                        UInt32 un_first_tick,
+                        UInt32 un_last_tick,
+                        VISITOR& c_visitor) const {
+            UInt32 unFirstRobot = (un_robot == ALL_ROBOTS) ? 0 : un_robot;
+            UInt32 unEndRobot   = (un_robot == ALL_ROBOTS) ? GetNumRobots() : un_robot + 1;
+            SSample sSample;
+            for (UInt32 c = 0; c < m_vecChunks.size(); ++c) {
+                const SChunk& sChunk = m_vecChunks[c];
+                if (sChunk.NumTicks == 0 ||
+                    sChunk.FirstTick > un_last_tick ||
+                    sChunk.FirstTick + sChunk.NumTicks - 1 < un_first_tick) {
+                    continue;
+                }
+                UInt32 unBegin = (un_first_tick > sChunk.FirstTick) ? un_first_tick - sChunk.FirstTick : 0;
+                UInt32 unEnd   = Min<UInt32>(sChunk.NumTicks, un_last_tick - sChunk.FirstTick + 1);
+                for (UInt32 r = unFirstRobot; r < unEndRobot; ++r) {
+                    const float* ppfColumns[DeepracerTrajectory::NUM_FIELDS];
+                    for (UInt32 f = 0; f < DeepracerTrajectory::NUM_FIELDS; ++f) {
+                        ppfColumns[f] = GetColumn(c, static_cast<DeepracerTrajectory::EField>(f), r);
+                    }
+                    sSample.Robot = r;
+                    for (UInt32 t = unBegin; t < unEnd; ++t) {
+                        sSample.Tick = sChunk.FirstTick + t;
+                        for (UInt32 f = 0; f < DeepracerTrajectory::NUM_FIELDS; ++f) {
+                            sSample.Values[f] = ppfColumns[f][t];
+                        }
+                        c_visitor(sSample);
+                    }
+                }
+            }
+        }
+
+    private:
+
+        CDeepracerTrajectoryReader(const CDeepracerTrajectoryReader&);
+        CDeepracerTrajectoryReader& operator=(const CDeepracerTrajectoryReader&);
+
+        /**
+         * Reads the chunk directory at the end of the file, if any.
+         */
+        bool ReadDirectory(size_t un_data_start);
+
+        /**
+         * Walks the chunk headers from the given offset.
+         */
+        void ScanChunks(size_t un_data_start);
+
+        /**
+         * Adds the chunk whose header is at the given offset, if it is valid.
+         */
+        bool AddChunk(size_t un_offset);
+
+    private:
+
+        const char*              m_pchData;
+        size_t                   m_unSize;
+        Real                     m_fTickLength;
+        std::vector<std::string> m_vecRobotIds;
+        std::vector<SChunk>      m_vecChunks;
+        bool                     m_bComplete;
+    };
+
+}
+
+#endif
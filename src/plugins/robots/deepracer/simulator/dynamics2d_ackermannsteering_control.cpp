@@ -1,7 +1,11 @@
 #include "dynamics2d_ackermannsteering_control.h"
 
+#include <argos3/plugins/simulator/physics_engines/dynamics2d/dynamics2d_engine.h>
+
 namespace argos {
 
+    static const Real GRAVITY = 9.81;
+
     CDynamics2DAckermannSteeringControl::CDynamics2DAckermannSteeringControl(CDynamics2DEngine& c_engine,
                                                                              Real f_max_force,
                                                                              Real f_max_torque,
@@ -9,10 +13,60 @@ namespace argos {
                                                                              Real f_wheelbase_distance,
                                                                              TConfigurationNode* t_node)
         : CDynamics2DVelocityControl(c_engine, f_max_force, f_max_torque, t_node),
-          m_fInterwheelDistance(f_interwheel_distance), m_fWheelbaseDistance(f_wheelbase_distance) {}
+          m_fInterwheelDistance(f_interwheel_distance), m_fWheelbaseDistance(f_wheelbase_distance),
+          m_eModel(MODEL_KINEMATIC),
+          m_fFrontCorneringStiffness(40.0),
+          m_fRearCorneringStiffness(40.0),
+          m_fFriction(0.7),
+          m_fThrottleTimeConstant(0.1),
+          m_fKinematicSpeed(0.3),
+          m_fMaxSteeringPerSubstep(0.02),
+          m_unMaxSubsteps(100),
+          m_fPrevSteeringAngle(0.0),
+          m_unLastNumSubsteps(0) {
+        /* Parse the vehicle model, if specified in <dynamics2d><ackermann_steering> */
+        if (t_node != NULL && NodeExists(*t_node, "dynamics2d")) {
+            TConfigurationNode& tDyn2D = GetNode(*t_node, "dynamics2d");
+            if (NodeExists(tDyn2D, "ackermann_steering")) {
+                TConfigurationNode& tSteering = GetNode(tDyn2D, "ackermann_steering");
+                std::string strModel = "kinematic";
+                GetNodeAttributeOrDefault(tSteering, "model", strModel, strModel);
+                if (strModel == "kinematic") {
+                    m_eModel = MODEL_KINEMATIC;
+                } else if (strModel == "dynamic") {
+                    m_eModel = MODEL_DYNAMIC;
+                } else {
+                    THROW_ARGOSEXCEPTION("Unknown Ackermann steering model \"" << strModel << "\", allowed values are \"kinematic\" and \"dynamic\"");
+                }
+                GetNodeAttributeOrDefault(tSteering, "cornering_stiffness_front", m_fFrontCorneringStiffness, m_fFrontCorneringStiffness);
+                GetNodeAttributeOrDefault(tSteering, "cornering_stiffness_rear", m_fRearCorneringStiffness, m_fRearCorneringStiffness);
+                GetNodeAttributeOrDefault(tSteering, "friction", m_fFriction, m_fFriction);
+                GetNodeAttributeOrDefault(tSteering, "throttle_time_constant", m_fThrottleTimeConstant, m_fThrottleTimeConstant);
+                GetNodeAttributeOrDefault(tSteering, "kinematic_speed", m_fKinematicSpeed, m_fKinematicSpeed);
+                GetNodeAttributeOrDefault(tSteering, "max_steering_per_substep", m_fMaxSteeringPerSubstep, m_fMaxSteeringPerSubstep);
+                GetNodeAttributeOrDefault(tSteering, "max_substeps", m_unMaxSubsteps, m_unMaxSubsteps);
+                if (m_fFrontCorneringStiffness <= 0.0 || m_fRearCorneringStiffness <= 0.0 ||
+                    m_fFriction <= 0.0 || m_fThrottleTimeConstant <= 0.0 ||
+                    m_fMaxSteeringPerSubstep <= 0.0 || m_unMaxSubsteps == 0) {
+                    THROW_ARGOSEXCEPTION("The parameters of the dynamic Ackermann steering model must be positive");
+                }
+            }
+        }
+    }
+
+    void CDynamics2DAckermannSteeringControl::Reset() {
+        CDynamics2DVelocityControl::Reset();
+        m_fPrevSteeringAngle = 0.0;
+        m_unLastNumSubsteps  = 0;
+    }
 
     void CDynamics2DAckermannSteeringControl::SetSteeringAndThrottle(Real f_steering_ang,
                                                                      Real f_throttle_speed) {
+        if (m_eModel == MODEL_DYNAMIC) {
+            StepDynamicModel(f_steering_ang, f_throttle_speed);
+            return;
+        }
+
         // Compute the linear and angular velocity of the body
         // https://www.xarg.org/book/kinematics/ackerman-steering/
 
@@ -44,4 +98,113 @@ namespace argos {
         SetLinearVelocity(cLinVel);
     }
 
-}
\ No newline at end of file
+    void CDynamics2DAckermannSteeringControl::StepDynamicModel(Real f_steering_ang,
+                                                               Real f_throttle_speed) {
+        /*
+         * THE DYNAMIC SINGLE-TRACK (BICYCLE) MODEL
+         *
+         * State in the body frame: forward speed u, lateral speed v, yaw rate r.
+         *
+         * af = atan2(v + lf r, u) - p        (front slip angle)
+         * ar = atan2(v - lr r, u)            (rear slip angle)
+         * Fy = -D tanh(C a / D)              (saturating tire, D = mu Fz)
+         *
+         * du = ax - Fyf sin(p) / m + r v
+         * dv = (Fyf cos(p) + Fyr) / m - r u
+         * dr = (lf Fyf cos(p) - lr Fyr) / Iz
+         *
+         * where ax drives u towards the throttle speed with a first-order
+         * response, limited by the available traction. The state starts from
+         * the current Chipmunk velocities, so collisions are accounted for.
+         *
+         * Explicit integration of the lateral dynamics is stable only for
+         * steps shorter than their time constants. These grow with speed
+         * (tau = m |u| / (Cf + Cr)), so the tightest bound is at low speed,
+         * near the kinematic threshold. The tick is split into sub-steps sized
+         * on the current speed and on the steering rate. Below a small forward
+         * speed the tire model is singular and the kinematic solution is used
+         * instead.
+         *
+         * The heading is integrated along with the sub-steps, and the final
+         * body velocity is rotated back with the heading reached at the end of
+         * the tick. Chipmunk still moves the pose once over the whole tick,
+         * so the sub-steps keep the velocities stable, not the pose.
+         */
+        const Real fDt   = CPhysicsEngine::GetSimulationClockTick();
+        const Real fMass = m_ptControlledBody->m;
+        const Real fIz   = m_ptControlledBody->i;
+        const Real fLf   = m_fWheelbaseDistance * 0.5;
+        const Real fLr   = m_fWheelbaseDistance - fLf;
+        /* Normal load and friction limit on each axle */
+        const Real fDf = m_fFriction * fMass * GRAVITY * fLr / m_fWheelbaseDistance;
+        const Real fDr = m_fFriction * fMass * GRAVITY * fLf / m_fWheelbaseDistance;
+        const Real fMaxAcc = m_fFriction * GRAVITY;
+        /* Current state in the body frame */
+        Real fA = m_ptControlledBody->a;
+        Real fU = m_ptControlledBody->v.x * ::cos(fA) + m_ptControlledBody->v.y * ::sin(fA);
+        Real fV = -m_ptControlledBody->v.x * ::sin(fA) + m_ptControlledBody->v.y * ::cos(fA);
+        Real fR = m_ptControlledBody->w;
+        /* Number of sub-steps: lateral time constants and steering rate */
+        UInt32 unSubsteps = 1;
+        if (Abs(fU) >= m_fKinematicSpeed) {
+            Real fTauV  = fMass * Abs(fU) / (m_fFrontCorneringStiffness + m_fRearCorneringStiffness);
+            Real fTauR  = fIz * Abs(fU) / (m_fFrontCorneringStiffness * fLf * fLf + m_fRearCorneringStiffness * fLr * fLr);
+            Real fMaxH  = 0.5 * Min(fTauV, fTauR);
+            unSubsteps  = Max<UInt32>(unSubsteps, static_cast<UInt32>(::ceil(fDt / fMaxH)));
+        }
+        unSubsteps = Max<UInt32>(unSubsteps,
+                                 static_cast<UInt32>(::ceil(Abs(f_steering_ang - m_fPrevSteeringAngle) / m_fMaxSteeringPerSubstep)));
+        unSubsteps = Min<UInt32>(unSubsteps, m_unMaxSubsteps);
+        const Real fH = fDt / unSubsteps;
+        /* Integrate (semi-implicit Euler), interpolating the steering angle */
+        for (UInt32 i = 1; i <= unSubsteps; ++i) {
+            Real fSteer = m_fPrevSteeringAngle + (f_steering_ang - m_fPrevSteeringAngle) * i / unSubsteps;
+            /* Longitudinal response, limited by traction */
+            Real fAx = (f_throttle_speed - fU) / m_fThrottleTimeConstant;
+            fAx = Min(Max(fAx, -fMaxAcc), fMaxAcc);
+            if (Abs(fU) < m_fKinematicSpeed) {
+                /* Low speed: kinematic solution, no slip */
+                fU += fAx * fH;
+                fR = fU * ::tan(fSteer) / m_fWheelbaseDistance;
+                fV = fR * fLr;
+                fA += fR * fH;
+                continue;
+            }
+            Real fSign = (fU > 0.0) ? 1.0 : -1.0;
+            Real fAlphaF = ::atan2(fV + fLf * fR, Abs(fU)) - fSign * fSteer;
+            Real fAlphaR = ::atan2(fV - fLr * fR, Abs(fU));
+            Real fFyf = -fSign * fDf * ::tanh(m_fFrontCorneringStiffness * fAlphaF / fDf);
+            Real fFyr = -fSign * fDr * ::tanh(m_fRearCorneringStiffness * fAlphaR / fDr);
+            Real fCosS = ::cos(fSteer);
+            fU += (fAx - fFyf * ::sin(fSteer) / fMass + fR * fV) * fH;
+            fV += ((fFyf * fCosS + fFyr) / fMass - fR * fU) * fH;
+            fR += ((fLf * fFyf * fCosS - fLr * fFyr) / fIz) * fH;
+            fA += fR * fH;
+        }
+        m_fPrevSteeringAngle = f_steering_ang;
+        m_unLastNumSubsteps  = unSubsteps;
+        /* Back to the world frame, with the heading at the end of the tick */
+        const Real fCosA = ::cos(fA);
+        const Real fSinA = ::sin(fA);
+        CVector2 cLinVel(fU * fCosA - fV * fSinA,
+                         fU * fSinA + fV * fCosA);
+        /* The body moves with the integrated velocities, the constraints only resolve contacts */
+        m_ptControlledBody->v = cpv(cLinVel.GetX(), cLinVel.GetY());
+        m_ptControlledBody->w = fR;
+        SetLinearVelocity(cLinVel);
+        SetAngularVelocity(fR);
+    }
+
+    void CDynamics2DAckermannSteeringControl::GetControlVelocity(cpVect& t_lin_vel,
+                                                                 cpFloat& f_ang_vel) const {
+        t_lin_vel = m_ptControlBody->v;
+        f_ang_vel = m_ptControlBody->w;
+    }
+
+    void CDynamics2DAckermannSteeringControl::SetControlVelocity(const cpVect& t_lin_vel,
+                                                                 cpFloat f_ang_vel) {
+        m_ptControlBody->v = t_lin_vel;
+        m_ptControlBody->w = f_ang_vel;
+    }
+
+}
@@ -11,6 +11,18 @@ namespace argos {
 namespace argos {
 
     class CDynamics2DAckermannSteeringControl : public CDynamics2DVelocityControl {
+    public:
+
+        /**
+         * The vehicle models available to compute the body velocities.
+         */
+        enum EModel {
+            /** Velocities follow the Ackermann kinematics, the body is pulled there by the constraints */
+            MODEL_KINEMATIC = 0,
+            /** Single-track model with lateral tire forces, integrated in adaptive sub-steps */
+            MODEL_DYNAMIC
+        };
+
     public:
 
         CDynamics2DAckermannSteeringControl(CDynamics2DEngine& c_engine,
@@ -22,6 +34,8 @@ namespace argos {
 
         virtual ~CDynamics2DAckermannSteeringControl() {}
 
+        void Reset();
+
         void SetSteeringAndThrottle(Real f_steering_ang,
                                     Real f_throttle_speed);
 
@@ -33,13 +47,88 @@ namespace argos {
             return m_fInterwheelDistance;
         }
 
+        inline EModel GetModel() const {
+            return m_eModel;
+        }
+
+        /**
+         * Returns the number of sub-steps used in the last dynamic model update.
+         */
+        inline UInt32 GetLastNumSubsteps() const {
+            return m_unLastNumSubsteps;
+        }
+
+        /**
+         * Returns the velocities the control body is currently driving the
+         * controlled body towards.
+         */
+        void GetControlVelocity(cpVect& t_lin_vel,
+                                cpFloat& f_ang_vel) const;
+
+        /**
+         * Sets the velocities of the control body directly, e.g., to carry them
+         * over from another engine.
+         */
+        void SetControlVelocity(const cpVect& t_lin_vel,
+                                cpFloat f_ang_vel);
+
+        /**
+         * Returns the steering angle at the end of the previous tick, from which
+         * the dynamic model interpolates.
+         */
+        inline Real GetPreviousSteeringAngle() const {
+            return m_fPrevSteeringAngle;
+        }
+
+        inline void SetPreviousSteeringAngle(Real f_steering_ang) {
+            m_fPrevSteeringAngle = f_steering_ang;
+        }
+
+    private:
+
+        /**
+         * Integrates the single-track model over one simulation tick.
+         */
+        void StepDynamicModel(Real f_steering_ang,
+                              Real f_throttle_speed);
+
     private:
 
         Real m_fInterwheelDistance;
 
         Real m_fWheelbaseDistance;
+
+        /** Vehicle model in use */
+        EModel m_eModel;
+
+        /** Cornering stiffness of the front axle [N/rad] */
+        Real m_fFrontCorneringStiffness;
+
+        /** Cornering stiffness of the rear axle [N/rad] */
+        Real m_fRearCorneringStiffness;
+
+        /** Tire-road friction coefficient */
+        Real m_fFriction;
+
+        /** Time constant of the longitudinal speed response [s] */
+        Real m_fThrottleTimeConstant;
+
+        /** Below this forward speed the kinematic model is used [m/s] */
+        Real m_fKinematicSpeed;
+
+        /** Maximum change of steering angle in a single sub-step [rad] */
+        Real m_fMaxSteeringPerSubstep;
+
+        /** Upper bound on the number of sub-steps per tick */
+        UInt32 m_unMaxSubsteps;
+
+        /** Steering angle at the end of the previous tick */
+        Real m_fPrevSteeringAngle;
+
+        /** Number of sub-steps used in the last update */
+        UInt32 m_unLastNumSubsteps;
     };
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -1,7 +1,14 @@
 #include "dynamics2d_deepracer_model.h"
 
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
 #include <argos3/plugins/simulator/physics_engines/dynamics2d/dynamics2d_engine.h>
 
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "deepracer_init_profiler.h"
 #include "deepracer_measures.h"
 
 namespace argos {
@@ -20,6 +27,80 @@ namespace argos {
         DEEPRACER_FRONT_RIGHT_WHEEL = 3
     };
 
+    /*
+     * States of the robots in transit between two engines, by robot id, with
+     * the step in which they were saved. The space transfers a robot in that
+     * same step, so older entries belong to robots removed while leaving.
+     * Engines run in parallel, so access is serialized; entries are only
+     * written when a robot crosses a boundary.
+     */
+    struct SMigratingState {
+        UInt32                                     Clock;
+        CDynamics2DDeepracerModel::SMigrationState State;
+    };
+    static std::unordered_map<std::string, SMigratingState> MIGRATING_STATES;
+    static std::mutex                                       MIGRATING_STATES_MUTEX;
+
+    /* Collision type of the DeepRacer body shape, used to install the contact handlers */
+    static const cpCollisionType DEEPRACER_COLLISION_TYPE = 0x44520000;
+
+    /****************************************/
+    /****************************************/
+
+    static CEntity* GetContactEntity(cpShape* pt_shape) {
+        /* The dynamics2d engine stores the model in the body data */
+        CDynamics2DModel* pcModel = reinterpret_cast<CDynamics2DModel*>(pt_shape->body->data);
+        if (pcModel == NULL) return NULL;
+        return &(pcModel->GetEmbodiedEntity().GetRootEntity());
+    }
+
+    static void AddContact(cpShape* pt_own,
+                           cpShape* pt_other,
+                           bool b_begin,
+                           Real f_impulse) {
+        CDeepracerEntity& cEntity = *reinterpret_cast<CDeepracerEntity*>(pt_own->data);
+        CDeepracerEntity::SContact sContact;
+        sContact.Begin   = b_begin;
+        sContact.Other   = GetContactEntity(pt_other);
+        sContact.Impulse = f_impulse;
+        cEntity.GetContacts().push_back(sContact);
+        if (b_begin) {
+            cEntity.SetNumActiveContacts(cEntity.GetNumActiveContacts() + 1);
+        } else if (cEntity.GetNumActiveContacts() > 0) {
+            cEntity.SetNumActiveContacts(cEntity.GetNumActiveContacts() - 1);
+        }
+    }
+
+    /*
+     * Contact handlers. They run inside cpSpaceStep(), in the thread of the
+     * engine that owns both shapes, so each entity's list has a single writer.
+     * They are installed as the default handler of the space, which Chipmunk
+     * calls for every pair of collision types without a handler of its own:
+     * DeepRacers against normal, grippable or any other shapes, and against
+     * each other. Either shape, or both, can be a DeepRacer.
+     */
+    static void DeepracerContactPostSolve(cpArbiter* pt_arbiter, cpSpace*, void*) {
+        if (!cpArbiterIsFirstContact(pt_arbiter)) return;
+        CP_ARBITER_GET_SHAPES(pt_arbiter, ptA, ptB);
+        Real fImpulse = cpvlength(cpArbiterTotalImpulse(pt_arbiter));
+        if (ptA->collision_type == DEEPRACER_COLLISION_TYPE) AddContact(ptA, ptB, true, fImpulse);
+        if (ptB->collision_type == DEEPRACER_COLLISION_TYPE) AddContact(ptB, ptA, true, fImpulse);
+    }
+
+    static void DeepracerContactSeparate(cpArbiter* pt_arbiter, cpSpace*, void*) {
+        CP_ARBITER_GET_SHAPES(pt_arbiter, ptA, ptB);
+        if (ptA->collision_type == DEEPRACER_COLLISION_TYPE) AddContact(ptA, ptB, false, 0.0);
+        if (ptB->collision_type == DEEPRACER_COLLISION_TYPE) AddContact(ptB, ptA, false, 0.0);
+    }
+
+    /*
+     * Number of DeepRacer models per space: the first one installs the
+     * contact handler, the last one forgets the space, whose address can be
+     * reused by the next engine.
+     */
+    static std::unordered_map<cpSpace*, size_t> MODELS_PER_SPACE;
+    static std::mutex                           MODELS_PER_SPACE_MUTEX;
+
     /****************************************/
     /****************************************/
 
@@ -36,6 +117,7 @@ namespace argos {
                            c_entity.GetConfigurationNode()),
           m_pfCurrentWheelThrottleSpeed(m_cAckerWheeledEntity.GetWheelVelocities()),
           m_pfCurrentSteeringAngle(m_cAckerWheeledEntity.GetSteeringAngle()) {
+        CDeepracerInitProfiler::CScope cProfile(CDeepracerInitProfiler::PHASE_PHYSICS);
         /* Create the body with initial position and orientation */
         cpBody* ptBody =
             cpSpaceAddBody(GetDynamics2DEngine().GetPhysicsSpace(),
@@ -67,10 +149,23 @@ namespace argos {
                                            cpvzero));
         ptShape->e = 0.0; // No elasticity
         ptShape->u = 0.7; // Lots of friction
+        /* Report contacts with other objects and other DeepRacers, installing the handler once per space */
+        ptShape->collision_type = DEEPRACER_COLLISION_TYPE;
+        ptShape->data           = &m_cDeepracerEntity;
+        {
+            std::lock_guard<std::mutex> cLock(MODELS_PER_SPACE_MUTEX);
+            if (MODELS_PER_SPACE[GetDynamics2DEngine().GetPhysicsSpace()]++ == 0) {
+                cpSpaceSetDefaultCollisionHandler(GetDynamics2DEngine().GetPhysicsSpace(),
+                                                  NULL, NULL, DeepracerContactPostSolve, DeepracerContactSeparate,
+                                                  NULL);
+            }
+        }
         /* Constrain the actual base body to follow the diff steering control */
         m_cAckerSteering.AttachTo(ptBody);
         /* Set the body so that the default methods work as expected */
         SetBody(ptBody, DEEPRACER_BASE_TOP);
+        /* Pick up the velocities if the robot was handed over by another engine */
+        LoadMigrationState();
     }
 
     /****************************************/
@@ -78,6 +173,18 @@ namespace argos {
 
     CDynamics2DDeepracerModel::~CDynamics2DDeepracerModel() {
         m_cAckerSteering.Detach();
+        {
+            std::lock_guard<std::mutex> cLock(MODELS_PER_SPACE_MUTEX);
+            std::unordered_map<cpSpace*, size_t>::iterator it = MODELS_PER_SPACE.find(GetDynamics2DEngine().GetPhysicsSpace());
+            if (it != MODELS_PER_SPACE.end() && --it->second == 0) {
+                MODELS_PER_SPACE.erase(it);
+            }
+        }
+        /* A robot still inside the engine is being removed from the space, not handed over */
+        if (GetDynamics2DEngine().IsPointContained(GetEmbodiedEntity().GetOriginAnchor().Position)) {
+            std::lock_guard<std::mutex> cLock(MIGRATING_STATES_MUTEX);
+            MIGRATING_STATES.erase(m_cDeepracerEntity.GetId());
+        }
     }
 
     /****************************************/
@@ -86,12 +193,23 @@ namespace argos {
     void CDynamics2DDeepracerModel::Reset() {
         CDynamics2DSingleBodyObjectModel::Reset();
         m_cAckerSteering.Reset();
+        /* Forget any pending hand-over, the robot goes back to its initial pose */
+        std::lock_guard<std::mutex> cLock(MIGRATING_STATES_MUTEX);
+        MIGRATING_STATES.erase(m_cDeepracerEntity.GetId());
     }
 
     /****************************************/
     /****************************************/
 
     void CDynamics2DDeepracerModel::UpdateFromEntityStatus() { // TODO: implement correct code
+        /* A new step begins, drop the contacts reported in the previous one */
+        m_cDeepracerEntity.GetContacts().clear();
+        /* The dynamic model integrates the velocities also when coasting to a stop */
+        if (m_cAckerSteering.GetModel() == CDynamics2DAckermannSteeringControl::MODEL_DYNAMIC) {
+            m_cAckerSteering.SetSteeringAndThrottle(*m_pfCurrentSteeringAngle,
+                                                    m_pfCurrentWheelThrottleSpeed[DEEPRACER_REAR_LEFT_WHEEL]);
+            return;
+        }
         /* Do we want to move? */
         if ((m_pfCurrentWheelThrottleSpeed[DEEPRACER_REAR_LEFT_WHEEL] != 0.0f) ||
             (m_pfCurrentWheelThrottleSpeed[DEEPRACER_REAR_RIGHT_WHEEL] != 0.0f) ||
@@ -108,6 +226,74 @@ namespace argos {
     /****************************************/
     /****************************************/
 
+    void CDynamics2DDeepracerModel::UpdateEntityStatus() {
+        CDynamics2DSingleBodyObjectModel::UpdateEntityStatus();
+        /* The space transfers the entity at the end of the step if it left the engine */
+        if (!GetDynamics2DEngine().IsPointContained(GetEmbodiedEntity().GetOriginAnchor().Position)) {
+            SaveMigrationState();
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDynamics2DDeepracerModel::GetBodyState(SMigrationState& s_state) const {
+        s_state.BodyLinVel        = GetBody()->v;
+        s_state.BodyAngVel        = GetBody()->w;
+        s_state.PrevSteeringAngle = m_cAckerSteering.GetPreviousSteeringAngle();
+        m_cAckerSteering.GetControlVelocity(s_state.ControlLinVel, s_state.ControlAngVel);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDynamics2DDeepracerModel::SetBodyState(const SMigrationState& s_state) {
+        GetBody()->v = s_state.BodyLinVel;
+        GetBody()->w = s_state.BodyAngVel;
+        m_cAckerSteering.SetPreviousSteeringAngle(s_state.PrevSteeringAngle);
+        m_cAckerSteering.SetControlVelocity(s_state.ControlLinVel, s_state.ControlAngVel);
+    }
+
+    /****************************************/
+    /****************************************/
+
+    size_t CDynamics2DDeepracerModel::GetChipmunkBytes() {
+        /* Body and box shape, which keeps vertices and splitting planes in body and world frame */
+        size_t unBytes = sizeof(cpBody) + sizeof(cpPolyShape) + 4 * (2 * sizeof(cpVect) + 2 * sizeof(cpSplittingPlane));
+        /* Control body with the pivot and gear joints of the velocity control */
+        unBytes += sizeof(cpBody) + sizeof(cpPivotJoint) + sizeof(cpGearJoint);
+        return unBytes;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDynamics2DDeepracerModel::SaveMigrationState() {
+        SMigratingState sState;
+        sState.Clock = CSimulator::GetInstance().GetSpace().GetSimulationClock();
+        GetBodyState(sState.State);
+        std::lock_guard<std::mutex> cLock(MIGRATING_STATES_MUTEX);
+        MIGRATING_STATES[m_cDeepracerEntity.GetId()] = sState;
+    }
+
+    /****************************************/
+    /****************************************/
+
+    void CDynamics2DDeepracerModel::LoadMigrationState() {
+        std::lock_guard<std::mutex> cLock(MIGRATING_STATES_MUTEX);
+        auto itState = MIGRATING_STATES.find(m_cDeepracerEntity.GetId());
+        if (itState != MIGRATING_STATES.end()) {
+            /* The pose comes from the embodied entity, only the velocities are missing */
+            if (itState->second.Clock == CSimulator::GetInstance().GetSpace().GetSimulationClock()) {
+                SetBodyState(itState->second.State);
+            }
+            MIGRATING_STATES.erase(itState);
+        }
+    }
+
+    /****************************************/
+    /****************************************/
+
     REGISTER_STANDARD_DYNAMICS2D_OPERATIONS_ON_ENTITY(CDeepracerEntity, CDynamics2DDeepracerModel);
 
     /****************************************/
@@ -14,6 +14,20 @@ namespace argos {
 namespace argos {
 
     class CDynamics2DDeepracerModel : public CDynamics2DSingleBodyObjectModel {
+    public:
+
+        /**
+         * Chipmunk state carried over when the robot migrates to another engine,
+         * or stored in a snapshot. The pose is kept by the embodied entity.
+         */
+        struct SMigrationState {
+            cpVect  BodyLinVel;
+            cpFloat BodyAngVel;
+            cpVect  ControlLinVel;
+            cpFloat ControlAngVel;
+            Real    PrevSteeringAngle;
+        };
+
     public:
 
         CDynamics2DDeepracerModel(CDynamics2DEngine& c_engine,
@@ -24,6 +38,36 @@ namespace argos {
 
         virtual void UpdateFromEntityStatus();
 
+        virtual void UpdateEntityStatus();
+
+        /**
+         * Copies the velocities of the body and of the control into s_state.
+         */
+        void GetBodyState(SMigrationState& s_state) const;
+
+        /**
+         * Sets the velocities of the body and of the control from s_state.
+         */
+        void SetBodyState(const SMigrationState& s_state);
+
+        /**
+         * Returns the bytes allocated by Chipmunk for this robot: the body, its
+         * shape and the control body with its constraints.
+         */
+        static size_t GetChipmunkBytes();
+
+    private:
+
+        /**
+         * Stores the state of the body if it is about to leave this engine.
+         */
+        void SaveMigrationState();
+
+        /**
+         * Restores the state stored by the engine the robot comes from, if any.
+         */
+        void LoadMigrationState();
+
     private:
 
         CDeepracerEntity& m_cDeepracerEntity;
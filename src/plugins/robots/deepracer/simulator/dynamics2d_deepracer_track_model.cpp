@@ -0,0 +1,50 @@
+#include "dynamics2d_deepracer_track_model.h"
+
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/plugins/simulator/physics_engines/dynamics2d/dynamics2d_engine.h>
+
+namespace argos {
+
+    /****************************************/
+    /****************************************/
+
+    CDynamics2DDeepracerTrackModel::CDynamics2DDeepracerTrackModel(CDynamics2DEngine&     c_engine,
+                                                                   CDeepracerTrackEntity& c_entity)
+        : CDynamics2DSingleBodyObjectModel(c_engine, c_entity),
+          m_cTrackEntity(c_entity) {
+        /* The track never moves: a single static body at the entity pose */
+        cpBody* ptBody = cpBodyNewStatic();
+        const CVector3& cPosition = GetEmbodiedEntity().GetOriginAnchor().Position;
+        ptBody->p = cpv(cPosition.GetX(), cPosition.GetY());
+        CRadians cXAngle, cYAngle, cZAngle;
+        GetEmbodiedEntity().GetOriginAnchor().Orientation.ToEulerAngles(cZAngle, cYAngle, cXAngle);
+        cpBodySetAngle(ptBody, cZAngle.GetValue());
+        /*
+         * One segment shape per wall, in the frame of the body. The shapes are
+         * added in the order of the BVH leaves, so that spatially close walls are
+         * inserted together in the static index of the space.
+         */
+        const CDeepracerSegmentBVH::TSegments& tWalls = m_cTrackEntity.GetWalls().GetSegments();
+        for (size_t i = 0; i < tWalls.size(); ++i) {
+            cpShape* ptShape =
+                cpSpaceAddShape(GetDynamics2DEngine().GetPhysicsSpace(),
+                                cpSegmentShapeNew(ptBody,
+                                                  cpv(tWalls[i].Start.GetX(), tWalls[i].Start.GetY()),
+                                                  cpv(tWalls[i].End.GetX(), tWalls[i].End.GetY()),
+                                                  m_cTrackEntity.GetWallThickness() * 0.5));
+            ptShape->e = 0.0; // No elasticity
+            ptShape->u = 0.1; // Little friction, like the boxes
+        }
+        /* Set the body so that the default methods work as expected */
+        SetBody(ptBody, m_cTrackEntity.GetWallHeight());
+    }
+
+    /****************************************/
+    /****************************************/
+
+    REGISTER_STANDARD_DYNAMICS2D_OPERATIONS_ON_ENTITY(CDeepracerTrackEntity, CDynamics2DDeepracerTrackModel);
+
+    /****************************************/
+    /****************************************/
+
+}
@@ -0,0 +1,28 @@
+#ifndef DYNAMICS2D_DEEPRACER_TRACK_MODEL_H
+#define DYNAMICS2D_DEEPRACER_TRACK_MODEL_H
+
+namespace argos {
+    class CDynamics2DDeepracerTrackModel;
+}
+
+#include <argos3/plugins/robots/deepracer/simulator/deepracer_track_entity.h>
+#include <argos3/plugins/simulator/physics_engines/dynamics2d/dynamics2d_single_body_object_model.h>
+
+namespace argos {
+
+    class CDynamics2DDeepracerTrackModel : public CDynamics2DSingleBodyObjectModel {
+    public:
+
+        CDynamics2DDeepracerTrackModel(CDynamics2DEngine& c_engine,
+                                       CDeepracerTrackEntity& c_entity);
+
+        virtual ~CDynamics2DDeepracerTrackModel() {}
+
+    private:
+
+        CDeepracerTrackEntity& m_cTrackEntity;
+    };
+
+}
+
+#endif
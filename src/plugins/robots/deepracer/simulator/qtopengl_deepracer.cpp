@@ -6,27 +6,159 @@
 #include <argos3/plugins/simulator/entities/led_equipped_entity.h>
 #include <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_widget.h>
 #include <QImage>
+#include <cmath>
 
 namespace argos {
 
    /****************************************/
    /****************************************/
 
+   /* Farthest distances at which the mesh and the box are drawn [m] */
+   static const GLfloat LOD_MESH_DISTANCE = 4.0f;
+   static const GLfloat LOD_BOX_DISTANCE  = 15.0f;
+
+   /* Radius of the sphere enclosing the robot, centered halfway up its body [m] */
+   static const GLfloat BOUNDING_RADIUS = 0.2f;
+
+   static const GLfloat LOD_COLOR[]     = { 0.15f, 0.15f, 0.17f, 1.0f };
+   static const GLfloat LOD_SPECULAR[]  = { 0.0f, 0.0f, 0.0f, 1.0f };
+   static const GLfloat LOD_SHININESS[] = { 0.0f };
+   static const GLfloat LOD_EMISSION[]  = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+   /****************************************/
+   /****************************************/
+
    CQTOpenGLDeepracer::CQTOpenGLDeepracer() :
-      m_cBodyModel("deepracer.obj") {
+      m_cBodyModel("deepracer.obj"),
+      m_unBoxList(0),
+      m_unFootprintList(0) {
    }
 
    /****************************************/
    /****************************************/
 
    CQTOpenGLDeepracer::~CQTOpenGLDeepracer() {
+      if(m_unBoxList != 0) glDeleteLists(m_unBoxList, 1);
+      if(m_unFootprintList != 0) glDeleteLists(m_unFootprintList, 1);
    }
 
    /****************************************/
    /****************************************/
 
    void CQTOpenGLDeepracer::Draw(CDeepracerEntity& c_entity) {
-      m_cBodyModel.Draw();
+      switch(GetLevelOfDetail()) {
+         case LOD_MESH:
+            m_cBodyModel.Draw();
+            break;
+         case LOD_BOX:
+            if(m_unBoxList == 0) MakeLists();
+            glCallList(m_unBoxList);
+            break;
+         case LOD_FOOTPRINT:
+            if(m_unFootprintList == 0) MakeLists();
+            glCallList(m_unFootprintList);
+            break;
+         case LOD_CULLED:
+            break;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLDeepracer::ELevelOfDetail CQTOpenGLDeepracer::GetLevelOfDetail() {
+      GLfloat pfModelView[16], pfProjection[16];
+      glGetFloatv(GL_MODELVIEW_MATRIX, pfModelView);
+      glGetFloatv(GL_PROJECTION_MATRIX, pfProjection);
+      /* Center of the robot in eye coordinates (matrices are column-major) */
+      GLfloat fCenterZ = 0.5f * DEEPRACER_BASE_TOP;
+      GLfloat pfCenter[3];
+      for(UInt32 i = 0; i < 3; ++i) {
+         pfCenter[i] = pfModelView[8 + i] * fCenterZ + pfModelView[12 + i];
+      }
+      /* Frustum planes in eye coordinates: the last row of the projection plus or minus each other row */
+      for(UInt32 i = 0; i < 6; ++i) {
+         GLfloat fSign = (i % 2 == 0) ? 1.0f : -1.0f;
+         UInt32 unRow = i / 2;
+         GLfloat pfPlane[4];
+         for(UInt32 j = 0; j < 4; ++j) {
+            pfPlane[j] = pfProjection[4 * j + 3] + fSign * pfProjection[4 * j + unRow];
+         }
+         GLfloat fNormLength = ::sqrt(pfPlane[0] * pfPlane[0] + pfPlane[1] * pfPlane[1] + pfPlane[2] * pfPlane[2]);
+         GLfloat fDistance = pfPlane[0] * pfCenter[0] + pfPlane[1] * pfCenter[1] + pfPlane[2] * pfCenter[2] + pfPlane[3];
+         if(fDistance < -BOUNDING_RADIUS * fNormLength) return LOD_CULLED;
+      }
+      GLfloat fDistance = ::sqrt(pfCenter[0] * pfCenter[0] + pfCenter[1] * pfCenter[1] + pfCenter[2] * pfCenter[2]);
+      if(fDistance < LOD_MESH_DISTANCE) return LOD_MESH;
+      if(fDistance < LOD_BOX_DISTANCE) return LOD_BOX;
+      return LOD_FOOTPRINT;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLDeepracer::MakeLists() {
+      GLfloat fHalfL = 0.5f * DEEPRACER_BASE_LENGTH;
+      GLfloat fHalfW = 0.5f * DEEPRACER_BASE_WIDTH;
+      GLfloat fTop   = DEEPRACER_BASE_TOP;
+      /* Box from the floor to the top of the base, so the wheels are covered too */
+      m_unBoxList = glGenLists(1);
+      glNewList(m_unBoxList, GL_COMPILE);
+      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, LOD_COLOR);
+      glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, LOD_SPECULAR);
+      glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, LOD_SHININESS);
+      glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, LOD_EMISSION);
+      glBegin(GL_QUADS);
+      /* Top and bottom */
+      glNormal3f(0.0f, 0.0f, 1.0f);
+      glVertex3f(-fHalfL, -fHalfW, fTop);
+      glVertex3f( fHalfL, -fHalfW, fTop);
+      glVertex3f( fHalfL,  fHalfW, fTop);
+      glVertex3f(-fHalfL,  fHalfW, fTop);
+      glNormal3f(0.0f, 0.0f, -1.0f);
+      glVertex3f(-fHalfL, -fHalfW, 0.0f);
+      glVertex3f(-fHalfL,  fHalfW, 0.0f);
+      glVertex3f( fHalfL,  fHalfW, 0.0f);
+      glVertex3f( fHalfL, -fHalfW, 0.0f);
+      /* Front and back */
+      glNormal3f(1.0f, 0.0f, 0.0f);
+      glVertex3f( fHalfL, -fHalfW, 0.0f);
+      glVertex3f( fHalfL,  fHalfW, 0.0f);
+      glVertex3f( fHalfL,  fHalfW, fTop);
+      glVertex3f( fHalfL, -fHalfW, fTop);
+      glNormal3f(-1.0f, 0.0f, 0.0f);
+      glVertex3f(-fHalfL, -fHalfW, 0.0f);
+      glVertex3f(-fHalfL, -fHalfW, fTop);
+      glVertex3f(-fHalfL,  fHalfW, fTop);
+      glVertex3f(-fHalfL,  fHalfW, 0.0f);
+      /* Sides */
+      glNormal3f(0.0f, 1.0f, 0.0f);
+      glVertex3f(-fHalfL,  fHalfW, 0.0f);
+      glVertex3f(-fHalfL,  fHalfW, fTop);
+      glVertex3f( fHalfL,  fHalfW, fTop);
+      glVertex3f( fHalfL,  fHalfW, 0.0f);
+      glNormal3f(0.0f, -1.0f, 0.0f);
+      glVertex3f(-fHalfL, -fHalfW, 0.0f);
+      glVertex3f( fHalfL, -fHalfW, 0.0f);
+      glVertex3f( fHalfL, -fHalfW, fTop);
+      glVertex3f(-fHalfL, -fHalfW, fTop);
+      glEnd();
+      glEndList();
+      /* Footprint: the top face only */
+      m_unFootprintList = glGenLists(1);
+      glNewList(m_unFootprintList, GL_COMPILE);
+      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, LOD_COLOR);
+      glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, LOD_SPECULAR);
+      glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, LOD_SHININESS);
+      glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, LOD_EMISSION);
+      glBegin(GL_QUADS);
+      glNormal3f(0.0f, 0.0f, 1.0f);
+      glVertex3f(-fHalfL, -fHalfW, fTop);
+      glVertex3f( fHalfL, -fHalfW, fTop);
+      glVertex3f( fHalfL,  fHalfW, fTop);
+      glVertex3f(-fHalfL,  fHalfW, fTop);
+      glEnd();
+      glEndList();
    }
 
    /****************************************/
@@ -18,20 +18,49 @@ namespace argos {
 
    class CQTOpenGLDeepracer {
 
+   public:
+
+      /**
+       * Level of detail a robot is drawn with.
+       */
+      enum ELevelOfDetail {
+         LOD_MESH = 0,
+         LOD_BOX,
+         LOD_FOOTPRINT,
+         LOD_CULLED
+      };
+
    public:
 
       CQTOpenGLDeepracer();
 
       virtual ~CQTOpenGLDeepracer();
 
+      /**
+       * Draws the robot, assuming the modelview matrix already holds its pose.
+       * Robots out of the view frustum are skipped; distant ones are drawn as
+       * a box, then as their footprint.
+       */
       virtual void Draw(CDeepracerEntity& c_entity);
 
+      /**
+       * Picks the level of detail from the current modelview and projection matrices.
+       */
+      static ELevelOfDetail GetLevelOfDetail();
+
+   private:
+
+      void MakeLists();
+
    private:
 
       CQTOpenGLObjModel m_cBodyModel;
+      /** Display lists of the box and the footprint, 0 until created */
+      GLuint            m_unBoxList;
+      GLuint            m_unFootprintList;
 
    };
 
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,308 @@
+#include "qtopengl_deepracer_capture.h"
+
+#include <argos3/core/simulator/simulator.h>
+#include <argos3/core/simulator/space/space.h>
+#include <argos3/core/utility/logging/argos_log.h>
+#include <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_widget.h>
+
+#include <QDir>
+#include <QImage>
+#include <QOpenGLContext>
+#include <QOpenGLFunctions>
+#include <QPainter>
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   /* Bytes per pixel, RGBA */
+   static const UInt32 PIXEL_SIZE = 4;
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLDeepracerCapture::CQTOpenGLDeepracerCapture() :
+      m_bEnabled(false),
+      m_strDirectory("frames"),
+      m_strPrefix("frame"),
+      m_eFormat(FORMAT_PNG),
+      m_unEvery(1),
+      m_unLastClock(0),
+      m_bFirstCapture(true),
+      m_unNextPBO(0),
+      m_unWidth(0),
+      m_unHeight(0),
+      m_unNextFrame(0),
+      m_nRawFile(-1),
+      m_unWritten(0),
+      m_unFailed(0),
+      m_unDropped(0) {
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLDeepracerCapture::~CQTOpenGLDeepracerCapture() {
+      StopEncoders();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLDeepracerCapture::Init(TConfigurationNode& t_tree) {
+      try {
+         if(!NodeExists(t_tree, "capture")) return;
+         TConfigurationNode& tCapture = GetNode(t_tree, "capture");
+         m_bEnabled = true;
+         GetNodeAttributeOrDefault(tCapture, "enabled", m_bEnabled, m_bEnabled);
+         if(!m_bEnabled) return;
+         GetNodeAttributeOrDefault(tCapture, "directory", m_strDirectory, m_strDirectory);
+         GetNodeAttributeOrDefault(tCapture, "prefix", m_strPrefix, m_strPrefix);
+         std::string strFormat = "png";
+         GetNodeAttributeOrDefault(tCapture, "format", strFormat, strFormat);
+         if(strFormat == "png") {
+            m_eFormat = FORMAT_PNG;
+         }
+         else if(strFormat == "raw") {
+            m_eFormat = FORMAT_RAW;
+         }
+         else {
+            THROW_ARGOSEXCEPTION("Unknown capture format \"" << strFormat << "\", expected \"png\" or \"raw\"");
+         }
+         GetNodeAttributeOrDefault(tCapture, "every", m_unEvery, m_unEvery);
+         UInt32 unEncoders = 2, unQueueSize = 16, unBuffers = 3;
+         GetNodeAttributeOrDefault(tCapture, "encoders", unEncoders, unEncoders);
+         GetNodeAttributeOrDefault(tCapture, "queue", unQueueSize, unQueueSize);
+         GetNodeAttributeOrDefault(tCapture, "buffers", unBuffers, unBuffers);
+         if(m_unEvery == 0 || unEncoders == 0 || unQueueSize == 0 || unBuffers == 0) {
+            THROW_ARGOSEXCEPTION("The 'every', 'encoders', 'queue' and 'buffers' attributes must be positive");
+         }
+         ExpandEnvVariables(m_strDirectory);
+         if(!QDir().mkpath(QString::fromStdString(m_strDirectory))) {
+            THROW_ARGOSEXCEPTION("Can't create directory \"" << m_strDirectory << "\"");
+         }
+         if(m_eFormat == FORMAT_RAW) {
+            std::string strFile = m_strDirectory + "/" + m_strPrefix + ".rgba";
+            m_nRawFile = ::open(strFile.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if(m_nRawFile < 0) {
+               THROW_ARGOSEXCEPTION("Can't open \"" << strFile << "\": " << ::strerror(errno));
+            }
+         }
+         m_vecPBOs.resize(unBuffers, NULL);
+         m_vecPendingFrames.resize(unBuffers, -1);
+         /* Frames for the queue, plus one being written by each encoder */
+         m_cFrames.Start(unQueueSize + unEncoders, unEncoders,
+                         [this](SFrame& s_frame) { Encode(s_frame); });
+      }
+      catch(CARGoSException& ex) {
+         THROW_ARGOSEXCEPTION_NESTED("Error initializing the DeepRacer capture", ex);
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLDeepracerCapture::Destroy() {
+      /* The encoders run from Init() to the first call */
+      if(!m_cFrames.IsRunning()) return;
+      /* Collect the frames still in flight, oldest first */
+      GetQTOpenGLWidget().makeCurrent();
+      for(UInt32 i = 0; i < m_vecPBOs.size(); ++i) {
+         UInt32 unPBO = (m_unNextPBO + i) % m_vecPBOs.size();
+         if(m_vecPendingFrames[unPBO] >= 0) Collect(unPBO);
+      }
+      for(size_t i = 0; i < m_vecPBOs.size(); ++i) {
+         if(m_vecPBOs[i] == NULL) continue;
+         m_vecPBOs[i]->destroy();
+         delete m_vecPBOs[i];
+         m_vecPBOs[i] = NULL;
+      }
+      GetQTOpenGLWidget().doneCurrent();
+      StopEncoders();
+      LOG << "[INFO] DeepRacer capture: " << m_unWritten.load() << " frames written to \"" << m_strDirectory << "\", "
+          << m_unDropped << " dropped, " << m_unFailed.load() << " failed";
+      if(m_eFormat == FORMAT_RAW) {
+         LOG << " (raw RGBA, " << m_unWidth << "x" << m_unHeight << ", dropped frames left black)";
+      }
+      LOG << std::endl;
+      m_bEnabled = false;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLDeepracerCapture::DrawOverlay(QPainter& c_painter) {
+      if(!m_bEnabled) return;
+      /* One frame per step, and only every m_unEvery steps */
+      UInt32 unClock = CSimulator::GetInstance().GetSpace().GetSimulationClock();
+      if((m_bFirstCapture || unClock != m_unLastClock) && unClock % m_unEvery == 0) {
+         m_bFirstCapture = false;
+         m_unLastClock = unClock;
+         QPaintDevice* pcDevice = c_painter.device();
+         c_painter.beginNativePainting();
+         Capture(pcDevice->width() * pcDevice->devicePixelRatio(),
+                 pcDevice->height() * pcDevice->devicePixelRatio());
+         c_painter.endNativePainting();
+      }
+      if(!m_bEnabled) return;
+      /* Status, drawn after the read-back so it is not recorded */
+      c_painter.setPen(m_unDropped > 0 ? Qt::red : Qt::darkGreen);
+      c_painter.drawText(10, 20, QString("REC %1 frames, %2 dropped")
+                         .arg(m_unWritten.load())
+                         .arg(m_unDropped));
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLDeepracerCapture::Capture(UInt32 un_width,
+                                           UInt32 un_height) {
+      if(un_width != m_unWidth || un_height != m_unHeight) {
+         ResizeBuffers(un_width, un_height);
+         if(!m_bEnabled) return;
+      }
+      /* The slot reused now holds the oldest transfer, finished by now */
+      UInt32 unPBO = m_unNextPBO;
+      if(m_vecPendingFrames[unPBO] >= 0) Collect(unPBO);
+      QOpenGLFunctions* pcGL = QOpenGLContext::currentContext()->functions();
+      m_vecPBOs[unPBO]->bind();
+      pcGL->glPixelStorei(GL_PACK_ALIGNMENT, 1);
+      pcGL->glReadPixels(0, 0, m_unWidth, m_unHeight, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+      m_vecPBOs[unPBO]->release();
+      m_vecPendingFrames[unPBO] = m_unNextFrame++;
+      m_unNextPBO = (unPBO + 1) % m_vecPBOs.size();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLDeepracerCapture::Collect(UInt32 un_pbo) {
+      UInt32 unIndex = m_vecPendingFrames[un_pbo];
+      m_vecPendingFrames[un_pbo] = -1;
+      /* Take a free frame, or drop this one if the encoders are behind */
+      SFrame* psFrame = m_cFrames.TryAcquire();
+      if(psFrame == NULL) {
+         if(m_unDropped++ == 0) {
+            LOGERR << "[WARNING] DeepRacer capture: the encoders are falling behind, frames are being dropped" << std::endl;
+         }
+         return;
+      }
+      m_vecPBOs[un_pbo]->bind();
+      const UInt8* punPixels = static_cast<const UInt8*>(m_vecPBOs[un_pbo]->map(QOpenGLBuffer::ReadOnly));
+      bool bMapped = (punPixels != NULL);
+      if(bMapped) {
+         psFrame->Index  = unIndex;
+         psFrame->Width  = m_unWidth;
+         psFrame->Height = m_unHeight;
+         psFrame->Pixels.resize(m_unWidth * m_unHeight * PIXEL_SIZE);
+         ::memcpy(psFrame->Pixels.data(), punPixels, psFrame->Pixels.size());
+         m_vecPBOs[un_pbo]->unmap();
+      }
+      m_vecPBOs[un_pbo]->release();
+      if(bMapped) {
+         m_cFrames.Queue(psFrame);
+      }
+      else {
+         m_cFrames.Release(psFrame);
+         ++m_unFailed;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLDeepracerCapture::ResizeBuffers(UInt32 un_width,
+                                                 UInt32 un_height) {
+      /* Flush the transfers of the old size, oldest first */
+      for(UInt32 i = 0; i < m_vecPBOs.size(); ++i) {
+         UInt32 unPBO = (m_unNextPBO + i) % m_vecPBOs.size();
+         if(m_vecPendingFrames[unPBO] >= 0) Collect(unPBO);
+      }
+      if(m_eFormat == FORMAT_RAW && m_unNextFrame > 0) {
+         /* A raw video has a single frame size */
+         LOGERR << "[WARNING] DeepRacer capture: the view was resized, the raw capture stops here" << std::endl;
+         m_bEnabled = false;
+         return;
+      }
+      m_unWidth  = un_width;
+      m_unHeight = un_height;
+      for(size_t i = 0; i < m_vecPBOs.size(); ++i) {
+         if(m_vecPBOs[i] == NULL) {
+            m_vecPBOs[i] = new QOpenGLBuffer(QOpenGLBuffer::PixelPackBuffer);
+            m_vecPBOs[i]->setUsagePattern(QOpenGLBuffer::StreamRead);
+            m_vecPBOs[i]->create();
+         }
+         m_vecPBOs[i]->bind();
+         m_vecPBOs[i]->allocate(m_unWidth * m_unHeight * PIXEL_SIZE);
+         m_vecPBOs[i]->release();
+      }
+      m_unNextPBO = 0;
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLDeepracerCapture::StopEncoders() {
+      /* Writes the queued frames first */
+      m_cFrames.Stop();
+      if(m_nRawFile >= 0) {
+         ::close(m_nRawFile);
+         m_nRawFile = -1;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLDeepracerCapture::Encode(SFrame& s_frame) {
+      if(WriteFrame(s_frame)) {
+         ++m_unWritten;
+      }
+      else {
+         ++m_unFailed;
+      }
+   }
+
+   /****************************************/
+   /****************************************/
+
+   bool CQTOpenGLDeepracerCapture::WriteFrame(SFrame& s_frame) {
+      /* OpenGL rows go from bottom to top */
+      UInt32 unRowSize = s_frame.Width * PIXEL_SIZE;
+      std::vector<UInt8> vecRow(unRowSize);
+      for(UInt32 i = 0; i < s_frame.Height / 2; ++i) {
+         UInt8* punTop    = &s_frame.Pixels[i * unRowSize];
+         UInt8* punBottom = &s_frame.Pixels[(s_frame.Height - 1 - i) * unRowSize];
+         ::memcpy(vecRow.data(), punTop, unRowSize);
+         ::memcpy(punTop, punBottom, unRowSize);
+         ::memcpy(punBottom, vecRow.data(), unRowSize);
+      }
+      if(m_eFormat == FORMAT_RAW) {
+         /* Each frame has its slot in the file, so encoders can write in any order */
+         size_t unSize = s_frame.Pixels.size();
+         return ::pwrite(m_nRawFile, s_frame.Pixels.data(), unSize, static_cast<off_t>(s_frame.Index) * unSize) ==
+            static_cast<ssize_t>(unSize);
+      }
+      std::ostringstream cPath;
+      cPath << m_strDirectory << "/" << m_strPrefix << "_" << std::setw(6) << std::setfill('0') << s_frame.Index << ".png";
+      QImage cImage(s_frame.Pixels.data(), s_frame.Width, s_frame.Height, unRowSize, QImage::Format_RGBA8888);
+      return cImage.save(QString::fromStdString(cPath.str()), "PNG");
+   }
+
+   /****************************************/
+   /****************************************/
+
+   REGISTER_QTOPENGL_USER_FUNCTIONS(CQTOpenGLDeepracerCapture, "deepracer_capture");
+
+   /****************************************/
+   /****************************************/
+
+}
@@ -0,0 +1,115 @@
+#ifndef QTOPENGL_DEEPRACER_CAPTURE_H
+#define QTOPENGL_DEEPRACER_CAPTURE_H
+
+namespace argos {
+   class CQTOpenGLDeepracerCapture;
+}
+
+#include <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_user_functions.h>
+
+#include <QOpenGLBuffer>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+#include "deepracer_buffer_queue.h"
+
+namespace argos {
+
+   /**
+    * Records the Qt-OpenGL view without stalling the simulation.
+    *
+    * Each new step, the frame is read back into a ring of pixel-buffer
+    * objects; a buffer is mapped only when the ring comes back to it, once
+    * the transfer is long finished. The pixels are then copied into a
+    * preallocated frame and queued for encoder threads, which write a PNG
+    * sequence or a raw RGBA video. When no free frame is left, the frame is
+    * dropped and counted instead of waiting for the encoders.
+    */
+   class CQTOpenGLDeepracerCapture : public CQTOpenGLUserFunctions {
+
+   public:
+
+      CQTOpenGLDeepracerCapture();
+
+      virtual ~CQTOpenGLDeepracerCapture();
+
+      virtual void Init(TConfigurationNode& t_tree);
+
+      virtual void Destroy();
+
+      virtual void DrawOverlay(QPainter& c_painter);
+
+   private:
+
+      enum EFormat {
+         FORMAT_PNG = 0,
+         FORMAT_RAW
+      };
+
+      struct SFrame {
+         std::vector<UInt8> Pixels;
+         UInt32             Index;
+         UInt32             Width;
+         UInt32             Height;
+      };
+
+   private:
+
+      /**
+       * Starts the read-back of the current frame and collects the oldest one.
+       */
+      void Capture(UInt32 un_width,
+                   UInt32 un_height);
+
+      /**
+       * Maps a pixel-buffer object and queues its content.
+       */
+      void Collect(UInt32 un_pbo);
+
+      /**
+       * (Re)creates the pixel-buffer objects for the given frame size.
+       */
+      void ResizeBuffers(UInt32 un_width,
+                         UInt32 un_height);
+
+      void StopEncoders();
+
+      void Encode(SFrame& s_frame);
+
+      bool WriteFrame(SFrame& s_frame);
+
+   private:
+
+      bool                        m_bEnabled;
+      std::string                 m_strDirectory;
+      std::string                 m_strPrefix;
+      EFormat                     m_eFormat;
+      /** Capture one step out of m_unEvery */
+      UInt32                      m_unEvery;
+      UInt32                      m_unLastClock;
+      bool                        m_bFirstCapture;
+
+      /** Ring of pixel-buffer objects and the frame pending in each, -1 if none */
+      std::vector<QOpenGLBuffer*> m_vecPBOs;
+      std::vector<SInt64>         m_vecPendingFrames;
+      UInt32                      m_unNextPBO;
+      UInt32                      m_unWidth;
+      UInt32                      m_unHeight;
+      UInt32                      m_unNextFrame;
+
+      /** Frames, queued for the encoders or free */
+      CDeepracerBufferQueue<SFrame> m_cFrames;
+      /** Raw video file descriptor, -1 if none */
+      int                         m_nRawFile;
+
+      std::atomic<UInt32>         m_unWritten;
+      std::atomic<UInt32>         m_unFailed;
+      UInt32                      m_unDropped;
+
+   };
+
+}
+
+#endif
@@ -0,0 +1,107 @@
+#include "qtopengl_deepracer_track.h"
+#include "deepracer_track_entity.h"
+#include <argos3/core/simulator/entity/embodied_entity.h>
+#include <argos3/plugins/simulator/visualizations/qt-opengl/qtopengl_widget.h>
+
+namespace argos {
+
+   /****************************************/
+   /****************************************/
+
+   static const GLfloat TRACK_WALL_COLOR[]        = { 0.8f, 0.8f, 0.8f, 1.0f };
+   static const GLfloat TRACK_CENTER_LINE_COLOR[] = { 1.0f, 1.0f, 0.0f, 1.0f };
+   static const GLfloat TRACK_SPECULAR[]          = { 0.0f, 0.0f, 0.0f, 1.0f };
+   static const GLfloat TRACK_SHININESS[]         = { 0.0f };
+   static const GLfloat TRACK_EMISSION[]          = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+   /* Height of the center line over the floor, to avoid z-fighting */
+   static const GLfloat TRACK_CENTER_LINE_ELEVATION = 0.001f;
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLDeepracerTrack::CQTOpenGLDeepracerTrack() {
+   }
+
+   /****************************************/
+   /****************************************/
+
+   CQTOpenGLDeepracerTrack::~CQTOpenGLDeepracerTrack() {
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLDeepracerTrack::Draw(CDeepracerTrackEntity& c_entity) {
+      glMaterialfv(GL_FRONT_AND_BACK, GL_SPECULAR, TRACK_SPECULAR);
+      glMaterialfv(GL_FRONT_AND_BACK, GL_SHININESS, TRACK_SHININESS);
+      glMaterialfv(GL_FRONT_AND_BACK, GL_EMISSION, TRACK_EMISSION);
+      DrawWalls(c_entity);
+      DrawCenterLine(c_entity);
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLDeepracerTrack::DrawWalls(CDeepracerTrackEntity& c_entity) {
+      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, TRACK_WALL_COLOR);
+      const CDeepracerSegmentBVH::TSegments& tWalls = c_entity.GetWalls().GetSegments();
+      GLfloat fHeight = c_entity.GetWallHeight();
+      /* One vertical quad per wall segment, the thickness is not drawn */
+      glBegin(GL_QUADS);
+      for(size_t i = 0; i < tWalls.size(); ++i) {
+         CVector2 cNormal = tWalls[i].End - tWalls[i].Start;
+         cNormal.Perpendicularize();
+         cNormal.Normalize();
+         glNormal3f(cNormal.GetX(), cNormal.GetY(), 0.0f);
+         glVertex3f(tWalls[i].Start.GetX(), tWalls[i].Start.GetY(), 0.0f);
+         glVertex3f(tWalls[i].End.GetX(),   tWalls[i].End.GetY(),   0.0f);
+         glVertex3f(tWalls[i].End.GetX(),   tWalls[i].End.GetY(),   fHeight);
+         glVertex3f(tWalls[i].Start.GetX(), tWalls[i].Start.GetY(), fHeight);
+      }
+      glEnd();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   void CQTOpenGLDeepracerTrack::DrawCenterLine(CDeepracerTrackEntity& c_entity) {
+      glMaterialfv(GL_FRONT_AND_BACK, GL_AMBIENT_AND_DIFFUSE, TRACK_CENTER_LINE_COLOR);
+      const CDeepracerTrack::TWaypoints& tCenterLine = c_entity.GetTrack().GetCenterLine();
+      glNormal3f(0.0f, 0.0f, 1.0f);
+      glBegin(c_entity.GetTrack().IsClosed() ? GL_LINE_LOOP : GL_LINE_STRIP);
+      for(size_t i = 0; i < tCenterLine.size(); ++i) {
+         glVertex3f(tCenterLine[i].GetX(), tCenterLine[i].GetY(), TRACK_CENTER_LINE_ELEVATION);
+      }
+      glEnd();
+   }
+
+   /****************************************/
+   /****************************************/
+
+   class CQTOpenGLOperationDrawDeepracerTrackNormal : public CQTOpenGLOperationDrawNormal {
+   public:
+      void ApplyTo(CQTOpenGLWidget& c_visualization,
+                   CDeepracerTrackEntity& c_entity) {
+         static CQTOpenGLDeepracerTrack m_cModel;
+         c_visualization.DrawEntity(c_entity.GetEmbodiedEntity());
+         m_cModel.Draw(c_entity);
+      }
+   };
+
+   class CQTOpenGLOperationDrawDeepracerTrackSelected : public CQTOpenGLOperationDrawSelected {
+   public:
+      void ApplyTo(CQTOpenGLWidget& c_visualization,
+                   CDeepracerTrackEntity& c_entity) {
+         c_visualization.DrawBoundingBox(c_entity.GetEmbodiedEntity());
+      }
+   };
+
+   REGISTER_QTOPENGL_ENTITY_OPERATION(CQTOpenGLOperationDrawNormal, CQTOpenGLOperationDrawDeepracerTrackNormal, CDeepracerTrackEntity);
+
+   REGISTER_QTOPENGL_ENTITY_OPERATION(CQTOpenGLOperationDrawSelected, CQTOpenGLOperationDrawDeepracerTrackSelected, CDeepracerTrackEntity);
+
+   /****************************************/
+   /****************************************/
+
+}
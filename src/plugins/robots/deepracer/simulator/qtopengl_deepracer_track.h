@@ -0,0 +1,37 @@
+#ifndef QTOPENGL_DEEPRACER_TRACK_H
+#define QTOPENGL_DEEPRACER_TRACK_H
+
+namespace argos {
+   class CQTOpenGLDeepracerTrack;
+   class CDeepracerTrackEntity;
+}
+
+#ifdef __APPLE__
+#include <gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+namespace argos {
+
+   class CQTOpenGLDeepracerTrack {
+
+   public:
+
+      CQTOpenGLDeepracerTrack();
+
+      virtual ~CQTOpenGLDeepracerTrack();
+
+      virtual void Draw(CDeepracerTrackEntity& c_entity);
+
+   private:
+
+      void DrawWalls(CDeepracerTrackEntity& c_entity);
+
+      void DrawCenterLine(CDeepracerTrackEntity& c_entity);
+
+   };
+
+}
+
+#endif